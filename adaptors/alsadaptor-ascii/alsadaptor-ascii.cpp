@@ -44,7 +44,7 @@
 #include <unistd.h>
 #include <string.h>
 
-ALSAdaptorAscii::ALSAdaptorAscii(const QString& id) : SysfsAdaptor(id, SysfsAdaptor::IntervalMode)
+ALSAdaptorAscii::ALSAdaptorAscii(const QString& id) : SysfsAdaptor(id, SysfsAdaptor::IntervalMode, false)
 {
     memset(buf, 0x0, 16);
     alsBuffer_ = new DeviceAdaptorRingBuffer<TimedUnsigned>(1);
@@ -78,8 +78,8 @@ ALSAdaptorAscii::~ALSAdaptorAscii()
 void ALSAdaptorAscii::processSample(int pathId, int fd) {
     Q_UNUSED(pathId);
 
-    if (read(fd, buf, sizeof(buf)) <= 0) {
-        qCWarning(lcSensorFw) << id() << "read():" << strerror(errno);
+    if (pread(fd, buf, sizeof(buf), 0) <= 0) {
+        qCWarning(lcSensorFw) << id() << "pread():" << strerror(errno);
         return;
     }
     buf[sizeof(buf)-1] = '\0';
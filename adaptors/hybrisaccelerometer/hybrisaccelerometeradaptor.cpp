@@ -25,7 +25,7 @@
 HybrisAccelerometerAdaptor::HybrisAccelerometerAdaptor(const QString& id)
     : HybrisAdaptor(id, SENSOR_TYPE_ACCELEROMETER)
 {
-    buffer = new DeviceAdaptorRingBuffer<AccelerationData>(1);
+    buffer = new DeviceAdaptorRingBuffer<AccelerationData>(maxEvents);
     setAdaptedSensor("accelerometer", "Internal accelerometer coordinates", buffer);
 
     setDescription("Hybris accelerometer");
@@ -59,20 +59,35 @@ void HybrisAccelerometerAdaptor::stopSensor()
 
 void HybrisAccelerometerAdaptor::processSample(const sensors_event_t& data)
 {
-    AccelerationData *d = buffer->nextSlot();
-    d->timestamp_ = quint64(data.timestamp * .001);
-    // sensorfw wants milli-G'
+    processSamples(&data, 1);
+}
 
+void HybrisAccelerometerAdaptor::processSamples(const sensors_event_t *data, int count)
+{
+    // Decode straight into the buffer and wake up readers once per
+    // buffer full so that they never fall behind
+    while (count > 0) {
+        unsigned chunk = qMin<unsigned>(count, buffer->size());
+        count -= chunk;
+        while (chunk > 0) {
+            unsigned granted;
+            AccelerationData *d = buffer->reserve(chunk, granted);
+            for (unsigned i = 0; i < granted; ++i, ++data) {
+                d[i].timestamp_ = quint64(data->timestamp * .001);
+                // sensorfw wants milli-G'
 #ifdef USE_BINDER
-    d->x_ = data.u.vec3.x * GRAVITY_RECIPROCAL_THOUSANDS;
-    d->y_ = data.u.vec3.y * GRAVITY_RECIPROCAL_THOUSANDS;
-    d->z_ = data.u.vec3.z * GRAVITY_RECIPROCAL_THOUSANDS;
+                d[i].x_ = data->u.vec3.x * GRAVITY_RECIPROCAL_THOUSANDS;
+                d[i].y_ = data->u.vec3.y * GRAVITY_RECIPROCAL_THOUSANDS;
+                d[i].z_ = data->u.vec3.z * GRAVITY_RECIPROCAL_THOUSANDS;
 #else
-    d->x_ = data.acceleration.x * GRAVITY_RECIPROCAL_THOUSANDS;
-    d->y_ = data.acceleration.y * GRAVITY_RECIPROCAL_THOUSANDS;
-    d->z_ = data.acceleration.z * GRAVITY_RECIPROCAL_THOUSANDS;
+                d[i].x_ = data->acceleration.x * GRAVITY_RECIPROCAL_THOUSANDS;
+                d[i].y_ = data->acceleration.y * GRAVITY_RECIPROCAL_THOUSANDS;
+                d[i].z_ = data->acceleration.z * GRAVITY_RECIPROCAL_THOUSANDS;
 #endif
-
-    buffer->commit();
-    buffer->wakeUpReaders();
+            }
+            buffer->commit(granted);
+            chunk -= granted;
+        }
+        buffer->wakeUpReaders();
+    }
 }
@@ -26,7 +26,7 @@
 HybrisGyroscopeAdaptor::HybrisGyroscopeAdaptor(const QString& id) :
     HybrisAdaptor(id,SENSOR_TYPE_GYROSCOPE)
 {
-    buffer = new DeviceAdaptorRingBuffer<TimedXyzData>(1);
+    buffer = new DeviceAdaptorRingBuffer<TimedXyzData>(maxEvents);
     setAdaptedSensor("gyroscopeadaptor", "Internal gyroscope coordinates", buffer);
 
     setDescription("Hybris gyroscope");
@@ -65,18 +65,34 @@ void HybrisGyroscopeAdaptor::stopSensor()
 
 void HybrisGyroscopeAdaptor::processSample(const sensors_event_t& data)
 {
+    processSamples(&data, 1);
+}
 
-    TimedXyzData *d = buffer->nextSlot();
-    d->timestamp_ = quint64(data.timestamp * .001);
+void HybrisGyroscopeAdaptor::processSamples(const sensors_event_t *data, int count)
+{
+    // Decode straight into the buffer and wake up readers once per
+    // buffer full so that they never fall behind
+    while (count > 0) {
+        unsigned chunk = qMin<unsigned>(count, buffer->size());
+        count -= chunk;
+        while (chunk > 0) {
+            unsigned granted;
+            TimedXyzData *d = buffer->reserve(chunk, granted);
+            for (unsigned i = 0; i < granted; ++i, ++data) {
+                d[i].timestamp_ = quint64(data->timestamp * .001);
 #ifdef USE_BINDER
-    d->x_ = (data.u.vec3.x) * RADIANS_TO_DEGREES * 1000;
-    d->y_ = (data.u.vec3.y) * RADIANS_TO_DEGREES * 1000;
-    d->z_ = (data.u.vec3.z) * RADIANS_TO_DEGREES * 1000;
+                d[i].x_ = (data->u.vec3.x) * RADIANS_TO_DEGREES * 1000;
+                d[i].y_ = (data->u.vec3.y) * RADIANS_TO_DEGREES * 1000;
+                d[i].z_ = (data->u.vec3.z) * RADIANS_TO_DEGREES * 1000;
 #else
-    d->x_ = (data.gyro.x) * RADIANS_TO_DEGREES * 1000;
-    d->y_ = (data.gyro.y) * RADIANS_TO_DEGREES * 1000;
-    d->z_ = (data.gyro.z) * RADIANS_TO_DEGREES * 1000;
+                d[i].x_ = (data->gyro.x) * RADIANS_TO_DEGREES * 1000;
+                d[i].y_ = (data->gyro.y) * RADIANS_TO_DEGREES * 1000;
+                d[i].z_ = (data->gyro.z) * RADIANS_TO_DEGREES * 1000;
 #endif
-    buffer->commit();
-    buffer->wakeUpReaders();
+            }
+            buffer->commit(granted);
+            chunk -= granted;
+        }
+        buffer->wakeUpReaders();
+    }
 }
@@ -51,6 +51,7 @@ public:
 
 protected:
     void processSample(const sensors_event_t& data);
+    void processSamples(const sensors_event_t *data, int count);
 
 private:
     DeviceAdaptorRingBuffer<TimedXyzData>* buffer;
@@ -25,7 +25,7 @@
 HybrisMagnetometerAdaptor::HybrisMagnetometerAdaptor(const QString& id) :
     HybrisAdaptor(id,SENSOR_TYPE_MAGNETIC_FIELD)
 {
-    buffer = new DeviceAdaptorRingBuffer<CalibratedMagneticFieldData>(1);
+    buffer = new DeviceAdaptorRingBuffer<CalibratedMagneticFieldData>(maxEvents);
     setAdaptedSensor("magnetometer", "Internal magnetometer coordinates", buffer);
 
     setDescription("Hybris magnetometer");
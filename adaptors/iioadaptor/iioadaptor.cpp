@@ -36,6 +36,8 @@
 #include <datatypes/utils.h>
 #include <unistd.h>
 #include <time.h>
+#include <stdio.h>
+#include <algorithm>
 
 #include "iioadaptor.h"
 #include <sysfsadaptor.h>
@@ -64,7 +66,11 @@
 #define CONVERT_A_Z(x)  ((float(x) / 1000) * (GRAVITY * 1.0))
 
 IioAdaptor::IioAdaptor(const QString &id) :
-        SysfsAdaptor(id, SysfsAdaptor::IntervalMode, true),
+        SysfsAdaptor(id, SysfsAdaptor::IntervalMode, false),
+        buffered_(false),
+        hwTimestamps_(false),
+        scanRecordSize_(0),
+        scanInterval_us_(0),
         deviceId(id)
 {
     qCInfo(lcSensorFw) << "Creating IioAdaptor with id:" << NodeBase::id();
@@ -97,7 +103,7 @@ void IioAdaptor::setup()
         if (devNodeNumber!= -1) {
             const QString desc = "Industrial I/O accelerometer (" + iioDevice.name +")";
             qDebug() << id() << Q_FUNC_INFO << "Accelerometer found";
-            iioXyzBuffer_ = new DeviceAdaptorRingBuffer<TimedXyzData>(1);
+            iioXyzBuffer_ = new DeviceAdaptorRingBuffer<TimedXyzData>(buffered_ ? IIO_SCAN_BATCH : 1);
             setAdaptedSensor(name, desc, iioXyzBuffer_);
 
             iioDevice.sensorType = IioAdaptor::IIO_ACCELEROMETER;
@@ -111,7 +117,7 @@ void IioAdaptor::setup()
         devNodeNumber = findSensor(inputMatch);
         if (devNodeNumber!= -1) {
             const QString desc = "Industrial I/O gyroscope (" + iioDevice.name +")";
-            iioXyzBuffer_ = new DeviceAdaptorRingBuffer<TimedXyzData>(1);
+            iioXyzBuffer_ = new DeviceAdaptorRingBuffer<TimedXyzData>(buffered_ ? IIO_SCAN_BATCH : 1);
             setAdaptedSensor(name, desc, iioXyzBuffer_);
 
             iioDevice.sensorType = IioAdaptor::IIO_GYROSCOPE;
@@ -125,7 +131,7 @@ void IioAdaptor::setup()
         devNodeNumber = findSensor(inputMatch);
         if (devNodeNumber!= -1) {
             const QString desc = "Industrial I/O magnetometer (" + iioDevice.name +")";
-            magnetometerBuffer_ = new DeviceAdaptorRingBuffer<CalibratedMagneticFieldData>(1);
+            magnetometerBuffer_ = new DeviceAdaptorRingBuffer<CalibratedMagneticFieldData>(buffered_ ? IIO_SCAN_BATCH : 1);
             setAdaptedSensor(name, desc, magnetometerBuffer_);
 
             iioDevice.sensorType = IioAdaptor::IIO_MAGNETOMETER;
@@ -139,7 +145,7 @@ void IioAdaptor::setup()
         if (devNodeNumber!= -1) {
             QString desc = "Industrial I/O light sensor (" + iioDevice.name +")";
             qDebug() << id() << desc;
-            alsBuffer_ = new DeviceAdaptorRingBuffer<TimedUnsigned>(1);
+            alsBuffer_ = new DeviceAdaptorRingBuffer<TimedUnsigned>(buffered_ ? IIO_SCAN_BATCH : 1);
             setAdaptedSensor(name, desc, alsBuffer_);
             iioDevice.sensorType = IioAdaptor::IIO_ALS;
         }
@@ -154,7 +160,7 @@ void IioAdaptor::setup()
         if (devNodeNumber!= -1) {
             QString desc = "Industrial I/O proximity sensor (" + iioDevice.name +")";
             qDebug() << id() << desc;
-            proximityBuffer_ = new DeviceAdaptorRingBuffer<ProximityData>(1);
+            proximityBuffer_ = new DeviceAdaptorRingBuffer<ProximityData>(buffered_ ? IIO_SCAN_BATCH : 1);
             setAdaptedSensor(name, desc, proximityBuffer_);
             iioDevice.sensorType = IioAdaptor::IIO_PROXIMITY;
         }
@@ -171,6 +177,20 @@ void IioAdaptor::setup()
         scanElementsEnable(devNodeNumber,0);
     }
 
+    if (buffered_ && !setupBuffer()) {
+        qCWarning(lcSensorFw) << id() << "IIO buffer not usable, polling channels instead";
+        buffered_ = false;
+    }
+    if (buffered_) {
+        qCInfo(lcSensorFw) << id() << "Reading" << scanRecordSize_ << "byte scan records from" << iioDevice.devNode;
+        setMode(SysfsAdaptor::SelectMode);
+        setSeek(false);
+        addPath(iioDevice.devNode, 0);
+    } else {
+        for (int i = 0; i < iioDevice.rawPaths.size(); ++i)
+            addPath(iioDevice.rawPaths.at(i), i);
+    }
+
     /* Override the scaling factor if asked */
     bool ok;
     double scale_override = SensorFrameworkConfig::configuration()->value(iioDevice.name + "/scale").toDouble(&ok);
@@ -221,6 +241,9 @@ int IioAdaptor::findSensor(const QString &sensorName)
                 QString eventName = QString::fromLatin1(udev_device_get_sysname(dev));
                 iioDevice.devicePath = QString::fromLatin1(udev_device_get_syspath(dev)) +"/";
                 iioDevice.index = eventName.right(1).toInt(&ok2);
+                iioDevice.devNode = "/dev/" + eventName;
+                iioDevice.rawPaths.clear();
+                buffered_ = SensorFrameworkConfig::configuration()->value<bool>(iioDevice.name + "/buffered", false);
                 // Default values
                 iioDevice.offset = 0.0;
                 iioDevice.scale = 1.0;
@@ -256,7 +279,7 @@ int IioAdaptor::findSensor(const QString &sensorName)
                     } else if (attributeName.contains(QRegularExpression(iioDevice.channelTypeName + ".*raw$"))) {
                         qDebug() << id() << "adding to paths:" << iioDevice.devicePath
                                    << attributeName << iioDevice.index;
-                        addPath(iioDevice.devicePath + attributeName, j);
+                        iioDevice.rawPaths.append(iioDevice.devicePath + attributeName);
                         j++;
                     }
                 }
@@ -305,7 +328,22 @@ bool IioAdaptor::deviceEnable(int device, int enable)
 
     qDebug() << id() << pathEnable << pathLength;
 
-    if (enable == 1) {
+    if (buffered_) {
+        // Scan elements can't be changed while the buffer is enabled
+        if (!enable) {
+            sysfsWriteInt(pathEnable, enable);
+        } else {
+            // Elements left enabled by others would change the record layout
+            foreach (const QString &path, unusedScanElements_)
+                sysfsWriteInt(path, 0);
+        }
+        for (int i = 0; i < scanChannels_.size(); ++i)
+            sysfsWriteInt(scanChannels_.at(i).enablePath, enable);
+        if (enable) {
+            sysfsWriteInt(pathLength, IIO_BUFFER_LEN);
+            sysfsWriteInt(pathEnable, enable);
+        }
+    } else if (enable == 1) {
         // FIXME: should enable sensors for this device? Assuming enabled already
         scanElementsEnable(device, enable);
         sysfsWriteInt(pathLength, IIO_BUFFER_LEN);
@@ -432,11 +470,16 @@ void IioAdaptor::processSample(int fileId, int fd)
     int channel = fileId%IIO_MAX_DEVICE_CHANNELS;
     int device = (fileId - channel)/IIO_MAX_DEVICE_CHANNELS;
 
+    if (buffered_) {
+        processScanRecords(fd);
+        return;
+    }
+
     if (device == 0) {
-        readBytes = read(fd, buf, sizeof(buf));
+        readBytes = pread(fd, buf, sizeof(buf), 0);
 
         if (readBytes <= 0) {
-            qCWarning(lcSensorFw) << id() << "read():" << strerror(errno);
+            qCWarning(lcSensorFw) << id() << "pread():" << strerror(errno);
             return;
         }
 
@@ -449,108 +492,336 @@ void IioAdaptor::processSample(int fileId, int fd)
             return;
         }
 
-        switch(channel) {
-        case 0: {
-            switch (iioDevice.sensorType) {
-            case IioAdaptor::IIO_ACCELEROMETER:
-            case IioAdaptor::IIO_GYROSCOPE:
-                timedData = iioXyzBuffer_->nextSlot();
-                timedData->x_= -(result + iioDevice.offset) * iioDevice.scale * 1000 * REV_GRAVITY;
-                break;
-            case IioAdaptor::IIO_MAGNETOMETER:
-                calData = magnetometerBuffer_->nextSlot();
-                calData->rx_ = (result + iioDevice.offset) * iioDevice.scale;
-                break;
-            case IioAdaptor::IIO_ALS:
-                uData = alsBuffer_->nextSlot();
-                uData->value_ = (result + iioDevice.offset) * iioDevice.scale;
-                break;
-            case IioAdaptor::IIO_PROXIMITY:
-                {
-                    bool near = false;
-                    int proximityValue = (result + iioDevice.offset) * iioDevice.scale;
-                    proximityData = proximityBuffer_->nextSlot();
-                    // IIO proximity sensors are inverted in comparison to Hybris proximity sensors
-                    if (proximityValue >= proximityThreshold) {
-                        near = true;
-                    }
-                    proximityData->withinProximity_ = near;
-                    proximityData->value_ = near ? PROXIMITY_NEAR_VALUE : PROXIMITY_FAR_VALUE;
+        processChannel(channel, result);
+
+        if (channel == iioDevice.channels - 1)
+            commitSample(Utils::getTimeStamp());
+    }
+}
+
+void IioAdaptor::processChannel(int channel, qreal result)
+{
+    switch(channel) {
+    case 0: {
+        switch (iioDevice.sensorType) {
+        case IioAdaptor::IIO_ACCELEROMETER:
+        case IioAdaptor::IIO_GYROSCOPE:
+            timedData = iioXyzBuffer_->nextSlot();
+            timedData->x_= -(result + iioDevice.offset) * iioDevice.scale * 1000 * REV_GRAVITY;
+            break;
+        case IioAdaptor::IIO_MAGNETOMETER:
+            calData = magnetometerBuffer_->nextSlot();
+            calData->rx_ = (result + iioDevice.offset) * iioDevice.scale;
+            break;
+        case IioAdaptor::IIO_ALS:
+            uData = alsBuffer_->nextSlot();
+            uData->value_ = (result + iioDevice.offset) * iioDevice.scale;
+            break;
+        case IioAdaptor::IIO_PROXIMITY:
+            {
+                bool near = false;
+                int proximityValue = (result + iioDevice.offset) * iioDevice.scale;
+                proximityData = proximityBuffer_->nextSlot();
+                // IIO proximity sensors are inverted in comparison to Hybris proximity sensors
+                if (proximityValue >= proximityThreshold) {
+                    near = true;
                 }
-                break;
-            default:
-                break;
-            };
-        }
+                proximityData->withinProximity_ = near;
+                proximityData->value_ = near ? PROXIMITY_NEAR_VALUE : PROXIMITY_FAR_VALUE;
+            }
+            break;
+        default:
+            break;
+        };
+    }
+        break;
+
+    case 1: {
+        switch (iioDevice.sensorType) {
+        case IioAdaptor::IIO_ACCELEROMETER:
+        case IioAdaptor::IIO_GYROSCOPE:
+            timedData = iioXyzBuffer_->nextSlot();
+            timedData->y_= -(result + iioDevice.offset) * iioDevice.scale * 1000 * REV_GRAVITY;
+            break;
+        case IioAdaptor::IIO_MAGNETOMETER:
+            calData = magnetometerBuffer_->nextSlot();
+            result = (result * iioDevice.scale);
+            calData->y_ = result;
+            break;
+        default:
+            break;
+        };
+    }
+        break;
+
+    case 2: {
+        switch (iioDevice.sensorType) {
+        case IioAdaptor::IIO_ACCELEROMETER:
+        case IioAdaptor::IIO_GYROSCOPE:
+            timedData = iioXyzBuffer_->nextSlot();
+            timedData->z_ = -(result + iioDevice.offset) * iioDevice.scale * 1000 * REV_GRAVITY;
+            break;
+        case IioAdaptor::IIO_MAGNETOMETER:
+            calData = magnetometerBuffer_->nextSlot();
+            result = ((result + iioDevice.offset) * iioDevice.scale) * 100;
+            calData->rz_ = result;
+            break;
+        default:
             break;
+        };
+    }
+        break;
+    };
+}
 
-        case 1: {
-            switch (iioDevice.sensorType) {
-            case IioAdaptor::IIO_ACCELEROMETER:
-            case IioAdaptor::IIO_GYROSCOPE:
-                timedData = iioXyzBuffer_->nextSlot();
-                timedData->y_= -(result + iioDevice.offset) * iioDevice.scale * 1000 * REV_GRAVITY;
-                break;
-            case IioAdaptor::IIO_MAGNETOMETER:
-                calData = magnetometerBuffer_->nextSlot();
-                result = (result * iioDevice.scale);
-                calData->y_ = result;
-                break;
-            default:
-                break;
-            };
+void IioAdaptor::commitSample(quint64 timestamp)
+{
+    switch (iioDevice.sensorType) {
+    case IioAdaptor::IIO_ACCELEROMETER:
+    case IioAdaptor::IIO_GYROSCOPE:
+        timedData->timestamp_ = timestamp;
+        iioXyzBuffer_->commit();
+        iioXyzBuffer_->wakeUpReaders();
+        break;
+    case IioAdaptor::IIO_MAGNETOMETER:
+        calData->timestamp_ = timestamp;
+        magnetometerBuffer_->commit();
+        magnetometerBuffer_->wakeUpReaders();
+        break;
+    case IioAdaptor::IIO_ALS:
+        uData->timestamp_ = timestamp;
+        alsBuffer_->commit();
+        alsBuffer_->wakeUpReaders();
+        qCDebug(lcSensorFw) << id() << "ALS offset=" << iioDevice.offset << "scale=" << iioDevice.scale << "value=" << uData->value_ << "timestamp=" << uData->timestamp_;
+        break;
+    case IioAdaptor::IIO_PROXIMITY:
+        proximityData->timestamp_ = timestamp;
+        proximityBuffer_->commit();
+        proximityBuffer_->wakeUpReaders();
+        qCDebug(lcSensorFw) << id() << "Proximity offset=" << iioDevice.offset << "scale=" << iioDevice.scale << "value=" << proximityData->value_ << "within proximity=" << proximityData->withinProximity_ << "timestamp=" << proximityData->timestamp_;
+        break;
+    default:
+        break;
+    };
+}
+
+RingBufferBase *IioAdaptor::ringBuffer() const
+{
+    switch (iioDevice.sensorType) {
+    case IioAdaptor::IIO_ACCELEROMETER:
+    case IioAdaptor::IIO_GYROSCOPE:
+        return iioXyzBuffer_;
+    case IioAdaptor::IIO_MAGNETOMETER:
+        return magnetometerBuffer_;
+    case IioAdaptor::IIO_ALS:
+        return alsBuffer_;
+    case IioAdaptor::IIO_PROXIMITY:
+        return proximityBuffer_;
+    default:
+        return nullptr;
+    };
+}
+
+bool IioAdaptor::scanChannelBefore(const iio_scan_channel &a, const iio_scan_channel &b)
+{
+    return a.index < b.index;
+}
+
+bool IioAdaptor::setupBuffer()
+{
+    QDir dir(iioDevice.devicePath + "scan_elements");
+    if (!dir.exists()) {
+        qCWarning(lcSensorFw) << id() << "Directory" << dir.path() << "doesn't exist";
+        return false;
+    }
+    if (!QFile::exists(iioDevice.devNode)) {
+        qCWarning(lcSensorFw) << id() << "IIO buffer device" << iioDevice.devNode << "doesn't exist";
+        return false;
+    }
+
+    QStringList filters;
+    filters << ("in_" + iioDevice.channelTypeName + "*_en") << "in_timestamp_en";
+    dir.setNameFilters(filters);
+
+    scanChannels_.clear();
+    bool hasTimestamp = false;
+    foreach (const QFileInfo &fileInfo, dir.entryInfoList(QDir::Files)) {
+        QString base = fileInfo.filePath();
+        // Remove the _en
+        base.chop(3);
+
+        iio_scan_channel channel;
+        if (!parseScanElement(base, channel))
+            return false;
+        channel.enablePath = fileInfo.filePath();
+        if (channel.axis < 0) {
+            hasTimestamp = true;
+        } else if (channel.axis >= 3) {
+            continue;
         }
-            break;
+        scanChannels_.append(channel);
+    }
+    if (scanChannels_.size() == (hasTimestamp ? 1 : 0)) {
+        qCWarning(lcSensorFw) << id() << "No" << iioDevice.channelTypeName << "scan elements found";
+        return false;
+    }
 
-        case 2: {
-            switch (iioDevice.sensorType) {
-            case IioAdaptor::IIO_ACCELEROMETER:
-            case IioAdaptor::IIO_GYROSCOPE:
-                timedData = iioXyzBuffer_->nextSlot();
-                timedData->z_ = -(result + iioDevice.offset) * iioDevice.scale * 1000 * REV_GRAVITY;
-                break;
-            case IioAdaptor::IIO_MAGNETOMETER:
-                calData = magnetometerBuffer_->nextSlot();
-                result = ((result + iioDevice.offset) * iioDevice.scale) * 100;
-                calData->rz_ = result;
+    /* Timestamps are in CLOCK_REALTIME unless told otherwise */
+    QString clockPath = iioDevice.devicePath + "current_timestamp_clock";
+    hwTimestamps_ = hasTimestamp && QFile::exists(clockPath)
+        && writeToFile(clockPath.toLocal8Bit(), "monotonic\n");
+    if (hasTimestamp && !hwTimestamps_) {
+        qCInfo(lcSensorFw) << id() << "Monotonic IIO timestamps not available, timestamping on read";
+        for (int i = 0; i < scanChannels_.size(); ++i) {
+            if (scanChannels_.at(i).axis < 0) {
+                scanChannels_.remove(i);
                 break;
-            default:
-                break;
-            };
+            }
         }
-            break;
-        };
+    }
 
-        if (channel == iioDevice.channels - 1) {
-            switch (iioDevice.sensorType) {
-            case IioAdaptor::IIO_ACCELEROMETER:
-            case IioAdaptor::IIO_GYROSCOPE:
-                timedData->timestamp_ = Utils::getTimeStamp();
-                iioXyzBuffer_->commit();
-                iioXyzBuffer_->wakeUpReaders();
-                break;
-            case IioAdaptor::IIO_MAGNETOMETER:
-                calData->timestamp_ = Utils::getTimeStamp();
-                magnetometerBuffer_->commit();
-                magnetometerBuffer_->wakeUpReaders();
-                break;
-            case IioAdaptor::IIO_ALS:
-                uData->timestamp_ = Utils::getTimeStamp();
-                alsBuffer_->commit();
-                alsBuffer_->wakeUpReaders();
-                qCDebug(lcSensorFw) << id() << "ALS offset=" << iioDevice.offset << "scale=" << iioDevice.scale << "value=" << uData->value_ << "timestamp=" << uData->timestamp_;
-                break;
-            case IioAdaptor::IIO_PROXIMITY:
-                proximityData->timestamp_ = Utils::getTimeStamp();
-                proximityBuffer_->commit();
-                proximityBuffer_->wakeUpReaders();
-                qCDebug(lcSensorFw) << id() << "Proximity offset=" << iioDevice.offset << "scale=" << iioDevice.scale << "value=" << proximityData->value_ << "within proximity=" << proximityData->withinProximity_ << "timestamp=" << proximityData->timestamp_;
-                break;
-            default:
-                break;
-            };
+    /* Any other enabled element would be in the records too, including
+     * axes beyond z and the timestamp when it is not used */
+    unusedScanElements_.clear();
+    dir.setNameFilters(QStringList() << "*_en");
+    foreach (const QFileInfo &fileInfo, dir.entryInfoList(QDir::Files)) {
+        bool used = false;
+        for (int i = 0; !used && i < scanChannels_.size(); ++i)
+            used = (scanChannels_.at(i).enablePath == fileInfo.filePath());
+        if (!used)
+            unusedScanElements_.append(fileInfo.filePath());
+    }
+
+    scanRecordSize_ = layoutScanRecord(scanChannels_);
+    scanBuffer_.resize(scanRecordSize_ * IIO_SCAN_BATCH);
+
+    /* Devices with triggered buffers need a trigger. Unless configured,
+     * use the one the device provides itself, named by convention. */
+    QString triggerPath = iioDevice.devicePath + "trigger/current_trigger";
+    if (QFile::exists(triggerPath)) {
+        QString trigger = SensorFrameworkConfig::configuration()->value<QString>(iioDevice.name + "/trigger");
+        if (trigger.isEmpty() && sysfsReadString(triggerPath).isEmpty())
+            trigger = QString("%1-dev%2").arg(iioDevice.name).arg(iioDevice.index);
+        if (!trigger.isEmpty() && !writeToFile(triggerPath.toLocal8Bit(), trigger.toLocal8Bit() + "\n"))
+            qCWarning(lcSensorFw) << id() << "Failed to set trigger" << trigger;
+    }
+
+    return true;
+}
+
+bool IioAdaptor::parseScanElement(const QString &base, iio_scan_channel &channel)
+{
+    QString type = sysfsReadString(base + "_type");
+    if (!parseScanType(type.toLatin1(), channel)) {
+        qCWarning(lcSensorFw) << id() << "Unsupported scan element type" << type << "in" << base;
+        return false;
+    }
+
+    QString name = base.mid(base.lastIndexOf('/') + 1);
+    if (name == "in_timestamp")
+        channel.axis = -1;
+    else if (name.endsWith("_x"))
+        channel.axis = 0;
+    else if (name.endsWith("_y"))
+        channel.axis = 1;
+    else if (name.endsWith("_z"))
+        channel.axis = 2;
+    else if (name == "in_" + iioDevice.channelTypeName)
+        channel.axis = 0;
+    else
+        channel.axis = 3;
+
+    channel.index = sysfsReadInt(base + "_index");
+    return true;
+}
+
+bool IioAdaptor::parseScanType(const QByteArray &type, iio_scan_channel &channel)
+{
+    char endian = 0;
+    char sign = 0;
+    unsigned int bits = 0;
+    unsigned int storage = 0;
+    unsigned int shift = 0;
+
+    if (sscanf(type.constData(), "%ce:%c%u/%u>>%u", &endian, &sign, &bits, &storage, &shift) != 5
+        || (endian != 'l' && endian != 'b') || (sign != 's' && sign != 'u')
+        || (storage != 8 && storage != 16 && storage != 32 && storage != 64)
+        || bits == 0 || bits > storage || shift >= storage)
+        return false;
+
+    channel.offset = 0;
+    channel.storageBytes = storage / 8;
+    channel.realBits = bits;
+    channel.shift = shift;
+    channel.isSigned = (sign == 's');
+    channel.bigEndian = (endian == 'b');
+    return true;
+}
+
+int IioAdaptor::layoutScanRecord(QVector<iio_scan_channel> &channels)
+{
+    std::sort(channels.begin(), channels.end(), scanChannelBefore);
+    int offset = 0;
+    int alignment = 1;
+    for (int i = 0; i < channels.size(); ++i) {
+        iio_scan_channel &channel = channels[i];
+        if (offset % channel.storageBytes)
+            offset += channel.storageBytes - offset % channel.storageBytes;
+        channel.offset = offset;
+        offset += channel.storageBytes;
+        alignment = qMax(alignment, channel.storageBytes);
+    }
+    if (offset % alignment)
+        offset += alignment - offset % alignment;
+    return offset;
+}
+
+qint64 IioAdaptor::decodeScanValue(const char *record, const iio_scan_channel &channel)
+{
+    const uchar *bytes = reinterpret_cast<const uchar *>(record + channel.offset);
+    quint64 value = 0;
+    for (int i = 0; i < channel.storageBytes; ++i)
+        value = (value << 8) | bytes[channel.bigEndian ? i : channel.storageBytes - 1 - i];
+
+    value >>= channel.shift;
+    if (channel.realBits < 64) {
+        const quint64 mask = (Q_UINT64_C(1) << channel.realBits) - 1;
+        value &= mask;
+        if (channel.isSigned && (value >> (channel.realBits - 1)))
+            value |= ~mask;
+    }
+    return qint64(value);
+}
+
+void IioAdaptor::processScanRecords(int fd)
+{
+    RingBufferBase *buffer = ringBuffer();
+    if (!buffer)
+        return;
+
+    // The driver hands out whole scan records only
+    ssize_t bytes = read(fd, scanBuffer_.data(), scanBuffer_.size());
+    if (bytes < 0) {
+        if (errno != EAGAIN)
+            qCWarning(lcSensorFw) << id() << "read():" << strerror(errno);
+        return;
+    }
+
+    buffer->beginBatch();
+    const char *record = scanBuffer_.constData();
+    for (int records = bytes / scanRecordSize_; records > 0; --records, record += scanRecordSize_) {
+        quint64 timestamp = 0;
+        for (int i = 0; i < scanChannels_.size(); ++i) {
+            const iio_scan_channel &channel = scanChannels_.at(i);
+            qint64 value = decodeScanValue(record, channel);
+            if (channel.axis < 0)
+                timestamp = value > 0 ? quint64(value) / 1000 : 0;
+            else
+                processChannel(channel.axis, value);
         }
+        commitSample(timestamp ? timestamp : Utils::getTimeStamp());
     }
+    buffer->endBatch();
 }
 
 bool IioAdaptor::setInterval(const int sessionId, const unsigned int interval_us)
@@ -558,17 +829,29 @@ bool IioAdaptor::setInterval(const int sessionId, const unsigned int interval_us
     if (mode() == SysfsAdaptor::IntervalMode)
         return SysfsAdaptor::setInterval(sessionId, interval_us);
 
+    if (buffered_) {
+        // The driver paces the buffer, ask it for the matching rate
+        scanInterval_us_ = interval_us;
+        QString frequencyPath = iioDevice.devicePath + "sampling_frequency";
+        if (interval_us > 0 && QFile::exists(frequencyPath)) {
+            QByteArray frequency = QByteArray::number(1000000.0 / interval_us, 'f', 3);
+            if (!writeToFile(frequencyPath.toLocal8Bit(), frequency + "\n"))
+                qCWarning(lcSensorFw) << id() << "Failed to set sampling frequency" << frequency;
+        }
+        return true;
+    }
+
     qCInfo(lcSensorFw) << id() << "Ignoring setInterval for " << interval_us;
 
     return true;
 }
 
-//unsigned int IioAdaptor::interval() const
-//{
-//    int interval_us = 100 * 1000;
-//    qCInfo(lcSensorFw) << id() << "Returning dummy value in interval(): " << interval_us;
-//    return interval_us;
-//}
+unsigned int IioAdaptor::interval() const
+{
+    if (buffered_)
+        return scanInterval_us_;
+    return SysfsAdaptor::interval();
+}
 
 
 bool IioAdaptor::startSensor()
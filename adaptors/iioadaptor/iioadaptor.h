@@ -29,6 +29,8 @@
 
 #include <sysfsadaptor.h>
 #include <datatypes/orientationdata.h>
+#include <QVector>
+#include <QByteArray>
 
 // FIXME: shouldn't assume any number of channels per device
 #define IIO_MAX_DEVICE_CHANNELS     20
@@ -36,6 +38,9 @@
 // FIXME: no idea what would be reasonable length
 #define IIO_BUFFER_LEN              256
 
+// Largest number of scan records decoded from the IIO buffer at a time
+#define IIO_SCAN_BATCH              64
+
 /**
  * @brief Adaptor for Industrial I/O.
  *
@@ -45,6 +50,13 @@
  * Driver interface is located in @e /sys/bus/iio/devices/iio:deviceX/ .
  * <ul><li>@e angular_rate filehandle provides measurement values.</li></ul>
  * No other filehandles are currently in use by this adaptor.
+ *
+ * With @e buffered set in the configuration group named after the IIO
+ * device, the adaptor uses the IIO buffer instead. Scan elements of the
+ * channels and the timestamp are enabled, a trigger is attached, and
+ * binary scan records are read from @e /dev/iio:deviceX whenever the
+ * driver has pushed data, using the hardware timestamps if the device
+ * can report them in the monotonic clock.
  */
 class IioAdaptor : public SysfsAdaptor
 {
@@ -70,6 +82,8 @@ class IioAdaptor : public SysfsAdaptor
       int index;
       IioSensorType sensorType;
       QString channelTypeName;
+      QStringList rawPaths;
+      QString devNode;
     };
 
 public:
@@ -89,6 +103,49 @@ public:
 //    virtual bool standby();
 //    virtual bool resume();
 
+    /**
+     * Layout of an element in IIO scan records.
+     */
+    struct iio_scan_channel {
+      QString enablePath;
+      int axis;           // 0 - 2 for x, y and z, -1 for timestamp
+      int index;          // order of the element in scan records
+      int offset;         // byte offset in scan record
+      int storageBytes;
+      int realBits;
+      int shift;
+      bool isSigned;
+      bool bigEndian;
+    };
+
+    /**
+     * Parse the format of a scan element, e.g. "le:s12/16>>4".
+     *
+     * @param type Content of the _type file of the scan element.
+     * @param channel Channel to fill in the format of.
+     * @return was the format valid and supported.
+     */
+    static bool parseScanType(const QByteArray &type, iio_scan_channel &channel);
+
+    /**
+     * Sort channels to record order and place them in the records.
+     * Elements are aligned to their storage size, and records to the
+     * size of the largest element.
+     *
+     * @param channels Enabled channels to set the offsets of.
+     * @return size of a scan record.
+     */
+    static int layoutScanRecord(QVector<iio_scan_channel> &channels);
+
+    /**
+     * Extract value of a channel from a scan record.
+     *
+     * @param record Scan record.
+     * @param channel Layout of the channel.
+     * @return value of the channel.
+     */
+    static qint64 decodeScanValue(const char *record, const iio_scan_channel &channel);
+
 protected:
 
     /**
@@ -105,7 +162,7 @@ protected:
 
 
     bool setInterval(const int sessionId, const unsigned int interval_us);
-    //  unsigned int interval() const;
+    unsigned int interval() const;
 
 private:
 
@@ -119,6 +176,51 @@ private:
      */
     void processSample(int pathId, int fd);
 
+    /**
+     * Store value of a single channel to the sample being built.
+     *
+     * @param channel Channel number, 0 - 2 for x, y and z.
+     * @param result Raw value of the channel.
+     */
+    void processChannel(int channel, qreal result);
+
+    /**
+     * Publish the sample built with processChannel().
+     *
+     * @param timestamp Timestamp of the sample.
+     */
+    void commitSample(quint64 timestamp);
+
+    /**
+     * Ring buffer the adaptor writes to.
+     */
+    RingBufferBase *ringBuffer() const;
+
+    /**
+     * Prepare reading scan records from the IIO buffer.
+     *
+     * @return was the buffer found usable.
+     */
+    bool setupBuffer();
+
+    /**
+     * Parse scan element description.
+     *
+     * @param base Path of the scan element without the suffix.
+     * @param channel Channel to fill in.
+     * @return was the description valid.
+     */
+    bool parseScanElement(const QString &base, iio_scan_channel &channel);
+
+    /**
+     * Read and decode available scan records from the IIO buffer.
+     *
+     * @param fd Open IIO character device.
+     */
+    void processScanRecords(int fd);
+
+    static bool scanChannelBefore(const iio_scan_channel &a, const iio_scan_channel &b);
+
     int findSensor(const QString &name);
     bool deviceEnable(int device, int enable);
 
@@ -133,6 +235,18 @@ private:
 
     int proximityThreshold;
 
+    // Buffered mode: scan records are read from the IIO character device
+    bool buffered_;
+    // Scan records carry timestamps in the monotonic clock
+    bool hwTimestamps_;
+    // Enabled scan elements in record order
+    QVector<iio_scan_channel> scanChannels_;
+    // Other scan elements, disabled to keep them out of the records
+    QStringList unusedScanElements_;
+    int scanRecordSize_;
+    QByteArray scanBuffer_;
+    unsigned int scanInterval_us_;
+
     DeviceAdaptorRingBuffer<TimedXyzData>* iioXyzBuffer_;
     DeviceAdaptorRingBuffer<TimedUnsigned>* alsBuffer_;
     DeviceAdaptorRingBuffer<CalibratedMagneticFieldData>* magnetometerBuffer_;
@@ -40,7 +40,7 @@
 #include <unistd.h>
 
 MagnetometerAdaptorAscii::MagnetometerAdaptorAscii(const QString& id) :
-    SysfsAdaptor(id, SysfsAdaptor::IntervalMode)
+    SysfsAdaptor(id, SysfsAdaptor::IntervalMode, false)
 {
     memset(buf, 0x0, 32);
     magnetBuffer_ = new DeviceAdaptorRingBuffer<CalibratedMagneticFieldData>(1);
@@ -56,9 +56,8 @@ void MagnetometerAdaptorAscii::processSample(int, int fd)
 {
     unsigned short x, y, z;
 
-    lseek(fd, 0, SEEK_SET);
-    if (read(fd, buf, sizeof(buf)) <= 0) {
-        qCWarning(lcSensorFw) << id() << "read(): " << strerror(errno);
+    if (pread(fd, buf, sizeof(buf), 0) <= 0) {
+        qCWarning(lcSensorFw) << id() << "pread(): " << strerror(errno);
         return;
     }
     qCDebug(lcSensorFw) << id() << "Magnetometer output value: " << buf;
@@ -40,7 +40,7 @@
 #include <unistd.h>
 
 ProximityAdaptorAscii::ProximityAdaptorAscii(const QString& id) :
-    SysfsAdaptor(id, SysfsAdaptor::IntervalMode)
+    SysfsAdaptor(id, SysfsAdaptor::IntervalMode, false)
 {
     proximityBuffer_ = new DeviceAdaptorRingBuffer<ProximityData>(1);
     setAdaptedSensor("proximity", "apds9802ps ascii", proximityBuffer_);
@@ -54,9 +54,8 @@ ProximityAdaptorAscii::~ProximityAdaptorAscii()
 void ProximityAdaptorAscii::processSample(int, int fd)
 {
     char buf[16];
-    lseek(fd, 0, SEEK_SET);
-    if (read(fd, buf, sizeof(buf)) <= 0) {
-        qCWarning(lcSensorFw) << id() << "read(): " << strerror(errno);
+    if (pread(fd, buf, sizeof(buf), 0) <= 0) {
+        qCWarning(lcSensorFw) << id() << "pread(): " << strerror(errno);
         return;
     }
     qCDebug(lcSensorFw) << id() << "Proximity output value: " << buf;
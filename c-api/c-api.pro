@@ -0,0 +1,21 @@
+# Client library without Qt dependencies
+TEMPLATE = lib
+TARGET = sensorfw-c
+
+CONFIG -= qt
+CONFIG += link_pkgconfig
+PKGCONFIG += dbus-1
+
+SOURCES += sensorfw-c.cpp
+
+HEADERS += sensorfw-c.h
+
+SENSORFW_INCLUDEPATHS = ../include
+
+DEPENDPATH += $$SENSORFW_INCLUDEPATHS
+INCLUDEPATH += $$SENSORFW_INCLUDEPATHS
+
+include(../common-install.pri)
+publicheaders.files = $$HEADERS
+target.path = $$SHAREDLIBPATH
+INSTALLS += target
@@ -0,0 +1,688 @@
+/**
+   @file sensorfw-c.cpp
+   @brief C-API for sensor framework
+
+   <p>
+   Copyright (c) 2026 Jolla Mobile Ltd
+
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "sensorfw-c.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <dbus/dbus.h>
+
+#include "sfwerror.h"
+#include "sensorwire.h"
+
+static_assert(sizeof(sensorfw_xyz_t) == SENSOR_WIRE_SAMPLE_SIZE(3 * sizeof(float)), "sensorfw_xyz_t does not match wire layout");
+static_assert(sizeof(sensorfw_magnetic_field_t) == SENSOR_WIRE_SAMPLE_SIZE(7 * sizeof(int32_t)), "sensorfw_magnetic_field_t does not match wire layout");
+static_assert(sizeof(sensorfw_compass_t) == SENSOR_WIRE_SAMPLE_SIZE(4 * sizeof(int32_t)), "sensorfw_compass_t does not match wire layout");
+static_assert(sizeof(sensorfw_unsigned_t) == SENSOR_WIRE_SAMPLE_SIZE(sizeof(uint32_t)), "sensorfw_unsigned_t does not match wire layout");
+static_assert(sizeof(sensorfw_proximity_t) == SENSOR_WIRE_SAMPLE_SIZE(sizeof(uint32_t) + sizeof(bool)), "sensorfw_proximity_t does not match wire layout");
+static_assert(sizeof(sensorfw_tap_t) == SENSOR_WIRE_SAMPLE_SIZE(2 * sizeof(int32_t)), "sensorfw_tap_t does not match wire layout");
+static_assert(sizeof(sensorfw_lid_t) == SENSOR_WIRE_SAMPLE_SIZE(2 * sizeof(int32_t)), "sensorfw_lid_t does not match wire layout");
+
+/** Name of the sensord D-Bus service. */
+static const char* const serviceName = "com.nokia.SensorService";
+
+/** Object path of the sensor manager. Sensors are below it. */
+static const char* const managerPath = "/SensorManager";
+
+/** Timeout of D-Bus calls (ms). */
+static const int callTimeout = 25000;
+
+/** Maximum number of simultaneously open sessions. */
+static const int maxSessions = 16;
+
+/** Bytes buffered from the data socket of a session. */
+static const int receiveBufferSize = 8192;
+
+/** Samples delivered per callback round by sensorfw_dispatch(). */
+static const int dispatchChunk = 64;
+
+/** Largest sample structure. */
+static const size_t maxSampleSize = sizeof(sensorfw_magnetic_field_t);
+
+/**
+ * Sample size of sensors by sensor name.
+ */
+struct SensorSampleSize
+{
+    const char* name;
+    size_t size;
+};
+
+static const SensorSampleSize sampleSizes[] = {
+    { "accelerometersensor", sizeof(sensorfw_xyz_t) },
+    { "gyroscopesensor", sizeof(sensorfw_xyz_t) },
+    { "rotationsensor", sizeof(sensorfw_xyz_t) },
+    { "magnetometersensor", sizeof(sensorfw_magnetic_field_t) },
+    { "compasssensor", sizeof(sensorfw_compass_t) },
+    { "proximitysensor", sizeof(sensorfw_proximity_t) },
+    { "tapsensor", sizeof(sensorfw_tap_t) },
+    { "lidsensor", sizeof(sensorfw_lid_t) },
+    { "alssensor", sizeof(sensorfw_unsigned_t) },
+    { "orientationsensor", sizeof(sensorfw_unsigned_t) },
+    { "stepcountersensor", sizeof(sensorfw_unsigned_t) },
+    { "pressuresensor", sizeof(sensorfw_unsigned_t) },
+    { "temperaturesensor", sizeof(sensorfw_unsigned_t) },
+    { "humiditysensor", sizeof(sensorfw_unsigned_t) },
+    { "wakeupsensor", sizeof(sensorfw_unsigned_t) }
+};
+
+/**
+ * Error state of a session, or of requests without one.
+ */
+struct SensorfwError
+{
+    int code;          /**< SensorError code */
+    char string[256];  /**< error description */
+};
+
+/**
+ * State of an open session.
+ */
+struct SensorfwSession
+{
+    int sessionId;                     /**< session ID, INVALID_SESSION for free slot */
+    int fd;                            /**< data socket */
+    bool running;                      /**< is the sensor started */
+    char sensorName[64];               /**< sensor ID */
+    char path[96];                     /**< D-Bus object path of the sensor */
+    size_t sampleSize;                 /**< size of streamed samples */
+    char received[receiveBufferSize];  /**< bytes received but not yet decoded */
+    int receivedSize;                  /**< number of bytes in received */
+    unsigned int frameRemaining;       /**< samples of a partially decoded frame */
+    void (*callback)(void* data);      /**< per sample callback */
+    void* batchBuffer;                 /**< batch delivery buffer */
+    int batchCapacity;                 /**< samples fitting into batchBuffer */
+    sensorfw_batch_callback_t batchCallback; /**< batch callback */
+    void* batchUserData;               /**< pointer passed to batchCallback */
+    char description[256];             /**< description returned to caller */
+    SensorfwError error;               /**< last error */
+};
+
+static SensorfwSession sessions[maxSessions];
+static bool sessionsInitialized = false;
+static SensorfwError globalError;
+static DBusConnection* connection = NULL;
+
+static void setError(SensorfwError* error, int code, const char* format, ...)
+{
+    error->code = code;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(error->string, sizeof(error->string), format, args);
+    va_end(args);
+}
+
+static void clearError(SensorfwError* error)
+{
+    error->code = 0;
+    error->string[0] = '\0';
+}
+
+static void initSessions()
+{
+    if (sessionsInitialized)
+        return;
+    for (int i = 0; i < maxSessions; ++i) {
+        sessions[i].sessionId = INVALID_SESSION;
+        sessions[i].fd = -1;
+    }
+    sessionsInitialized = true;
+}
+
+static SensorfwSession* findSession(int sessionId)
+{
+    initSessions();
+    if (sessionId == INVALID_SESSION)
+        return NULL;
+    for (int i = 0; i < maxSessions; ++i) {
+        if (sessions[i].sessionId == sessionId)
+            return &sessions[i];
+    }
+    setError(&globalError, SaValueOutOfRange, "Unknown session %d", sessionId);
+    return NULL;
+}
+
+static size_t sampleSizeOf(const char* sensorName)
+{
+    size_t nameLength = strcspn(sensorName, ";");
+    for (size_t i = 0; i < sizeof(sampleSizes) / sizeof(sampleSizes[0]); ++i) {
+        if (strlen(sampleSizes[i].name) == nameLength && !strncmp(sampleSizes[i].name, sensorName, nameLength))
+            return sampleSizes[i].size;
+    }
+    return 0;
+}
+
+static DBusConnection* systemBus(SensorfwError* error)
+{
+    if (!connection) {
+        DBusError dbusError;
+        dbus_error_init(&dbusError);
+        connection = dbus_bus_get(DBUS_BUS_SYSTEM, &dbusError);
+        if (!connection) {
+            setError(error, SaCannotAccessSensor, "Cannot connect to system bus: %s", dbusError.message);
+            dbus_error_free(&dbusError);
+            return NULL;
+        }
+        dbus_connection_set_exit_on_disconnect(connection, FALSE);
+    }
+    return connection;
+}
+
+/**
+ * Make a blocking D-Bus call to sensord. Arguments are given as for
+ * dbus_message_append_args(). Returned reply must be unreferenced.
+ */
+static DBusMessage* call(SensorfwError* error, const char* path, const char* method, int firstArgType, ...)
+{
+    DBusConnection* bus = systemBus(error);
+    if (!bus)
+        return NULL;
+
+    // Methods are unique over the interfaces of sensor objects
+    DBusMessage* message = dbus_message_new_method_call(serviceName, path, NULL, method);
+    if (!message) {
+        setError(error, SaCannotAccessSensor, "Out of memory");
+        return NULL;
+    }
+
+    va_list args;
+    va_start(args, firstArgType);
+    dbus_bool_t appended = dbus_message_append_args_valist(message, firstArgType, args);
+    va_end(args);
+    if (!appended) {
+        dbus_message_unref(message);
+        setError(error, SaCannotAccessSensor, "Out of memory");
+        return NULL;
+    }
+
+    DBusError dbusError;
+    dbus_error_init(&dbusError);
+    DBusMessage* reply = dbus_connection_send_with_reply_and_block(bus, message, callTimeout, &dbusError);
+    dbus_message_unref(message);
+    if (!reply) {
+        setError(error, SaCannotAccessSensor, "%s failed: %s", method, dbusError.message);
+        dbus_error_free(&dbusError);
+    }
+    return reply;
+}
+
+/**
+ * Read single value of given type from reply and unreference it.
+ */
+static bool replyValue(SensorfwError* error, DBusMessage* reply, int type, void* value)
+{
+    if (!reply)
+        return false;
+
+    DBusError dbusError;
+    dbus_error_init(&dbusError);
+    bool ok = dbus_message_get_args(reply, &dbusError, type, value, DBUS_TYPE_INVALID);
+    if (!ok) {
+        setError(error, SaCannotAccessSensor, "Unexpected reply: %s", dbusError.message);
+        dbus_error_free(&dbusError);
+    }
+    dbus_message_unref(reply);
+    return ok;
+}
+
+static bool replyBool(SensorfwError* error, DBusMessage* reply)
+{
+    dbus_bool_t value = FALSE;
+    return replyValue(error, reply, DBUS_TYPE_BOOLEAN, &value) && value;
+}
+
+static bool replyVoid(DBusMessage* reply)
+{
+    if (!reply)
+        return false;
+    dbus_message_unref(reply);
+    return true;
+}
+
+static bool connectDataSocket(SensorfwSession* session)
+{
+    const char* socketName = "/run/sensord.sock";
+    char socketPath[sizeof(((struct sockaddr_un*)0)->sun_path)];
+    const char* prefix = getenv("SENSORFW_SOCKET_PATH");
+    snprintf(socketPath, sizeof(socketPath), "%s%s", prefix ? prefix : "", socketName);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        setError(&session->error, SClientSocketError, "socket: %s", strerror(errno));
+        return false;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) == -1) {
+        setError(&session->error, SClientSocketError, "connect %s: %s", socketPath, strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    if (write(fd, &session->sessionId, sizeof(session->sessionId)) != sizeof(session->sessionId)) {
+        setError(&session->error, SClientSocketError, "Session ID write failed: %s", strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    // sensord announces the layout version once the connection is set up
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    char tag = 0;
+    if (poll(&pfd, 1, callTimeout) != 1 || read(fd, &tag, 1) != 1) {
+        setError(&session->error, SClientSocketError, "No response from data socket");
+        close(fd);
+        return false;
+    }
+    if (tag != SENSOR_WIRE_TAG) {
+        setError(&session->error, SClientSocketError, "Unsupported data socket version tag %d, expected version %u",
+                 tag, SENSOR_WIRE_VERSION);
+        close(fd);
+        return false;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    session->fd = fd;
+    return true;
+}
+
+/**
+ * Decode buffered samples, receiving more from the socket while there
+ * is room for them.
+ */
+static int readSamples(SensorfwSession* session, void* buffer, int capacity)
+{
+    char* out = static_cast<char*>(buffer);
+    int count = 0;
+    bool drained = false;
+    while (count < capacity) {
+        int consumed;
+        int n = sensorWireDecodeSamples(session->received, session->receivedSize,
+                                        out + count * session->sampleSize, session->sampleSize,
+                                        capacity - count, session->frameRemaining, consumed);
+        if (n < 0) {
+            setError(&session->error, SClientSocketError, "Corrupted data stream");
+            session->receivedSize = 0;
+            session->frameRemaining = 0;
+            return -1;
+        }
+        count += n;
+        session->receivedSize -= consumed;
+        if (consumed && session->receivedSize)
+            memmove(session->received, session->received + consumed, session->receivedSize);
+
+        if (count == capacity || drained)
+            break;
+
+        ssize_t bytes = recv(session->fd, session->received + session->receivedSize,
+                             receiveBufferSize - session->receivedSize, 0);
+        if (bytes > 0) {
+            session->receivedSize += bytes;
+        } else if (bytes == 0) {
+            setError(&session->error, SClientSocketError, "Data socket closed by sensord");
+            return count ? count : -1;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            drained = true;
+        } else if (errno != EINTR) {
+            setError(&session->error, SClientSocketError, "recv: %s", strerror(errno));
+            return count ? count : -1;
+        }
+    }
+    return count;
+}
+
+bool sensorfw_init(const char* sensor_name)
+{
+    initSessions();
+    clearError(&globalError);
+    if (!sensor_name) {
+        setError(&globalError, SaValueOutOfRange, "No sensor name");
+        return false;
+    }
+    if (!replyBool(&globalError, call(&globalError, managerPath, "loadPlugin",
+                                      DBUS_TYPE_STRING, &sensor_name, DBUS_TYPE_INVALID))) {
+        if (!globalError.code)
+            setError(&globalError, SmFactoryNotRegistered, "Failed to load %s", sensor_name);
+        return false;
+    }
+    return true;
+}
+
+int sensorfw_open_session(const char* sensor_name)
+{
+    initSessions();
+    clearError(&globalError);
+    if (!sensor_name || strlen(sensor_name) >= sizeof(sessions[0].sensorName)) {
+        setError(&globalError, SaValueOutOfRange, "Invalid sensor name");
+        return INVALID_SESSION;
+    }
+
+    SensorfwSession* session = NULL;
+    for (int i = 0; i < maxSessions && !session; ++i) {
+        if (sessions[i].sessionId == INVALID_SESSION)
+            session = &sessions[i];
+    }
+    if (!session) {
+        setError(&globalError, SaValueOutOfRange, "Too many open sessions");
+        return INVALID_SESSION;
+    }
+
+    dbus_int64_t pid = getpid();
+    dbus_int32_t sessionId = INVALID_SESSION;
+    if (!replyValue(&globalError, call(&globalError, managerPath, "requestSensor",
+                                       DBUS_TYPE_STRING, &sensor_name, DBUS_TYPE_INT64, &pid, DBUS_TYPE_INVALID),
+                    DBUS_TYPE_INT32, &sessionId) || sessionId == INVALID_SESSION) {
+        if (sessionId == INVALID_SESSION && !globalError.code)
+            setError(&globalError, SmIdNotRegistered, "Cannot open %s", sensor_name);
+        return INVALID_SESSION;
+    }
+
+    memset(session, 0, sizeof(*session));
+    session->sessionId = sessionId;
+    session->fd = -1;
+    strcpy(session->sensorName, sensor_name);
+    snprintf(session->path, sizeof(session->path), "%s/%s", managerPath, sensor_name);
+    session->sampleSize = sampleSizeOf(sensor_name);
+
+    if (!connectDataSocket(session)) {
+        SensorfwError releaseError;
+        replyVoid(call(&releaseError, managerPath, "releaseSensor",
+                       DBUS_TYPE_STRING, &sensor_name, DBUS_TYPE_INT32, &sessionId, DBUS_TYPE_INT64, &pid,
+                       DBUS_TYPE_INVALID));
+        globalError = session->error;
+        session->sessionId = INVALID_SESSION;
+        return INVALID_SESSION;
+    }
+    return sessionId;
+}
+
+bool sensorfw_close_session(int sessionId)
+{
+    clearError(&globalError);
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return false;
+
+    if (session->running)
+        sensorfw_stop_sensor(sessionId);
+
+    const char* sensorName = session->sensorName;
+    dbus_int32_t id = sessionId;
+    dbus_int64_t pid = getpid();
+    bool released = replyBool(&globalError, call(&globalError, managerPath, "releaseSensor",
+                                                 DBUS_TYPE_STRING, &sensorName, DBUS_TYPE_INT32, &id,
+                                                 DBUS_TYPE_INT64, &pid, DBUS_TYPE_INVALID));
+    close(session->fd);
+    session->fd = -1;
+    session->sessionId = INVALID_SESSION;
+    return released;
+}
+
+bool sensorfw_start_sensor(int sessionId)
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return false;
+
+    dbus_int32_t id = sessionId;
+    if (!replyVoid(call(&session->error, session->path, "start", DBUS_TYPE_INT32, &id, DBUS_TYPE_INVALID)))
+        return false;
+    session->running = true;
+    return true;
+}
+
+bool sensorfw_stop_sensor(int sessionId)
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return false;
+
+    dbus_int32_t id = sessionId;
+    if (!replyVoid(call(&session->error, session->path, "stop", DBUS_TYPE_INT32, &id, DBUS_TYPE_INVALID)))
+        return false;
+    session->running = false;
+    return true;
+}
+
+bool sensorfw_running(int sessionId)
+{
+    SensorfwSession* session = findSession(sessionId);
+    return session && session->running;
+}
+
+int sensorfw_get_interval(int sessionId)
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return 0;
+
+    dbus_uint32_t interval = 0;
+    replyValue(&session->error, call(&session->error, session->path, "interval", DBUS_TYPE_INVALID),
+               DBUS_TYPE_UINT32, &interval);
+    return interval;
+}
+
+bool sensorfw_set_interval(int sessionId, int interval)
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return false;
+
+    dbus_int32_t id = sessionId;
+    dbus_int32_t value = interval;
+    return replyVoid(call(&session->error, session->path, "setInterval",
+                          DBUS_TYPE_INT32, &id, DBUS_TYPE_INT32, &value, DBUS_TYPE_INVALID));
+}
+
+bool sensorfw_get_standby_override(int sessionId)
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return false;
+
+    return replyBool(&session->error, call(&session->error, session->path, "standbyOverride", DBUS_TYPE_INVALID));
+}
+
+bool sensorfw_set_standby_override(int sessionId, bool override)
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return false;
+
+    dbus_int32_t id = sessionId;
+    dbus_bool_t value = override;
+    return replyBool(&session->error, call(&session->error, session->path, "setStandbyOverride",
+                                           DBUS_TYPE_INT32, &id, DBUS_TYPE_BOOLEAN, &value, DBUS_TYPE_INVALID));
+}
+
+bool sensorfw_get_description(int sessionId, char** description)
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session || !description)
+        return false;
+
+    const char* value = NULL;
+    DBusMessage* reply = call(&session->error, session->path, "description", DBUS_TYPE_INVALID);
+    if (!reply)
+        return false;
+
+    DBusError dbusError;
+    dbus_error_init(&dbusError);
+    bool ok = dbus_message_get_args(reply, &dbusError, DBUS_TYPE_STRING, &value, DBUS_TYPE_INVALID);
+    if (ok) {
+        // The string is owned by the reply
+        snprintf(session->description, sizeof(session->description), "%s", value);
+        *description = session->description;
+    } else {
+        setError(&session->error, SaCannotAccessSensor, "Unexpected reply: %s", dbusError.message);
+        dbus_error_free(&dbusError);
+    }
+    dbus_message_unref(reply);
+    return ok;
+}
+
+bool sensorfw_register_callback(int sessionId, void (*cb_func)(void *data))
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return false;
+
+    session->callback = cb_func;
+    return true;
+}
+
+bool sensorfw_set_batch_buffer(int sessionId, void* buffer, size_t sample_size, int capacity,
+                               sensorfw_batch_callback_t cb_func, void* user_data)
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return false;
+
+    if (!buffer || capacity <= 0 || !cb_func || !session->sampleSize || sample_size != session->sampleSize) {
+        setError(&session->error, SaValueOutOfRange, "Invalid batch buffer for %s", session->sensorName);
+        return false;
+    }
+    session->batchBuffer = buffer;
+    session->batchCapacity = capacity;
+    session->batchCallback = cb_func;
+    session->batchUserData = user_data;
+    return true;
+}
+
+bool sensorfw_clear_batch_buffer(int sessionId)
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return false;
+
+    session->batchBuffer = NULL;
+    session->batchCapacity = 0;
+    session->batchCallback = NULL;
+    session->batchUserData = NULL;
+    return true;
+}
+
+int sensorfw_get_fd(int sessionId)
+{
+    SensorfwSession* session = findSession(sessionId);
+    return session ? session->fd : -1;
+}
+
+size_t sensorfw_sample_size(int sessionId)
+{
+    SensorfwSession* session = findSession(sessionId);
+    return session ? session->sampleSize : 0;
+}
+
+int sensorfw_read(int sessionId, void* buffer, size_t sample_size, int capacity)
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return -1;
+
+    if (!buffer || capacity <= 0 || !session->sampleSize || sample_size != session->sampleSize) {
+        setError(&session->error, SaValueOutOfRange, "Invalid read buffer for %s", session->sensorName);
+        return -1;
+    }
+    return readSamples(session, buffer, capacity);
+}
+
+int sensorfw_dispatch(int sessionId)
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return -1;
+
+    if (!session->sampleSize) {
+        setError(&session->error, SaValueOutOfRange, "Unknown sample type of %s", session->sensorName);
+        return -1;
+    }
+
+    int delivered = 0;
+    int capacity;
+    int count;
+    do {
+        if (session->batchBuffer) {
+            capacity = session->batchCapacity;
+            count = readSamples(session, session->batchBuffer, capacity);
+            if (count > 0) {
+                const char* samples = static_cast<const char*>(session->batchBuffer);
+                uint64_t firstTimestamp;
+                uint64_t lastTimestamp;
+                memcpy(&firstTimestamp, samples, sizeof(uint64_t));
+                memcpy(&lastTimestamp, samples + (count - 1) * session->sampleSize, sizeof(uint64_t));
+                session->batchCallback(sessionId, session->batchBuffer, count,
+                                       firstTimestamp, lastTimestamp, session->batchUserData);
+            }
+        } else if (session->callback) {
+            uint64_t samples[dispatchChunk * maxSampleSize / sizeof(uint64_t)];
+            capacity = dispatchChunk;
+            count = readSamples(session, samples, capacity);
+            for (int i = 0; i < count; ++i)
+                session->callback(reinterpret_cast<char*>(samples) + i * session->sampleSize);
+        } else {
+            return delivered;
+        }
+        if (count < 0)
+            return delivered ? delivered : -1;
+        delivered += count;
+
+        // Callbacks may have closed the session
+        if (session->sessionId != sessionId)
+            break;
+    } while (count == capacity);
+    return delivered;
+}
+
+bool sensorfw_prepare_for_calibration(int sessionId)
+{
+    SensorfwSession* session = findSession(sessionId);
+    if (!session)
+        return false;
+
+    return replyVoid(call(&session->error, session->path, "reset", DBUS_TYPE_INVALID));
+}
+
+int sensorfw_last_error(int sessionId, char** error_string)
+{
+    initSessions();
+    SensorfwError* error = &globalError;
+    for (int i = 0; i < maxSessions && sessionId != INVALID_SESSION; ++i) {
+        if (sessions[i].sessionId == sessionId)
+            error = &sessions[i].error;
+    }
+    if (error_string)
+        *error_string = error->string;
+    return error->code;
+}
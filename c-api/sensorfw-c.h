@@ -1,13 +1,16 @@
 /**
    @file sensorfw-c.h
-   @brief C-API for sensor framework. <b>NOTE THAT THIS HAS NOT BEEN IMPLEMENTED YET<b>
+   @brief C-API for sensor framework, implemented by libsensorfw-c.
+
+    The library talks to sensord directly without Qt. Control requests are
+    blocking D-Bus calls, and samples are read from the data socket of the
+    session, whose descriptor can be polled by the application. The
+    library is not thread safe.
 
     @todo
     <ul>
     <li>Querying and setting values for Data range</li>
     <li>Querying possible values for Interval and Data range</li>
-    <li>Control / Listen separation?</li>
-    <li>Generic type for callbacks, or callback must know what to expect?</li>
     </ul>
 
    <p>
@@ -34,6 +37,14 @@
 #ifndef SENSORFW_CAPI
 #define SENSORFW_CAPI
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * @brief Structure containing interval information for sensor.
  *
@@ -54,6 +65,96 @@ typedef struct {
     int accuracy; ///< Minimal detected change
 } sensorfw_range_t;
 
+/**
+ * @brief Sample of vector type sensors (accelerometer, gyroscope, rotation,
+ *        magnetometer raw data).
+ *
+ * Sample structures match the layout of the data socket, see
+ * datatypes/wireformat.h.
+ */
+typedef struct {
+    uint64_t timestamp; ///< Monotonic time (microsec)
+    float x; ///< X value
+    float y; ///< Y value
+    float z; ///< Z value
+} sensorfw_xyz_t;
+
+/**
+ * @brief Sample of calibrated magnetometer.
+ */
+typedef struct {
+    uint64_t timestamp; ///< Monotonic time (microsec)
+    int32_t x; ///< Calibrated X value
+    int32_t y; ///< Calibrated Y value
+    int32_t z; ///< Calibrated Z value
+    int32_t rx; ///< Raw X value
+    int32_t ry; ///< Raw Y value
+    int32_t rz; ///< Raw Z value
+    int32_t level; ///< Calibration level
+} sensorfw_magnetic_field_t;
+
+/**
+ * @brief Sample of compass.
+ */
+typedef struct {
+    uint64_t timestamp; ///< Monotonic time (microsec)
+    int32_t degrees; ///< Angle to north, declination corrected if enabled
+    int32_t raw_degrees; ///< Angle to north without declination correction
+    int32_t corrected_degrees; ///< Declination corrected angle to north
+    int32_t level; ///< Calibration level
+} sensorfw_compass_t;
+
+/**
+ * @brief Sample of single value sensors (als, orientation, step counter,
+ *        pressure, temperature, humidity).
+ */
+typedef struct {
+    uint64_t timestamp; ///< Monotonic time (microsec)
+    uint32_t value; ///< Measurement value
+} sensorfw_unsigned_t;
+
+/**
+ * @brief Sample of proximity sensor.
+ */
+typedef struct {
+    uint64_t timestamp; ///< Monotonic time (microsec)
+    uint32_t value; ///< Raw proximity value
+    bool within_proximity; ///< Is an object within proximity
+} sensorfw_proximity_t;
+
+/**
+ * @brief Sample of tap sensor.
+ */
+typedef struct {
+    uint64_t timestamp; ///< Monotonic time (microsec)
+    int32_t direction; ///< Direction of tap
+    int32_t type; ///< Single or double tap
+} sensorfw_tap_t;
+
+/**
+ * @brief Sample of lid sensor.
+ */
+typedef struct {
+    uint64_t timestamp; ///< Monotonic time (microsec)
+    int32_t type; ///< Type of lid
+    uint32_t value; ///< Measurement value
+} sensorfw_lid_t;
+
+/**
+ * @brief Callback receiving a batch of samples.
+ *
+ * @param sessionId Session the samples belong to.
+ * @param samples The buffer registered with sensorfw_set_batch_buffer, holding
+ *        \c count samples.
+ * @param count Number of samples in the batch.
+ * @param first_timestamp Timestamp of the first sample.
+ * @param last_timestamp Timestamp of the last sample.
+ * @param user_data Pointer given at registration.
+ */
+typedef void (*sensorfw_batch_callback_t)(int sessionId, const void* samples, int count,
+                                          uint64_t first_timestamp, uint64_t last_timestamp,
+                                          void* user_data);
+
 /**
  * @brief Initialises the sensor for operation.
  *
@@ -166,7 +267,9 @@ bool sensorfw_get_description(int sessionId, char** description);
 /**
  * @brief Registers a callback function to handle sensor output.
  *
- * @todo Description of callback requirements.
+ * The callback is called from sensorfw_dispatch once per sample, with
+ * \c data pointing to the sample structure matching the sensor, for example
+ * sensorfw_xyz_t for accelerometer. The sample is valid during the call only.
  *
  * @param sessionId Session ID to run this request on.
  * @param cb_func Pointer to function to use as callback.
@@ -174,6 +277,80 @@ bool sensorfw_get_description(int sessionId, char** description);
  */
 bool sensorfw_register_callback(int sessionId, void (*cb_func)(void *data));
 
+/**
+ * @brief Tells the data descriptor of the session.
+ *
+ * The descriptor becomes readable when samples are available. It can be
+ * added to the poll loop of the application, which then calls
+ * sensorfw_dispatch or sensorfw_read.
+ *
+ * @param sessionId Session ID to run this request on.
+ * @return file descriptor, \c -1 for invalid session ID.
+ */
+int sensorfw_get_fd(int sessionId);
+
+/**
+ * @brief Tells the size of sample structures streamed by the session.
+ *
+ * @param sessionId Session ID to run this request on.
+ * @return sample size in bytes, \c 0 for invalid session ID or unknown sensor.
+ */
+size_t sensorfw_sample_size(int sessionId);
+
+/**
+ * @brief Reads available samples into caller buffer.
+ *
+ * Never blocks. If \c capacity samples are returned, more may be pending
+ * and reading should be repeated before waiting for the descriptor again.
+ *
+ * @param sessionId Session ID to run this request on.
+ * @param buffer Array of sample structures matching the sensor.
+ * @param sample_size Size of a single sample structure.
+ * @param capacity Number of samples fitting into \c buffer.
+ * @return number of samples read, \c -1 on error or invalid session ID.
+ */
+int sensorfw_read(int sessionId, void* buffer, size_t sample_size, int capacity);
+
+/**
+ * @brief Delivers available samples to registered callbacks.
+ *
+ * Samples go to the batch buffer set with sensorfw_set_batch_buffer if
+ * there is one, otherwise to the callback set with
+ * sensorfw_register_callback. Never blocks.
+ *
+ * @param sessionId Session ID to run this request on.
+ * @return number of samples delivered, \c -1 on error or invalid session ID.
+ */
+int sensorfw_dispatch(int sessionId);
+
+/**
+ * @brief Registers a buffer receiving sensor output in batches.
+ *
+ * Samples are decoded straight into \c buffer and \c cb_func is called once
+ * per buffer-full, so nothing is allocated and no callback is made per
+ * sample. Replaces callback set with sensorfw_register_callback.
+ *
+ * @param sessionId Session ID to run this request on.
+ * @param buffer Array of sample structures matching the sensor type, for
+ *        example sensorfw_xyz_t for accelerometer. Must stay valid until
+ *        sensorfw_clear_batch_buffer is called or the session is closed.
+ * @param sample_size Size of a single sample structure.
+ * @param capacity Number of samples fitting into \c buffer.
+ * @param cb_func Function to call with each batch.
+ * @param user_data Pointer passed to \c cb_func.
+ * @return \c true on success, \c false on failure, invalid session ID or if
+ *         \c sample_size does not match the sensor.
+ */
+bool sensorfw_set_batch_buffer(int sessionId, void* buffer, size_t sample_size, int capacity,
+                               sensorfw_batch_callback_t cb_func, void* user_data);
+
+/**
+ * @brief Stops batch delivery set up with sensorfw_set_batch_buffer.
+ * @param sessionId Session ID to run this request on.
+ * @return \c true if successfull, \c false if failed or invalid session ID.
+ */
+bool sensorfw_clear_batch_buffer(int sessionId);
+
 /**
  * @brief Prepares the sensor for calibration.
  *
@@ -188,12 +365,17 @@ bool sensorfw_prepare_for_calibration(int sessionId);
 
 /**
  * @brief Returns the last error that has occurred for sensor.
- * @param sessionId Session ID to run this request on.
+ * @param sessionId Session ID to run this request on. Errors of requests
+ *        without a valid session, like failing sensorfw_init, are reported
+ *        for \c -1.
  * @param error_string If given, will be set to verbal description of the error.
  *        Can be referenced until the next error occurs.
- * @return Numerical code for the error that occurred
- * @todo Provide enums for error numbers.
+ * @return SensorError code from sfwerror.h, \c 0 if no error has occurred.
  */
 int sensorfw_last_error(int sessionId, char** error_string);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif // SENSORFW_CAPI
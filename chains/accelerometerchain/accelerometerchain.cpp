@@ -49,7 +49,7 @@ AccelerometerChain::AccelerometerChain(const QString& id) :
     if (accelerometerAdaptor_)
         setValid(accelerometerAdaptor_->isValid());
 
-    accelerometerReader_ = new BufferReader<AccelerationData>(1);
+    accelerometerReader_ = new BufferReader<AccelerationData>(64);
 
     // Get the transformation matrix from config file
     QString aconvString = SensorFrameworkConfig::configuration()->value<QString>("accelerometer/transformation_matrix", "");
@@ -63,7 +63,7 @@ AccelerometerChain::AccelerometerChain(const QString& id) :
     Q_ASSERT(accCoordinateAlignFilter_);
     ((CoordinateAlignFilter*) accCoordinateAlignFilter_)->setMatrix(TMatrix(aconv_));
 
-    outputBuffer_ = new RingBuffer<AccelerationData>(1);
+    outputBuffer_ = new RingBuffer<AccelerationData>(64);
     nameOutputBuffer("accelerometer", outputBuffer_);
 
     // Create buffers for filter chain
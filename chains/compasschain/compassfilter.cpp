@@ -40,23 +40,35 @@ CompassFilter::CompassFilter() :
     addSource(&magSource, "magnorthangle");
 }
 
-void CompassFilter::magDataAvailable(unsigned, const CalibratedMagneticFieldData *data)
+void CompassFilter::magDataAvailable(unsigned n, const CalibratedMagneticFieldData *data)
 {
-    magX = data->y_ * .001f;
-    magY = data->x_ * .001f;
-    magZ = data->z_ * .001f;
-    level = data->level_;
-
-    magX = oldMagX + FILTER_FACTOR * (magX - oldMagX);
-    magY = oldMagY + FILTER_FACTOR * (magY - oldMagY);
-    magZ = oldMagZ + FILTER_FACTOR * (magZ - oldMagZ);
-    oldMagX = magX;
-    oldMagY = magY;
-    oldMagZ = magZ;
+    for (unsigned i = 0; i < n; ++i) {
+        magX = data[i].y_ * .001f;
+        magY = data[i].x_ * .001f;
+        magZ = data[i].z_ * .001f;
+        level = data[i].level_;
+
+        magX = oldMagX + FILTER_FACTOR * (magX - oldMagX);
+        magY = oldMagY + FILTER_FACTOR * (magY - oldMagY);
+        magZ = oldMagZ + FILTER_FACTOR * (magZ - oldMagZ);
+        oldMagX = magX;
+        oldMagY = magY;
+        oldMagZ = magZ;
+    }
 }
 
 
-void CompassFilter::accelDataAvailable(unsigned, const AccelerationData *data)
+void CompassFilter::accelDataAvailable(unsigned n, const AccelerationData *data)
+{
+    CompassData* headings = output_.reserve(n);
+
+    for (unsigned i = 0; i < n; ++i)
+        headings[i] = computeHeading(&data[i]);
+
+    magSource.propagate(n, headings);
+}
+
+CompassData CompassFilter::computeHeading(const AccelerationData *data)
 {
     // the x/y are switched as compass expects it in aero coordinates
     qreal Gx = data->y_ * .001f; //convert to g
@@ -119,6 +131,6 @@ void CompassFilter::accelDataAvailable(unsigned, const AccelerationData *data)
     compassData.degrees_ = (int)(heading + 360) % 360;
     compassData.rawDegrees_ = compassData.degrees_;
     compassData.level_ = level;
-    magSource.propagate(1, &compassData);
     oldHeading = heading;
+    return compassData;
 }
@@ -44,9 +44,11 @@ private:
     Sink<CompassFilter, CalibratedMagneticFieldData> magDataSink;
     Sink<CompassFilter, AccelerationData> accelSink;
     Source<CompassData> magSource;
+    FilterOutputBuffer<CompassData> output_;
 
     void magDataAvailable(unsigned, const CalibratedMagneticFieldData*);
     void accelDataAvailable(unsigned, const AccelerationData*);
+    CompassData computeHeading(const AccelerationData*);
 
     qreal magX;
     qreal magY;
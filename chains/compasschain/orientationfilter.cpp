@@ -27,11 +27,17 @@ OrientationFilter::OrientationFilter()
     addSource(&magSource, "magnorthangle");
 }
 
-void OrientationFilter::orientDataAvailable(unsigned, const CompassData *data)
+void OrientationFilter::orientDataAvailable(unsigned n, const CompassData *data)
 {
-    compassData.timestamp_ = data->timestamp_;
-    compassData.degrees_ =  data->degrees_;
-    compassData.rawDegrees_ = data->rawDegrees_;
-    compassData.level_ = data->level_;
-    magSource.propagate(1, &compassData);
+    CompassData* headings = output_.reserve(n);
+
+    for (unsigned i = 0; i < n; ++i) {
+        compassData.timestamp_ = data[i].timestamp_;
+        compassData.degrees_ =  data[i].degrees_;
+        compassData.rawDegrees_ = data[i].rawDegrees_;
+        compassData.level_ = data[i].level_;
+        headings[i] = compassData;
+    }
+
+    magSource.propagate(n, headings);
 }
@@ -41,6 +41,7 @@ protected:
 
 private:
     Source<CompassData> magSource;
+    FilterOutputBuffer<CompassData> output_;
 
     Sink<OrientationFilter, CompassData> orientDataSink;
     void orientDataAvailable(unsigned, const CompassData*);
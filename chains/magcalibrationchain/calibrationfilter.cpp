@@ -68,7 +68,20 @@ CalibrationFilter::CalibrationFilter() :
 #endif
 }
 
-void CalibrationFilter::magDataAvailable(unsigned, const CalibratedMagneticFieldData *data)
+void CalibrationFilter::magDataAvailable(unsigned n, const CalibratedMagneticFieldData *data)
+{
+    CalibratedMagneticFieldData* calibrated = output_.reserve(n);
+
+    for (unsigned i = 0; i < n; ++i) {
+        calibrate(&data[i]);
+        calibrated[i] = transformed;
+    }
+
+    magSource.propagate(n, calibrated);
+    source_.propagate(n, calibrated);
+}
+
+void CalibrationFilter::calibrate(const CalibratedMagneticFieldData *data)
 {
     transformed.timestamp_ = data->timestamp_;
     transformed.x_ = data->rx_;
@@ -159,9 +172,6 @@ void CalibrationFilter::magDataAvailable(unsigned, const CalibratedMagneticField
     transformed.rx_ = data->rx_;
     transformed.ry_ = data->ry_;
     transformed.rz_ = data->rz_;
-
-    magSource.propagate(1, &transformed);
-    source_.propagate(1, &transformed);
 }
 
 void CalibrationFilter::dropCalibration()
@@ -48,6 +48,7 @@ private:
 
     Source<CalibratedMagneticFieldData> magSource;
     void magDataAvailable(unsigned, const CalibratedMagneticFieldData * );
+    void calibrate(const CalibratedMagneticFieldData * );
 
     CalibratedMagneticFieldData magData;
     CalibratedMagneticFieldData transformed;
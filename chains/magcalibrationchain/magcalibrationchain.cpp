@@ -64,13 +64,13 @@ MagCalibrationChain::MagCalibrationChain(const QString& id) :
 
     needsCalibration = SensorFrameworkConfig::configuration()->value<bool>("magnetometer/needs_calibration", true);
 
-    calibratedMagnetometerData = new RingBuffer<CalibratedMagneticFieldData>(1);
+    calibratedMagnetometerData = new RingBuffer<CalibratedMagneticFieldData>(64);
     nameOutputBuffer("calibratedmagnetometerdata", calibratedMagnetometerData);
 
     // Create buffers for filter chain
     filterBin = new Bin;
     //formationsink
-    magReader = new BufferReader<CalibratedMagneticFieldData>(1);
+    magReader = new BufferReader<CalibratedMagneticFieldData>(64);
 
     // Join filterchain buffers
     filterBin->add(magReader, "calibratedmagneticfield");
@@ -33,12 +33,18 @@
 #include "sockethandler.h"
 #include "idutils.h"
 #include "logging.h"
+#include "config.h"
+#include "sensorwire.h"
+
+/** Samples older than this (us) relative to the newest one are not averaged. */
+static const quint64 downsampleTimeout = 2000000;
 
 AbstractSensorChannel::AbstractSensorChannel(const QString& id) :
     NodeBase(getCleanId(id)),
     errorCode_(SNoError),
     cnt_(0)
 {
+    latency_.setSampleInterval(qMax(0, SensorFrameworkConfig::configuration()->value<int>("latency/sample_interval", 16)));
 }
 
 void AbstractSensorChannel::setError(SensorError errorCode, const QString& errorString)
@@ -56,6 +62,7 @@ bool AbstractSensorChannel::start(int sessionId)
     if (!activeSessions_.contains(sessionId)) {
         activeSessions_.insert(sessionId);
         requestDefaultInterval(sessionId);
+        setBufferSessionActive(sessionId, true);
         return start();
     }
     return false;
@@ -87,6 +94,8 @@ bool AbstractSensorChannel::stop()
 
 bool AbstractSensorChannel::writeToSession(int sessionId, const void* source, int size)
 {
+    if (latency_.sample())
+        latency_.recordSinceSampleTime(sensorWireTimestamp((const char*)source, size));
     if (!(SensorManager::instance().write(sessionId, source, size))) {
         qCInfo(lcSensorFw) << id() << "AbstractSensor failed to write to session " << sessionId;
         return false;
@@ -103,130 +112,131 @@ bool AbstractSensorChannel::writeToClients(const void* source, int size)
     return ret;
 }
 
-bool AbstractSensorChannel::downsampleAndPropagate(const TimedXyzData& data, TimedXyzDownsampleBuffer& buffer)
+bool AbstractSensorChannel::groupSessionsForDownsampling(const void* source, int size, DownsampleGroups& groups)
 {
     bool ret = true;
     unsigned int currentInterval = getInterval();
 
     foreach (int sessionId, activeSessions_) {
-        if (!downsamplingEnabled(sessionId)) {
-            ret &= writeToSession(sessionId, (const void *)& data, sizeof(TimedXyzData));
+        unsigned int factor = 1;
+        if (downsamplingEnabled(sessionId))
+            factor = decimationFactor(getInterval(sessionId), currentInterval);
+
+        // Averaging over one sample would only reproduce it
+        if (factor == 1) {
+            ret &= writeToSession(sessionId, source, size);
             continue;
         }
-        unsigned int sessionInterval = getInterval(sessionId);
-        int bufferSize = (sessionInterval < currentInterval || !currentInterval) ? 1 : sessionInterval / currentInterval;
-
-        QList<TimedXyzData>& samples(buffer[sessionId]);
-        samples.push_back(data);
-
-        for (QList<TimedXyzData>::iterator it = samples.begin(); it != samples.end(); ++it) {
-            if (samples.size() > bufferSize
-                    || data.timestamp_ - it->timestamp_ > 2000000) {
-                it = samples.erase(it);
-                if (it == samples.end())
-                    break;
-            } else {
-                break;
-            }
+
+        int group = 0;
+        while (group < groups.size() && groups[group].factor != factor)
+            ++group;
+        if (group == groups.size()) {
+            groups.resize(group + 1);
+            groups[group].factor = factor;
+            groups[group].sessions.clear();
         }
+        groups[group].sessions.append(sessionId);
+    }
+    return ret;
+}
 
-        if (samples.size() < bufferSize)
-            continue;
+template <class BUFFER>
+void AbstractSensorChannel::pruneDownsampleBuffer(BUFFER& buffer, const DownsampleGroups& groups)
+{
+    if (buffer.size() <= groups.size())
+        return;
+
+    typename BUFFER::iterator it = buffer.begin();
+    while (it != buffer.end()) {
+        int group = 0;
+        while (group < groups.size() && groups[group].factor != it.key())
+            ++group;
+        if (group == groups.size())
+            it = buffer.erase(it);
+        else
+            ++it;
+    }
+}
 
-        float x = 0;
-        float y = 0;
-        float z = 0;
+bool AbstractSensorChannel::downsampleAndPropagate(const TimedXyzData& data, TimedXyzDownsampleBuffer& buffer)
+{
+    DownsampleGroups groups;
+    bool ret = groupSessionsForDownsampling(&data, sizeof(TimedXyzData), groups);
+
+    for (int g = 0; g < groups.size(); ++g) {
+        const DownsampleGroup& group(groups[g]);
+        SlidingWindow<3>& samples(buffer[group.factor]);
+        samples.setCapacity(group.factor);
+        const double values[3] = { data.x_, data.y_, data.z_ };
+        samples.push(data.timestamp_, values);
+        if (data.timestamp_ > downsampleTimeout)
+            samples.expireBefore(data.timestamp_ - downsampleTimeout);
+
+        if (!samples.isFull())
+            continue;
 
-        foreach (const TimedXyzData& data, samples) {
-            x += data.x_;
-            y += data.y_;
-            z += data.z_;
-        }
         TimedXyzData downsampled(data.timestamp_,
-                                 x / samples.count(),
-                                 y / samples.count(),
-                                 z / samples.count());
-
-        if (writeToSession(sessionId, (const void*)& downsampled, sizeof(TimedXyzData))) {
-            samples.clear();
-        } else {
-            ret = false;
+                                 samples.mean(0),
+                                 samples.mean(1),
+                                 samples.mean(2));
+        samples.clear();
+
+        for (int i = 0; i < group.sessions.size(); ++i) {
+            ret &= writeToSession(group.sessions[i], (const void*)& downsampled, sizeof(TimedXyzData));
         }
     }
 
+    pruneDownsampleBuffer(buffer, groups);
     return ret;
 }
 
 bool AbstractSensorChannel::downsampleAndPropagate(const CalibratedMagneticFieldData& data, MagneticFieldDownsampleBuffer& buffer)
 {
-    bool ret = true;
-    unsigned int currentInterval = getInterval();
-
-    foreach (int sessionId, activeSessions_) {
-        if (!downsamplingEnabled(sessionId)) {
-            ret &= writeToSession(sessionId, (const void *)& data, sizeof(CalibratedMagneticFieldData));
-            continue;
-        }
-        unsigned int sessionInterval = getInterval(sessionId);
-        int bufferSize = (sessionInterval < currentInterval || !currentInterval) ? 1 : sessionInterval / currentInterval;
-
-        QList<CalibratedMagneticFieldData>& samples(buffer[sessionId]);
-        samples.push_back(data);
-
-        for (QList<CalibratedMagneticFieldData>::iterator it = samples.begin(); it != samples.end(); ++it) {
-            if (samples.size() > bufferSize
-                    || data.timestamp_ - it->timestamp_ > 2000000) {
-                it = samples.erase(it);
-                if (it == samples.end())
-                    break;
-            } else {
-                break;
-            }
-        }
-
-        if (samples.size() < bufferSize)
+    DownsampleGroups groups;
+    bool ret = groupSessionsForDownsampling(&data, sizeof(CalibratedMagneticFieldData), groups);
+
+    for (int g = 0; g < groups.size(); ++g) {
+        const DownsampleGroup& group(groups[g]);
+        SlidingWindow<6, qint64>& samples(buffer[group.factor]);
+        samples.setCapacity(group.factor);
+        const qint64 values[6] = { data.x_, data.y_, data.z_, data.rx_, data.ry_, data.rz_ };
+        samples.push(data.timestamp_, values);
+        if (data.timestamp_ > downsampleTimeout)
+            samples.expireBefore(data.timestamp_ - downsampleTimeout);
+
+        if (!samples.isFull())
             continue;
 
-        long x = 0;
-        long y = 0;
-        long z = 0;
-        long rx = 0;
-        long ry = 0;
-        long rz = 0;
-
-        foreach (const CalibratedMagneticFieldData& data, samples) {
-            x += data.x_;
-            y += data.y_;
-            z += data.z_;
-            rx += data.rx_;
-            ry += data.ry_;
-            rz += data.rz_;
-        }
         CalibratedMagneticFieldData downsampled(data.timestamp_,
-                                                x / samples.count(),
-                                                y / samples.count(),
-                                                z / samples.count(),
-                                                rx / samples.count(),
-                                                ry / samples.count(),
-                                                rz / samples.count(),
+                                                samples.mean(0),
+                                                samples.mean(1),
+                                                samples.mean(2),
+                                                samples.mean(3),
+                                                samples.mean(4),
+                                                samples.mean(5),
                                                 data.level_);
+        samples.clear();
 
-        if (writeToSession(sessionId, (const void*)& downsampled, sizeof(CalibratedMagneticFieldData))) {
-            samples.clear();
-        } else {
-            ret = false;
+        for (int i = 0; i < group.sessions.size(); ++i) {
+            ret &= writeToSession(group.sessions[i], (const void*)& downsampled, sizeof(CalibratedMagneticFieldData));
         }
-
     }
+
+    pruneDownsampleBuffer(buffer, groups);
     return ret;
 }
 
-
 void AbstractSensorChannel::setDownsamplingEnabled(int sessionId, bool value)
 {
     if (downsamplingSupported()) {
         qCDebug(lcSensorFw) << id() << "Downsampling state for session " << sessionId << ": " << value;
         downsampling_[sessionId] = value;
+
+        // Interval plan depends on which sessions are decimated
+        unsigned int interval_us = getInterval(sessionId);
+        if (interval_us)
+            setIntervalRequest(sessionId, interval_us);
     }
 }
 
@@ -243,6 +253,34 @@ bool AbstractSensorChannel::downsamplingSupported() const
     return false;
 }
 
+bool AbstractSensorChannel::decimatesInterval(int sessionId) const
+{
+    return downsamplingSupported() && downsampling_.value(sessionId, true);
+}
+
+QVariantMap AbstractSensorChannel::intervalPlan() const
+{
+    unsigned int currentInterval = getInterval();
+    QVariantMap sessions;
+    foreach (int sessionId, activeSessions_) {
+        unsigned int sessionInterval = getInterval(sessionId);
+        QVariantMap session;
+        session["interval_us"] = sessionInterval;
+        session["decimation"] = downsamplingEnabled(sessionId) ? decimationFactor(sessionInterval, currentInterval) : 1u;
+        sessions[QString::number(sessionId)] = session;
+    }
+
+    QVariantMap plan;
+    plan["interval_us"] = currentInterval;
+    plan["sessions"] = sessions;
+    return plan;
+}
+
+QVariantMap AbstractSensorChannel::latencyStatistics() const
+{
+    return latency_.summary();
+}
+
 void AbstractSensorChannel::removeSession(int sessionId)
 {
     downsampling_.take(sessionId);
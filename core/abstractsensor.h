@@ -35,6 +35,8 @@
 #include <QMap>
 #include <QList>
 #include <QSet>
+#include <QVarLengthArray>
+#include <QVariantMap>
 
 #include "nodebase.h"
 #include "logging.h"
@@ -42,6 +44,8 @@
 #include "datarange.h"
 #include "genericdata.h"
 #include "orientationdata.h"
+#include "slidingwindow.h"
+#include "latencyhistogram.h"
 
 /**
  * Base class for sensor type specific nodes. This is used as base class
@@ -115,6 +119,35 @@ public:
      */
     virtual bool downsamplingSupported() const;
 
+    /**
+     * Is output for the session decimated: downsampling is supported and
+     * has not been disabled for the session.
+     *
+     * @param sessionId session ID.
+     * @return is output for the session decimated.
+     */
+    bool decimatesInterval(int sessionId) const override;
+
+    /**
+     * Current interval plan: the interval the sensor runs at and, for
+     * each active session, the requested interval and decimation factor
+     * used to reach it.
+     *
+     * @return map with interval_us and sessions entries. Sessions are
+     *         keyed by session ID and hold interval_us and decimation.
+     */
+    QVariantMap intervalPlan() const;
+
+    /**
+     * Latency of samples reaching this channel, measured from their
+     * timestamp when written to sessions, see
+     * LatencyHistogram::recordSinceSampleTime(). Covers adaptor, filter
+     * chain and channel processing.
+     *
+     * @return map with samples, p50_us, p99_us and max_us entries.
+     */
+    QVariantMap latencyStatistics() const;
+
     virtual void removeSession(int sessionId);
 
     /**
@@ -167,11 +200,23 @@ Q_SIGNALS:
     void errorSignal(int error);
 
 protected:
-    /** Sample buffer type for TimedXyzData downsampling. */
-    typedef QMap<int, QList<TimedXyzData> > TimedXyzDownsampleBuffer;
+    /** Sample buffer type for TimedXyzData downsampling, keyed by decimation factor. */
+    typedef QMap<unsigned int, SlidingWindow<3> > TimedXyzDownsampleBuffer;
+
+    /** Sample buffer type for CalibratedMagneticFieldData downsampling, keyed by decimation factor. */
+    typedef QMap<unsigned int, SlidingWindow<6, qint64> > MagneticFieldDownsampleBuffer;
 
-    /** Sample buffer type for CalibratedMagneticFieldData downsampling. */
-    typedef QMap<int, QList<CalibratedMagneticFieldData> > MagneticFieldDownsampleBuffer;
+    /**
+     * Sessions sharing a downsampling decimation factor.
+     */
+    struct DownsampleGroup
+    {
+        unsigned int factor;              /**< decimation factor */
+        QVarLengthArray<int, 8> sessions; /**< sessions in the group */
+    };
+
+    /** Downsampled sessions grouped by decimation factor. */
+    typedef QVarLengthArray<DownsampleGroup, 4> DownsampleGroups;
 
     /**
      * Constructor.
@@ -220,6 +265,18 @@ protected:
      */
     bool downsampleAndPropagate(const CalibratedMagneticFieldData& data, MagneticFieldDownsampleBuffer& buffer);
 
+    /**
+     * Write data as is to sessions which are not downsampled, and group
+     * the rest by decimation factor so that each average is computed
+     * only once.
+     *
+     * @param source Object to write.
+     * @param size Size of the object.
+     * @param groups Set to downsampled sessions by decimation factor.
+     * @return was data succesfully written.
+     */
+    bool groupSessionsForDownsampling(const void* source, int size, DownsampleGroups& groups);
+
     /**
      * Signal property change.
      *
@@ -240,11 +297,21 @@ private:
      */
     bool writeToSession(int sessionId, const void* source, int size);
 
+    /**
+     * Drop windows of decimation factors no longer used by any session.
+     *
+     * @param buffer Downsample buffer.
+     * @param groups Current session groups.
+     */
+    template <class BUFFER>
+    static void pruneDownsampleBuffer(BUFFER& buffer, const DownsampleGroups& groups);
+
     SensorError         errorCode_;       /**< previous occured error code */
     QString             errorString_;     /**< previous occured error description */
     int                 cnt_;             /**< usage reference count */
     QSet<int>           activeSessions_;  /**< active sessions */
     QMap<int, bool>     downsampling_;    /**< downsample state for sessions */
+    LatencyHistogram    latency_;         /**< latency of written samples */
 };
 
 /**
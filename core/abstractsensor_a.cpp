@@ -94,6 +94,16 @@ bool AbstractSensorChannelAdaptor::hwBuffering() const
     return hwBuffering;
 }
 
+QVariantMap AbstractSensorChannelAdaptor::intervalPlan() const
+{
+    return node()->intervalPlan();
+}
+
+QVariantMap AbstractSensorChannelAdaptor::latencyStatistics() const
+{
+    return node()->latencyStatistics();
+}
+
 QString AbstractSensorChannelAdaptor::type() const
 {
     return node()->type();
@@ -245,3 +255,11 @@ void AbstractSensorChannelAdaptor::setDownsampling(int sessionId, bool value)
 {
     node()->setDownsamplingEnabled(sessionId, value);
 }
+
+QDBusUnixFileDescriptor AbstractSensorChannelAdaptor::openSharedRing(int sessionId)
+{
+    int fd = SensorManager::instance().socketHandler().openSharedRing(sessionId);
+    if (fd == -1)
+        return QDBusUnixFileDescriptor();
+    return QDBusUnixFileDescriptor(fd);
+}
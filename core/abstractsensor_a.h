@@ -180,6 +180,20 @@ public Q_SLOTS: // METHODS
     /** AbstractSensorChannel::hwBuffering() */
     bool hwBuffering() const;
 
+    /** AbstractSensorChannel::intervalPlan() */
+    QVariantMap intervalPlan() const;
+
+    /** AbstractSensorChannel::latencyStatistics() */
+    QVariantMap latencyStatistics() const;
+
+    /** SocketHandler::openSharedRing(int)
+     *
+     *  Switches the data connection of the session to shared memory
+     *  transport. Invalid descriptor is returned if not available, in
+     *  which case samples keep flowing through the socket.
+     */
+    QDBusUnixFileDescriptor openSharedRing(int sessionId);
+
 Q_SIGNALS:
     /** AbstractSensorChannel::propertyChanged(name) */
     void propertyChanged(const QString& name);
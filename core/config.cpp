@@ -30,13 +30,24 @@
 #include <QSettings>
 #include <QVariant>
 #include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QDataStream>
 #include <QDir>
 #include <QList>
+#include <string.h>
 
 static SensorFrameworkConfig *static_configuration = nullptr;
 
+namespace {
+/** Identifies a configuration cache file, "SFWC". */
+const quint32 cacheMagic = 0x53465743;
+/** Layout of the cache file, bumped on incompatible changes. */
+const quint32 cacheVersion = 1;
+}
+
 SensorFrameworkConfig::SensorFrameworkConfig()
-    : m_settings(QString(), QSettings::IniFormat)
 {
 }
 
@@ -44,31 +55,50 @@ SensorFrameworkConfig::~SensorFrameworkConfig()
 {
 }
 
-bool SensorFrameworkConfig::loadConfig(const QString &defConfigPath, const QString &configDPath)
+bool SensorFrameworkConfig::loadConfig(const QString &defConfigPath, const QString &configDPath,
+                                       const QString &cachePath)
 {
     /* Not having config files is ok, failing to load one that exists is not */
     bool ret = true;
     if (!static_configuration) {
         static_configuration = new SensorFrameworkConfig();
     }
+    QStringList files;
     /* Process config.d dir in alnum order */
     if (!configDPath.isEmpty()) {
         QDir dir(configDPath, "*.conf", QDir::Name, QDir::Files);
         foreach (const QString &file, dir.entryList()) {
-            if (!static_configuration->loadConfigFile(dir.absoluteFilePath(file))) {
-                ret = false;
-            }
+            files << dir.absoluteFilePath(file);
         }
     }
     /* Primary config file overrides config.d */
     if (!defConfigPath.isEmpty() && QFile::exists(defConfigPath) ) {
-        if (!static_configuration->loadConfigFile(defConfigPath))
+        files << defConfigPath;
+    }
+
+    QHash<QString, QVariant> values;
+    QByteArray filesSignature;
+    if (!cachePath.isEmpty()) {
+        filesSignature = signature(files);
+        if (readCache(cachePath, filesSignature, values)) {
+            qCInfo(lcSensorFw) << "Configuration loaded from cache" << cachePath;
+            static_configuration->merge(values);
+            return true;
+        }
+    }
+
+    foreach (const QString &file, files) {
+        if (!loadConfigFile(file, values))
             ret = false;
     }
+    static_configuration->merge(values);
+
+    if (ret && !cachePath.isEmpty())
+        writeCache(cachePath, filesSignature, values);
     return ret;
 }
 
-bool SensorFrameworkConfig::loadConfigFile(const QString &configFileName)
+bool SensorFrameworkConfig::loadConfigFile(const QString &configFileName, QHash<QString, QVariant> &values)
 {
     /* Success means the file was loaded and processed without hiccups */
     bool loaded = false;
@@ -83,7 +113,7 @@ bool SensorFrameworkConfig::loadConfigFile(const QString &configFileName)
             qCWarning(lcSensorFw) << "Unable to open \"" << configFileName <<  "\" configuration file";
         } else {
             foreach (const QString &key, merge.allKeys()) {
-                m_settings.setValue(key, merge.value(key));
+                values.insert(key, merge.value(key));
             }
             loaded = true;
         }
@@ -91,19 +121,134 @@ bool SensorFrameworkConfig::loadConfigFile(const QString &configFileName)
     return loaded;
 }
 
-QVariant SensorFrameworkConfig::value(const QString &key) const
+QByteArray SensorFrameworkConfig::signature(const QStringList &files)
+{
+    QByteArray signature;
+    foreach (const QString &file, files) {
+        QFileInfo info(file);
+        signature += info.absoluteFilePath().toUtf8();
+        signature += ' ' + QByteArray::number(info.size());
+        signature += ' ' + QByteArray::number(info.lastModified().toMSecsSinceEpoch());
+        signature += '\n';
+    }
+    return signature;
+}
+
+bool SensorFrameworkConfig::readCache(const QString &cachePath, const QByteArray &signature,
+                                      QHash<QString, QVariant> &values)
+{
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QByteArray cachedSignature;
+    in >> magic >> version;
+    if (magic != cacheMagic || version != cacheVersion)
+        return false;
+    in >> cachedSignature;
+    if (in.status() != QDataStream::Ok || cachedSignature != signature) {
+        qCInfo(lcSensorFw) << "Configuration files changed, ignoring cache" << cachePath;
+        return false;
+    }
+    in >> values;
+    if (in.status() != QDataStream::Ok) {
+        qCWarning(lcSensorFw) << "Configuration cache" << cachePath << "is corrupted";
+        values.clear();
+        return false;
+    }
+    return true;
+}
+
+void SensorFrameworkConfig::writeCache(const QString &cachePath, const QByteArray &signature,
+                                       const QHash<QString, QVariant> &values)
+{
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(lcSensorFw) << "Unable to write configuration cache" << cachePath << ":" << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << cacheMagic << cacheVersion << signature << values;
+    if (out.status() != QDataStream::Ok || !file.commit())
+        qCWarning(lcSensorFw) << "Unable to write configuration cache" << cachePath << ":" << file.errorString();
+}
+
+void SensorFrameworkConfig::merge(const QHash<QString, QVariant> &values)
 {
-    QVariant var = m_settings.value(key, QVariant());
-    if (var.isValid()) {
-        qCDebug(lcSensorFw) << "Value for key" << key << ":" << var.toString();
+    for (QHash<QString, QVariant>::const_iterator it = values.constBegin(); it != values.constEnd(); ++it) {
+        QByteArray key = it.key().toUtf8();
+        int entry = find(key.constData(), key.size());
+        if (entry >= 0) {
+            m_entries[entry].value = it.value();
+        } else {
+            Entry newEntry;
+            newEntry.key = key;
+            newEntry.value = it.value();
+            m_entries.append(newEntry);
+        }
     }
-    return var;
+
+    /* Keep at least half of the slots free so probe sequences stay short */
+    int slots = 16;
+    while (slots < m_entries.size() * 2)
+        slots *= 2;
+    m_index.fill(-1, slots);
+    m_groups.clear();
+    for (int i = 0; i < m_entries.size(); ++i) {
+        const Entry &entry = m_entries.at(i);
+        int slot = qHashBits(entry.key.constData(), entry.key.size()) & (slots - 1);
+        while (m_index.at(slot) >= 0)
+            slot = (slot + 1) & (slots - 1);
+        m_index[slot] = i;
+
+        int separator = entry.key.indexOf('/');
+        if (separator > 0) {
+            QString group = QString::fromUtf8(entry.key.constData(), separator);
+            if (!m_groups.contains(group))
+                m_groups << group;
+        }
+        qCDebug(lcSensorFw) << "Value for key" << entry.key << ":" << entry.value.toString();
+    }
+    m_groups.sort();
+}
+
+int SensorFrameworkConfig::find(const char *key, int length) const
+{
+    if (m_index.isEmpty())
+        return -1;
+    const int mask = m_index.size() - 1;
+    for (int slot = qHashBits(key, length) & mask; ; slot = (slot + 1) & mask) {
+        int entry = m_index.at(slot);
+        if (entry < 0)
+            return -1;
+        const QByteArray &candidate = m_entries.at(entry).key;
+        if (candidate.size() == length && !memcmp(candidate.constData(), key, length))
+            return entry;
+    }
+}
+
+QVariant SensorFrameworkConfig::value(const QString &key) const
+{
+    QByteArray utf8 = key.toUtf8();
+    int entry = find(utf8.constData(), utf8.size());
+    return entry < 0 ? QVariant() : m_entries.at(entry).value;
+}
+
+QVariant SensorFrameworkConfig::value(const char *key) const
+{
+    int entry = find(key, qstrlen(key));
+    return entry < 0 ? QVariant() : m_entries.at(entry).value;
 }
 
 QStringList SensorFrameworkConfig::groups() const
 {
-    QStringList groups = m_settings.childGroups();
-    return groups;
+    return m_groups;
 }
 
 SensorFrameworkConfig *SensorFrameworkConfig::configuration()
@@ -122,5 +267,6 @@ void SensorFrameworkConfig::close()
 
 bool SensorFrameworkConfig::exists(const QString &key) const
 {
-    return value(key).isValid();
+    QByteArray utf8 = key.toUtf8();
+    return find(utf8.constData(), utf8.size()) >= 0;
 }
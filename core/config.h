@@ -29,14 +29,24 @@
 #define SENSORD_CONFIG_H
 
 #include <QString>
+#include <QStringList>
 #include <QVariant>
-#include <QSettings>
-#include <QList>
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
 
 /**
  * Sensord configuration parser. Configuration is read and parsed with
  * the QSettings class. SensorFrameworkConfig is a singleton instance to which configuration
  * is loaded once during startup.
+ *
+ * The merged configuration is kept as a flat snapshot with a hashed
+ * index. Only lookups of keys given as string literals are free of
+ * parsing and allocations; QString keys are converted to UTF-8 on every
+ * lookup, and value<T>() converts the stored QVariant on every call, so
+ * values needed repeatedly should be read once and kept. The snapshot
+ * can be cached to a file, which is used instead of parsing as long as
+ * none of the configuration files has changed.
  */
 class SensorFrameworkConfig
 {
@@ -48,13 +58,22 @@ public:
 
     /**
      * Find value for given key. Default QVariant is returned if key does
-     * not exists.
+     * not exists. The key is converted to UTF-8 on every call.
      *
      * @param key Configuration key.
      * @return Value for given key.
      */
     QVariant value(const QString &key) const;
 
+    /**
+     * Find value for given key. Default QVariant is returned if key does
+     * not exists.
+     *
+     * @param key Configuration key in UTF-8.
+     * @return Value for given key.
+     */
+    QVariant value(const char *key) const;
+
     /**
      * List of available groups in configuration.
      *
@@ -74,6 +93,18 @@ public:
     template<typename T>
     T value(const QString &key, const T &def = T()) const;
 
+    /**
+     * Find value for given key. Given default value is returned if key
+     * does not exists.
+     *
+     * @tparam T Value type for configuration entry.
+     * @param key Configuration key in UTF-8.
+     * @param def Returned value if key does not exists.
+     * @return Value for given key.
+     */
+    template<typename T>
+    T value(const char *key, const T &def = T()) const;
+
     /**
      * Does given key exists in configuration.
      *
@@ -94,8 +125,11 @@ public:
      *
      * @param defConfigPath Path to the config file.
      * @param configDPath Path to the directory with config files.
+     * @param cachePath Path to the cache of the parsed files. Empty
+     *                  disables caching.
      */
-    static bool loadConfig(const QString &defConfigPath, const QString &configDPath);
+    static bool loadConfig(const QString &defConfigPath, const QString &configDPath,
+                           const QString &cachePath = QString());
 
     /**
      * Close singleton instance.
@@ -127,11 +161,70 @@ private:
      * Load configuration file from given path.
      *
      * @param configFileName Configuration file path.
+     * @param values Map to add the values of the file to.
      * @return was configuration loaded successfully.
      */
-    bool loadConfigFile(const QString &configFileName);
+    static bool loadConfigFile(const QString &configFileName, QHash<QString, QVariant> &values);
+
+    /**
+     * Signature of configuration files identifying their content in the
+     * cache.
+     *
+     * @param files Configuration file paths.
+     * @return paths, sizes and modification times of the files.
+     */
+    static QByteArray signature(const QStringList &files);
+
+    /**
+     * Read parsed configuration from cache.
+     *
+     * @param cachePath Cache file path.
+     * @param signature Signature of the configuration files.
+     * @param values Map to store the cached values to.
+     * @return was the cache valid for the files.
+     */
+    static bool readCache(const QString &cachePath, const QByteArray &signature,
+                          QHash<QString, QVariant> &values);
+
+    /**
+     * Write parsed configuration to cache.
+     *
+     * @param cachePath Cache file path.
+     * @param signature Signature of the configuration files.
+     * @param values Parsed values of the files.
+     */
+    static void writeCache(const QString &cachePath, const QByteArray &signature,
+                           const QHash<QString, QVariant> &values);
+
+    /**
+     * Add values to the snapshot, overriding existing ones, and rebuild
+     * the index.
+     *
+     * @param values Values to add.
+     */
+    void merge(const QHash<QString, QVariant> &values);
+
+    /**
+     * Find entry for given key.
+     *
+     * @param key Configuration key in UTF-8.
+     * @param length Length of the key.
+     * @return index to m_entries, -1 if key does not exist.
+     */
+    int find(const char *key, int length) const;
 
-    QSettings m_settings; /**< parsed QSettings */
+    /**
+     * Single configuration value.
+     */
+    struct Entry
+    {
+        QByteArray key; /**< key in UTF-8 */
+        QVariant value; /**< value as parsed by QSettings */
+    };
+
+    QVector<Entry> m_entries; /**< configuration values */
+    QVector<int> m_index;     /**< open addressed hash of m_entries, -1 for free slots */
+    QStringList m_groups;     /**< groups of the configuration keys */
 };
 
 template<typename T>
@@ -143,4 +236,13 @@ T SensorFrameworkConfig::value(const QString &key, const T &def) const
     return val.value<T>();
 }
 
+template<typename T>
+T SensorFrameworkConfig::value(const char *key, const T &def) const
+{
+    QVariant val(value(key));
+    if (!val.isValid())
+        return def;
+    return val.value<T>();
+}
+
 #endif // SENSORD_CONFIG_H
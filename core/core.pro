@@ -44,8 +44,11 @@ SOURCES += \
     abstractchain.cpp \
     sysfsadaptor.cpp \
     sockethandler.cpp \
+    samplestagingarea.cpp \
+    sharedsessionring.cpp \
     inputdevadaptor.cpp \
     config.cpp \
+    startuptrace.cpp \
     nodebase.cpp
 
 HEADERS += \
@@ -73,8 +76,13 @@ HEADERS += \
     abstractchain.h \
     sysfsadaptor.h \
     sockethandler.h \
+    samplestagingarea.h \
+    spscring.h \
+    slidingwindow.h \
+    sharedsessionring.h \
     inputdevadaptor.h \
     config.h \
+    startuptrace.h \
     nodebase.h
 
 mce {
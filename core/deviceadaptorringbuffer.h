@@ -47,7 +47,10 @@ public:
     {}
 
     using RingBuffer<TYPE>::nextSlot;
+    using RingBuffer<TYPE>::reserve;
     using RingBuffer<TYPE>::commit;
+    using RingBuffer<TYPE>::beginBatch;
+    using RingBuffer<TYPE>::endBatch;
     using RingBuffer<TYPE>::wakeUpReaders;
 };
 
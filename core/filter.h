@@ -44,10 +44,63 @@ protected:
     FilterBase();
 };
 
+/**
+ * Reusable output storage for filters which emit whole batches. The
+ * storage grows to the largest batch seen and is then reused, so steady
+ * state batch processing does not allocate.
+ *
+ * @tparam TYPE output data type.
+ */
+template <class TYPE>
+class FilterOutputBuffer
+{
+public:
+    /**
+     * Constructor.
+     */
+    FilterOutputBuffer() : data_(0), capacity_(0) {}
+
+    /**
+     * Destructor.
+     */
+    ~FilterOutputBuffer()
+    {
+        delete[] data_;
+    }
+
+    /**
+     * Get storage for at least given number of elements. Previous
+     * content is not preserved when the storage needs to grow.
+     *
+     * @param n number of elements.
+     * @return pointer to the storage.
+     */
+    TYPE* reserve(unsigned n)
+    {
+        if (n > capacity_) {
+            delete[] data_;
+            data_ = new TYPE[n];
+            capacity_ = n;
+        }
+        return data_;
+    }
+
+private:
+    FilterOutputBuffer(const FilterOutputBuffer&);
+    FilterOutputBuffer& operator=(const FilterOutputBuffer&);
+
+    TYPE*    data_;     /**< storage */
+    unsigned capacity_; /**< allocated elements */
+};
+
 /**
  * Extendable filter class. Filters data from given source "source"
  * to sink "sink".
  *
+ * Sink callbacks receive all samples pushed in one go. Filters should
+ * process the whole batch and propagate the results with a single call,
+ * using #output_ as storage for the results.
+ *
  * @tparam INPUT_TYPE input data type.
  * @tparam DERIVED subclass type.
  * @tparam OUTPUT_TYPE output data type.
@@ -71,8 +124,9 @@ public:
     }
 
 protected:
-    Sink<DERIVED, INPUT_TYPE> sink_;   /**< data sink.   */
-    Source<OUTPUT_TYPE>       source_; /**< data source. */
+    Sink<DERIVED, INPUT_TYPE>       sink_;   /**< data sink.   */
+    Source<OUTPUT_TYPE>             source_; /**< data source. */
+    FilterOutputBuffer<OUTPUT_TYPE> output_; /**< batch output storage. */
 };
 
 /**
@@ -22,13 +22,17 @@
 #include "hybrisadaptor.h"
 #include "hybrisbackend.h"
 #include "deviceadaptor.h"
+#include "ringbuffer.h"
 #include "config.h"
+#include "startuptrace.h"
 
 #include <QDebug>
 #include <QCoreApplication>
 #include <QTimer>
 
 #include <fcntl.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
 #include <errno.h>
 #include <time.h>
 #include <signal.h>
@@ -172,6 +176,7 @@ HybrisSensorState::HybrisSensorState()
     : m_minDelay_us(0)
     , m_maxDelay_us(0)
     , m_delay_us(-1)
+    , m_latency_us(0)
     , m_active(-1)
 {
     memset(&m_fallbackEvent, 0, sizeof m_fallbackEvent);
@@ -200,10 +205,13 @@ HybrisManager::HybrisManager(QObject *parent)
     , m_sensorState(nullptr)
     , m_indexOfType()
     , m_indexOfHandle()
-    , m_eventPipeReadFd(-1)
-    , m_eventPipeWriteFd(-1)
-    , m_eventPipeNotifier(nullptr)
+    , m_eventRing(nullptr)
+    , m_eventRingFd(-1)
+    , m_eventRingNotifier(nullptr)
+    , m_droppedEvents(0)
 {
+    StartupTrace::Scope trace("backend", "HybrisManager");
+
     /* Arrange it so that sensors get stopped on exit from mainloop
      */
     connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
@@ -240,6 +248,7 @@ bool HybrisManager::typeRequiresWakeup(int type)
 
 void HybrisManager::initManager()
 {
+    StartupTrace::Scope trace("backend", "initManager");
     QString sensorTypes = SensorFrameworkConfig::configuration()->value("hybrisQuirks/doubleStopReader", QString());
     for (const QString &iter : sensorTypes.split(" ")) {
         int sensorType = iter.toInt();
@@ -249,8 +258,8 @@ void HybrisManager::initManager()
         }
     }
 
-    /* Initialize sensor data forwarding pipe */
-    initEventPipe();
+    /* Initialize sensor data forwarding ring */
+    initEventRing();
 
     /* Reserve space for sensor state data */
     m_sensorState = new HybrisSensorState[m_backend->sensorCount()];
@@ -413,8 +422,8 @@ void HybrisManager::cleanup()
     delete[] m_sensorState;
     m_sensorState = nullptr;
 
-    /* Close sensor data transfer pipe */
-    cleanupEventPipe();
+    /* Release sensor data transfer ring */
+    cleanupEventRing();
 }
 
 HybrisManager *HybrisManager::instance()
@@ -493,11 +502,16 @@ void HybrisManager::stopReader(HybrisAdaptor *adaptor)
     }
 }
 
-void HybrisManager::processSample(const sensors_event_t& data)
+void HybrisManager::processSamples(const sensors_event_t *data, int count)
 {
-    foreach (HybrisAdaptor *adaptor, m_registeredAdaptors.values(data.type)) {
+    /* All events are expected to be of the same sensor type */
+    const HybrisDispatchEntry *entry = dispatchEntry(data[0].type);
+    if (!entry)
+        return;
+
+    for (HybrisAdaptor *adaptor : entry->m_adaptors) {
         if (adaptor->isRunning()) {
-            adaptor->processSample(data);
+            adaptor->processSamples(data, count);
         }
     }
 }
@@ -506,9 +520,61 @@ void HybrisManager::registerAdaptor(HybrisAdaptor *adaptor)
 {
     if (!m_registeredAdaptors.values().contains(adaptor) && adaptor->isValid()) {
         m_registeredAdaptors.insert(adaptor->m_sensorType, adaptor);
+        rebuildDispatchTable();
+    }
+}
+
+void HybrisManager::unregisterAdaptor(HybrisAdaptor *adaptor)
+{
+    if (m_registeredAdaptors.remove(adaptor->m_sensorType, adaptor)) {
+        rebuildDispatchTable();
+    }
+}
+
+void HybrisManager::rebuildDispatchTable()
+{
+    /* Flatten the type -> adaptors mapping so that event dispatching
+     * needs neither map lookups nor allocations. Standard sensor types
+     * are small integers and are indexed directly, device private types
+     * are found by scanning the (short) table. */
+    m_dispatchTable.clear();
+    m_dispatchIndexOfType.clear();
+
+    for (auto it = m_registeredAdaptors.constBegin(); it != m_registeredAdaptors.constEnd(); ++it) {
+        int type = it.key();
+        if (m_dispatchTable.isEmpty() || m_dispatchTable.last().m_sensorType != type) {
+            HybrisDispatchEntry entry;
+            entry.m_sensorType = type;
+            m_dispatchTable.append(entry);
+            if (type >= 0 && type < SENSOR_TYPE_DEVICE_PRIVATE_BASE) {
+                if (m_dispatchIndexOfType.size() <= type)
+                    m_dispatchIndexOfType.resize(type + 1);
+            }
+        }
+        m_dispatchTable.last().m_adaptors.append(it.value());
+    }
+
+    m_dispatchIndexOfType.fill(-1);
+    for (int i = 0; i < m_dispatchTable.size(); ++i) {
+        int type = m_dispatchTable.at(i).m_sensorType;
+        if (type >= 0 && type < m_dispatchIndexOfType.size())
+            m_dispatchIndexOfType[type] = i;
     }
 }
 
+const HybrisDispatchEntry *HybrisManager::dispatchEntry(int sensorType) const
+{
+    if (sensorType >= 0 && sensorType < m_dispatchIndexOfType.size()) {
+        int index = m_dispatchIndexOfType.at(sensorType);
+        return (index < 0) ? nullptr : &m_dispatchTable.at(index);
+    }
+    for (const HybrisDispatchEntry &entry : m_dispatchTable) {
+        if (entry.m_sensorType == sensorType)
+            return &entry;
+    }
+    return nullptr;
+}
+
 float HybrisManager::scaleSensorValue(const float value, const int type) const
 {
     float outValue;
@@ -632,7 +698,14 @@ bool HybrisManager::setDelay(int handle, int delay_us, bool force)
             success = true;
         } else {
             int64_t delay_ns = delay_us * 1000LL;
-            int error = m_backend->setDelay(handle, delay_ns);
+            /* Batch no longer than it takes to fill the hw fifo */
+            int64_t latency_us = state->m_latency_us;
+            int fifoSize = m_backend->fifoMaxEventCount(index);
+            if (fifoSize <= 0 || delay_us <= 0)
+                latency_us = 0;
+            else if (latency_us > (int64_t)fifoSize * delay_us)
+                latency_us = (int64_t)fifoSize * delay_us;
+            int error = m_backend->setDelay(handle, delay_ns, latency_us * 1000LL);
             if (error) {
                 qCWarning(lcSensorFw, "HYBRIS CTL setDelay(%d=%s, %d) -> %d=%s",
                           handle, sensorTypeName(type), delay_us,
@@ -649,6 +722,75 @@ bool HybrisManager::setDelay(int handle, int delay_us, bool force)
     return success;
 }
 
+int HybrisManager::getFifoMaxEventCount(int handle) const
+{
+    int count = 0;
+    int index = indexForHandle(handle);
+
+    if (index != -1)
+        count = m_backend->fifoMaxEventCount(index);
+
+    return count;
+}
+
+int HybrisManager::getLatency(int handle) const
+{
+    int latency_us = 0;
+    int index = indexForHandle(handle);
+
+    if (index != -1)
+        latency_us = m_sensorState[index].m_latency_us;
+
+    return latency_us;
+}
+
+bool HybrisManager::setLatency(int handle, int latency_us)
+{
+    bool success = false;
+    int index = indexForHandle(handle);
+
+    if (index != -1) {
+        HybrisSensorState *state = &m_sensorState[index];
+
+        if (state->m_latency_us == latency_us) {
+            success = true;
+        } else {
+            int previous_us = state->m_latency_us;
+            state->m_latency_us = latency_us;
+            qCInfo(lcSensorFw, "HYBRIS CTL setLatency(%d=%s, %d)",
+                   handle, sensorTypeName(m_backend->type(index)), latency_us);
+            /* Latency is applied together with the delay */
+            if (state->m_delay_us < 0 || setDelay(handle, state->m_delay_us, true))
+                success = true;
+            else
+                state->m_latency_us = previous_us;
+        }
+    }
+
+    return success;
+}
+
+bool HybrisManager::flush(int handle)
+{
+    bool success = false;
+    int index = indexForHandle(handle);
+
+    if (index != -1) {
+        int error = m_backend->flush(handle);
+        if (error) {
+            qCWarning(lcSensorFw, "HYBRIS CTL flush(%d=%s) -> %d=%s",
+                      handle, sensorTypeName(m_backend->type(index)),
+                      error, strerror(error));
+        } else {
+            qCDebug(lcSensorFw, "HYBRIS CTL flush(%d=%s) -> success",
+                    handle, sensorTypeName(m_backend->type(index)));
+            success = true;
+        }
+    }
+
+    return success;
+}
+
 bool HybrisManager::getActive(int handle) const
 {
     bool active = false;
@@ -715,66 +857,69 @@ void *HybrisManager::eventReaderThread(void *aptr)
     return 0;
 }
 
-void HybrisManager::initEventPipe()
+/* Events are handed from the reader thread to the main thread through a
+ * lock-free ring. The main thread is woken up via eventfd only when the
+ * ring turns non-empty, and then drains everything that is available.
+ */
+static const unsigned eventRingSize = 16 * maxEvents;
+
+void HybrisManager::initEventRing()
 {
-    qCInfo(lcSensorFw, "initialize event pipe");
-    int pfd[2] = {-1, -1};
-    if (::pipe2(pfd, O_CLOEXEC) == -1) {
-        qCWarning(lcSensorFw, "failed to create event pipe: %s", strerror(errno));
+    qCInfo(lcSensorFw, "initialize event ring");
+    m_eventRingFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_eventRingFd == -1) {
+        qCWarning(lcSensorFw, "failed to create event ring eventfd: %s", strerror(errno));
     } else {
-        m_eventPipeReadFd = pfd[0];
-        m_eventPipeWriteFd = pfd[1];
-        m_eventPipeNotifier = new QSocketNotifier(m_eventPipeReadFd, QSocketNotifier::Read);
-        QObject::connect(m_eventPipeNotifier, &QSocketNotifier::activated, this, &HybrisManager::eventPipeWakeup);
-        m_eventPipeNotifier->setEnabled(true);
+        m_eventRing = new SpscRing<sensors_event_t>(eventRingSize);
+        m_eventRingNotifier = new QSocketNotifier(m_eventRingFd, QSocketNotifier::Read);
+        QObject::connect(m_eventRingNotifier, &QSocketNotifier::activated, this, &HybrisManager::eventRingWakeup);
+        m_eventRingNotifier->setEnabled(true);
     }
 }
 
-void HybrisManager::cleanupEventPipe()
+void HybrisManager::cleanupEventRing()
 {
-    qCInfo(lcSensorFw, "cleanup event pipe");
-    if (m_eventPipeNotifier) {
-        delete m_eventPipeNotifier;
-        m_eventPipeNotifier = nullptr;
+    qCInfo(lcSensorFw, "cleanup event ring");
+    if (m_eventRingNotifier) {
+        delete m_eventRingNotifier;
+        m_eventRingNotifier = nullptr;
     }
-    if (m_eventPipeWriteFd != -1) {
-        ::close(m_eventPipeWriteFd);
-        m_eventPipeWriteFd = -1;
-    }
-    if (m_eventPipeReadFd != -1) {
-        ::close(m_eventPipeReadFd);
-        m_eventPipeReadFd = -1;
+    if (m_eventRingFd != -1) {
+        ::close(m_eventRingFd);
+        m_eventRingFd = -1;
     }
+    delete m_eventRing;
+    m_eventRing = nullptr;
 }
 
-void HybrisManager::eventPipeWakeup(int fd)
+void HybrisManager::eventRingWakeup(int fd)
 {
-    if (m_eventPipeReadFd != fd) {
-        m_eventPipeNotifier->setEnabled(false);
-        qCWarning(lcSensorFw, "fd mismatch, event pipe notifier disabled");
-    } else {
-        sensors_event_t events[maxEvents];
-        ssize_t rc = ::read(m_eventPipeReadFd, events, sizeof events);
-        if (rc == 0) {
-            qCWarning(lcSensorFw, "event pipe eof, notifier disabled");
-            m_eventPipeNotifier->setEnabled(false);
-        } else if (rc == -1) {
-            if (errno != EAGAIN && errno != EINTR) {
-                qCWarning(lcSensorFw, "event pipe %s, notifier disabled", strerror(errno));
-                m_eventPipeNotifier->setEnabled(false);
-            }
-        } else {
-            const int numEvents = static_cast<int>(rc / sizeof *events);
-            processEvents(events, numEvents);
-        }
+    if (m_eventRingFd != fd) {
+        m_eventRingNotifier->setEnabled(false);
+        qCWarning(lcSensorFw, "fd mismatch, event ring notifier disabled");
+        return;
+    }
+
+    uint64_t counter;
+    if (::read(m_eventRingFd, &counter, sizeof counter) == -1 && errno != EAGAIN && errno != EINTR) {
+        qCWarning(lcSensorFw, "event ring eventfd %s, notifier disabled", strerror(errno));
+        m_eventRingNotifier->setEnabled(false);
+        return;
+    }
+
+    /* Process events in place, releasing slots only afterwards */
+    unsigned available;
+    const sensors_event_t *events;
+    while ((events = m_eventRing->peek(available)) && available > 0) {
+        processEvents(events, static_cast<int>(available));
+        m_eventRing->release(available);
     }
 }
 
-int HybrisManager::queueEvents(const sensors_event_t *buffer, int numEvents)
+int HybrisManager::checkEvents(const sensors_event_t *buffer, int numEvents, bool &errorInInput)
 {
-    /* Pre-checks */
     int wakeupEventCount = 0;
-    bool errorInInput = false;
+    errorInInput = false;
     for (int i = 0; i < numEvents; i++) {
         const sensors_event_t &data = buffer[i];
         qCDebug(lcSensorFw, "QUEUE HYBRIS EVE %s", sensorTypeName(data.type));
@@ -791,19 +936,88 @@ int HybrisManager::queueEvents(const sensors_event_t *buffer, int numEvents)
     if (wakeupEventCount)
         ObtainTemporaryWakeLock();
 
-    /* Forward via pipe for processing in main threah */
-    if (!errorInInput && numEvents > 0 && m_eventPipeWriteFd != -1) {
-        if (::write(m_eventPipeWriteFd, buffer, numEvents * sizeof *buffer) == -1) {
-            qCWarning(lcSensorFw, "event pipe write failure: %s", strerror(errno));
-            errorInInput = true;
-        }
+    return wakeupEventCount;
+}
+
+void HybrisManager::signalEventRing()
+{
+    uint64_t one = 1;
+    if (::write(m_eventRingFd, &one, sizeof one) == -1 && errno != EAGAIN)
+        qCWarning(lcSensorFw, "event ring wakeup failure: %s", strerror(errno));
+}
+
+void HybrisManager::rateLimitErrors()
+{
+    /* Rate limit after receiving erraneous events */
+    struct timespec ts = { 0, 50 * 1000 * 1000 }; // 50 ms
+    do { } while (nanosleep(&ts, &ts) == -1 && errno == EINTR);
+}
+
+sensors_event_t *HybrisManager::reserveEvents(int numEvents, int &granted)
+{
+    granted = 0;
+    if (!m_eventRing || numEvents <= 0)
+        return nullptr;
+
+    unsigned available = 0;
+    sensors_event_t *slots = m_eventRing->reserve(numEvents, available);
+    granted = static_cast<int>(available);
+    return slots;
+}
+
+int HybrisManager::commitEvents(const sensors_event_t *slots, int numEvents)
+{
+    bool errorInInput;
+    int wakeupEventCount = checkEvents(slots, numEvents, errorInInput);
+
+    /* Publish in place - or leave the slots to be reused if the batch
+     * contains garbage, like queueEvents() drops such batches */
+    if (!errorInInput) {
+        if (m_eventRing->commit(numEvents))
+            signalEventRing();
+    } else {
+        rateLimitErrors();
     }
+    return wakeupEventCount;
+}
 
-    /* Rate limit after receiving erraneous events / write failures */
-    if (errorInInput) {
-        struct timespec ts = { 0, 50 * 1000 * 1000 }; // 50 ms
-        do { } while (nanosleep(&ts, &ts) == -1 && errno == EINTR);
+int HybrisManager::queueEvents(const sensors_event_t *buffer, int numEvents)
+{
+    /* Pre-checks */
+    bool errorInInput;
+    int wakeupEventCount = checkEvents(buffer, numEvents, errorInInput);
+
+    /* Forward via ring for processing in main thread */
+    if (!errorInInput && numEvents > 0 && m_eventRing) {
+        unsigned queued = 0;
+        int retries = 0;
+        while (queued < static_cast<unsigned>(numEvents)) {
+            bool wakeup;
+            unsigned pushed = m_eventRing->push(buffer + queued, numEvents - queued, wakeup);
+            if (wakeup)
+                signalEventRing();
+            queued += pushed;
+            if (queued < static_cast<unsigned>(numEvents)) {
+                /* Ring full: give main thread a moment to catch up,
+                 * like a blocking pipe write would, but not forever. */
+                if (++retries > 100) {
+                    if (!m_droppedEvents)
+                        qCWarning(lcSensorFw, "event ring full, dropping events");
+                    m_droppedEvents += numEvents - queued;
+                    break;
+                }
+                struct timespec ts = { 0, 1000 * 1000 }; // 1 ms
+                do { } while (nanosleep(&ts, &ts) == -1 && errno == EINTR);
+            }
+        }
+        if (m_droppedEvents && queued == static_cast<unsigned>(numEvents)) {
+            qCWarning(lcSensorFw, "event ring recovered, %u events dropped", m_droppedEvents);
+            m_droppedEvents = 0;
+        }
     }
+
+    if (errorInInput)
+        rateLimitErrors();
     return wakeupEventCount;
 }
 
@@ -821,10 +1035,16 @@ int HybrisManager::processEvents(const sensors_event_t *buffer, int numEvents)
     if (wakeupEventCount)
         ObtainTemporaryWakeLock();
 
-    /* Push the sensor data down chains */
-    for (int i = 0; i < numEvents; i++) {
+    /* Push the sensor data down chains, one run of consecutive
+     * events from the same sensor at a time */
+    for (int i = 0; i < numEvents;) {
         const sensors_event_t& data = buffer[i];
-        qCDebug(lcSensorFw, "HYBRIS EVE %s", sensorTypeName(data.type));
+        int count = 1;
+        while (i + count < numEvents
+               && buffer[i + count].sensor == data.sensor
+               && buffer[i + count].type == data.type)
+            ++count;
+        qCDebug(lcSensorFw, "HYBRIS EVE %s x %d", sensorTypeName(data.type), count);
 
         /* Got data -> Clear the no longer needed fallback event */
         sensors_event_t *fallback = eventForHandle(data.sensor);
@@ -832,7 +1052,8 @@ int HybrisManager::processEvents(const sensors_event_t *buffer, int numEvents)
             fallback->type = fallback->sensor = 0;
         }
 
-        processSample(data);
+        processSamples(buffer + i, count);
+        i += count;
     }
     return wakeupEventCount;
 }
@@ -848,6 +1069,8 @@ HybrisAdaptor::HybrisAdaptor(const QString& id, int type)
     , m_shouldBeRunning(false)
     , m_sensorHandle(-1)
     , m_sensorType(type)
+    , m_bufferSize(0)
+    , m_bufferInterval_us(0)
 {
     m_sensorHandle = hybrisManager()->handleForType(m_sensorType);
     if (m_sensorHandle == -1) {
@@ -864,12 +1087,37 @@ HybrisAdaptor::HybrisAdaptor(const QString& id, int type)
 
 HybrisAdaptor::~HybrisAdaptor()
 {
+    if (HybrisManager *manager = hybrisManager())
+        manager->unregisterAdaptor(this);
 }
 
 void HybrisAdaptor::init()
 {
 }
 
+void HybrisAdaptor::processSamples(const sensors_event_t *data, int count)
+{
+    /* Wake up readers once per run instead of once per sample. A run
+     * is split to chunks fitting the buffer so that readers do not
+     * fall behind and lose samples. */
+    AdaptedSensorEntry *entry = getAdaptedSensor();
+    RingBufferBase *buffer = entry ? entry->buffer() : nullptr;
+    if (!buffer) {
+        for (int i = 0; i < count; ++i)
+            processSample(data[i]);
+        return;
+    }
+
+    int chunk = static_cast<int>(buffer->size());
+    for (int i = 0; i < count; i += chunk) {
+        int end = qMin(count, i + chunk);
+        buffer->beginBatch();
+        for (int j = i; j < end; ++j)
+            processSample(data[j]);
+        buffer->endBatch();
+    }
+}
+
 void HybrisAdaptor::sendInitialData()
 {
     // virtual dummy
@@ -938,6 +1186,10 @@ bool HybrisAdaptor::setInterval(const int sessionId, const unsigned int interval
 
     bool ok = hybrisManager()->setDelay(m_sensorHandle, interval_us, false);
 
+    /* Latency derived from buffer size depends on the delay */
+    if (ok && m_bufferSize > 1)
+        updateReportLatency();
+
     if (!ok) {
         qCWarning(lcSensorFw) << id() << Q_FUNC_INFO << "setInterval not ok";
     } else {
@@ -957,6 +1209,83 @@ bool HybrisAdaptor::setInterval(const int sessionId, const unsigned int interval
     return ok;
 }
 
+/* ------------------------------------------------------------------------- *
+ * hw fifo batching
+ * ------------------------------------------------------------------------- */
+
+IntegerRangeList HybrisAdaptor::getAvailableBufferSizes(bool& hwSupported) const
+{
+    int fifoSize = hybrisManager()->getFifoMaxEventCount(m_sensorHandle);
+    if (fifoSize <= 0)
+        return DeviceAdaptor::getAvailableBufferSizes(hwSupported);
+
+    IntegerRangeList list;
+    list.push_back(IntegerRange(1, fifoSize));
+    hwSupported = true;
+    return list;
+}
+
+IntegerRangeList HybrisAdaptor::getAvailableBufferIntervals(bool& hwSupported) const
+{
+    if (hybrisManager()->getFifoMaxEventCount(m_sensorHandle) <= 0)
+        return DeviceAdaptor::getAvailableBufferIntervals(hwSupported);
+
+    // Same [0, 60] second range as without hw support, the
+    // hybris manager caps latency to what the fifo can hold
+    IntegerRangeList list;
+    list.push_back(IntegerRange(0, 60 * 1000 * 1000));
+    hwSupported = true;
+    return list;
+}
+
+unsigned int HybrisAdaptor::bufferSize() const
+{
+    return m_bufferSize;
+}
+
+unsigned int HybrisAdaptor::bufferInterval() const
+{
+    return m_bufferInterval_us;
+}
+
+bool HybrisAdaptor::setBufferSize(unsigned int value)
+{
+    m_bufferSize = value;
+    return updateReportLatency();
+}
+
+bool HybrisAdaptor::setBufferInterval(unsigned int interval_us)
+{
+    m_bufferInterval_us = interval_us;
+    return updateReportLatency();
+}
+
+bool HybrisAdaptor::updateReportLatency()
+{
+    /* Map buffering requests to max report latency: deliver when
+     * either the requested interval has passed or the requested
+     * number of samples has been collected, whichever comes first.
+     * The requests are the smallest ones of the sessions, or none
+     * when some session is not buffered. */
+    unsigned int latency_us = m_bufferInterval_us;
+    int delay_us = hybrisManager()->getDelay(m_sensorHandle);
+    if (m_bufferSize > 1 && delay_us > 0) {
+        unsigned int sizeLatency_us = m_bufferSize * delay_us;
+        if (!latency_us || sizeLatency_us < latency_us)
+            latency_us = sizeLatency_us;
+    }
+
+    int previous_us = hybrisManager()->getLatency(m_sensorHandle);
+    if (!hybrisManager()->setLatency(m_sensorHandle, latency_us))
+        return false;
+
+    /* Deliver already batched samples when latency gets shorter */
+    if ((int)latency_us < previous_us && m_isRunning)
+        hybrisManager()->flush(m_sensorHandle);
+
+    return true;
+}
+
 /* ------------------------------------------------------------------------- *
  * start/stop adaptor
  * ------------------------------------------------------------------------- */
@@ -1016,6 +1345,10 @@ void HybrisAdaptor::evaluateSensor()
             if (entry->removeReference() == 0) {
                 entry->setIsRunning(false);
             }
+            /* Drain the hw fifo so that stale batched samples are
+             * not delivered after the next start */
+            if (hybrisManager()->getLatency(m_sensorHandle) > 0)
+                hybrisManager()->flush(m_sensorHandle);
             hybrisManager()->stopReader(this);
         }
         qCDebug(lcSensorFw) << id() << Q_FUNC_INFO << "entry" << entry->name()
@@ -27,10 +27,12 @@
 #include <QTimer>
 #include <QFile>
 #include <QSocketNotifier>
+#include <QVector>
 
 #include "deviceadaptor.h"
 
 #include "hybrisbackend.h"
+#include "spscring.h"
 
 #include <pthread.h>
 
@@ -194,10 +196,17 @@ struct HybrisSensorState
     int  m_minDelay_us;
     int  m_maxDelay_us;
     int  m_delay_us;
+    int  m_latency_us;
     int  m_active;
     sensors_event_t m_fallbackEvent;
 };
 
+struct HybrisDispatchEntry
+{
+    int                       m_sensorType;
+    QVector<HybrisAdaptor *>  m_adaptors;
+};
+
 class HybrisManager : public QObject
 {
     Q_OBJECT
@@ -223,6 +232,10 @@ public:
     int              getMaxDelay   (int handle) const;
     int              getDelay      (int handle) const;
     bool             setDelay      (int handle, int delay_us, bool force);
+    int              getFifoMaxEventCount(int handle) const;
+    int              getLatency    (int handle) const;
+    bool             setLatency    (int handle, int latency_us);
+    bool             flush         (int handle);
     bool             getActive     (int handle) const;
     bool             setActive     (int handle, bool active);
 
@@ -233,23 +246,29 @@ public:
     void startReader     (HybrisAdaptor *adaptor);
     void stopReader      (HybrisAdaptor *adaptor);
     void registerAdaptor (HybrisAdaptor * adaptor);
-    void processSample   (const sensors_event_t& data);
+    void unregisterAdaptor(HybrisAdaptor *adaptor);
+    void processSamples  (const sensors_event_t *data, int count);
 
     int queueEvents(const sensors_event_t *buffer, int numEvents);
+    sensors_event_t *reserveEvents(int numEvents, int &granted);
+    int commitEvents(const sensors_event_t *slots, int numEvents);
     bool typeRequiresWakeup(int type);
 
 private:
     // fields
     QMultiMap <int, HybrisAdaptor *>   m_registeredAdaptors; // type -> obj
+    QVector<HybrisDispatchEntry>  m_dispatchTable;        // one entry per registered type
+    QVector<int>                  m_dispatchIndexOfType;  // standard type -> m_dispatchTable index
 
     HybrisBackend                *m_backend;
     pthread_t                     m_eventReaderTid;
     HybrisSensorState            *m_sensorState;   // [m_sensorCount]
     QMap <int, int>               m_indexOfType;   // type   -> index
     QMap <int, int>               m_indexOfHandle; // handle -> index
-    int                           m_eventPipeReadFd;
-    int                           m_eventPipeWriteFd;
-    QSocketNotifier              *m_eventPipeNotifier;
+    SpscRing<sensors_event_t>    *m_eventRing;     // reader thread -> main thread
+    int                           m_eventRingFd;   // eventfd for waking up main thread
+    QSocketNotifier              *m_eventRingNotifier;
+    unsigned                      m_droppedEvents; // since the event ring got full, reader thread only
     QSet<int>                     m_doubleStopReaderQuirkSensorTypes;
 
     friend class HybrisAdaptorReader;
@@ -257,10 +276,15 @@ private:
 private:
     static void *eventReaderThread(void *aptr);
     float scaleSensorValue(const float value, const int type) const;
-    void initEventPipe();
-    void cleanupEventPipe();
-    void eventPipeWakeup(int fd);
+    void initEventRing();
+    void cleanupEventRing();
+    void eventRingWakeup(int fd);
     int processEvents(const sensors_event_t *buffer, int numEvents);
+    int checkEvents(const sensors_event_t *buffer, int numEvents, bool &errorInInput);
+    void signalEventRing();
+    void rateLimitErrors();
+    void rebuildDispatchTable();
+    const HybrisDispatchEntry *dispatchEntry(int sensorType) const;
 };
 
 class HybrisAdaptor : public DeviceAdaptor
@@ -288,6 +312,7 @@ public:
 
 protected:
     virtual void processSample(const sensors_event_t& data) = 0;
+    virtual void processSamples(const sensors_event_t *data, int count);
 
     qreal        minRange() const;
     qreal        maxRange() const;
@@ -300,13 +325,27 @@ protected:
     virtual bool setInterval(const int sessionId, const unsigned int interval_us);
     static bool writeToFile(const QByteArray& path, const QByteArray& content);
 
+public:
+    virtual IntegerRangeList getAvailableBufferSizes(bool& hwSupported) const;
+    virtual IntegerRangeList getAvailableBufferIntervals(bool& hwSupported) const;
+    virtual unsigned int bufferSize() const;
+    virtual unsigned int bufferInterval() const;
+
+protected:
+    virtual bool setBufferSize(unsigned int value);
+    virtual bool setBufferInterval(unsigned int interval_us);
+
 private:
+    bool updateReportLatency();
+
     bool          m_inStandbyMode;
     volatile bool m_isRunning;
     bool          m_shouldBeRunning;
 
     int           m_sensorHandle;
     int           m_sensorType;
+    unsigned int  m_bufferSize;
+    unsigned int  m_bufferInterval_us;
 };
 
 #endif // HYBRISADAPTOR_H
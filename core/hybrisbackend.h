@@ -61,8 +61,10 @@ public:
     virtual int minDelay(int index) = 0;
     virtual float maxRange(int index) = 0;
     virtual float resolution(int index) = 0;
+    virtual int fifoMaxEventCount(int index) = 0;
     virtual int setActive(int handle, bool active) = 0;
-    virtual int setDelay(int handle, int64_t delay_ns) = 0;
+    virtual int setDelay(int handle, int64_t delay_ns, int64_t latency_ns) = 0;
+    virtual int flush(int handle) = 0;
     virtual void readEvents() = 0;
 
 protected:
@@ -160,3 +160,8 @@ float HybrisBackendBinder::resolution(int index)
 {
     return m_sensorArray[index].resolution;
 }
+
+int HybrisBackendBinder::fifoMaxEventCount(int index)
+{
+    return m_sensorArray[index].fifoMaxEventCount;
+}
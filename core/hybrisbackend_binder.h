@@ -43,6 +43,7 @@ public:
     int minDelay(int index) override;
     float maxRange(int index) override;
     float resolution(int index) override;
+    int fifoMaxEventCount(int index) override;
 
 protected:
     GBinderClient         *m_client;
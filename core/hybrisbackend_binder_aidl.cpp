@@ -23,6 +23,7 @@
 
 #include "hybrisadaptor.h"
 #include "logging.h"
+#include "startuptrace.h"
 
 #include <QCoreApplication>
 
@@ -124,7 +125,7 @@ int HybrisBackendBinderAidl::setActive(int handle, bool active)
     return error;
 }
 
-int HybrisBackendBinderAidl::setDelay(int handle, int64_t delay_ns)
+int HybrisBackendBinderAidl::setDelay(int handle, int64_t delay_ns, int64_t latency_ns)
 {
     int error = 0;
     GBinderLocalRequest *req = gbinder_client_new_request2(m_client, BATCH);
@@ -137,7 +138,7 @@ int HybrisBackendBinderAidl::setDelay(int handle, int64_t delay_ns)
 
     gbinder_writer_append_int32(&writer, handle);
     gbinder_writer_append_int64(&writer, delay_ns);
-    gbinder_writer_append_int64(&writer, 0);
+    gbinder_writer_append_int64(&writer, latency_ns);
 
     reply = gbinder_client_transact_sync_reply(m_client, BATCH_AIDL, req, &status);
     gbinder_local_request_unref(req);
@@ -157,6 +158,54 @@ int HybrisBackendBinderAidl::setDelay(int handle, int64_t delay_ns)
     return error;
 }
 
+int HybrisBackendBinderAidl::flush(int handle)
+{
+    int error = 0;
+    GBinderLocalRequest *req = gbinder_client_new_request2(m_client, FLUSH_AIDL);
+    GBinderRemoteReply *reply;
+    GBinderReader reader;
+    GBinderWriter writer;
+    int32_t status;
+
+    gbinder_local_request_init_writer(req, &writer);
+
+    gbinder_writer_append_int32(&writer, handle);
+
+    reply = gbinder_client_transact_sync_reply(m_client, FLUSH_AIDL, req, &status);
+    gbinder_local_request_unref(req);
+
+    if (!reply || status != GBINDER_STATUS_OK) {
+        qCWarning(lcSensorFw) << "Flush failed";
+        return false;
+    }
+    gbinder_remote_reply_init_reader(reply, &reader);
+    gbinder_reader_read_int32(&reader, &status);
+    if (status) {
+        error = status;
+    }
+
+    gbinder_remote_reply_unref(reply);
+
+    return error;
+}
+
+void HybrisBackendBinderAidl::convertEvents(const sensors_event_t_aidl *aidl, sensors_event_t *events, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        events[i].timestamp = aidl[i].timestamp;
+        events[i].sensor = aidl[i].sensor;
+        events[i].type = aidl[i].type;
+        // AIDL struct is too big so copy manually when needed
+        if (events[i].type == SENSOR_TYPE_ADDITIONAL_INFO) {
+            events[i].u.additional.type = aidl[i].u.data.additional.type;
+            events[i].u.additional.serial = aidl[i].u.data.additional.serial;
+            events[i].u.additional.u = aidl[i].u.data.additional.u;
+        } else {
+            memcpy(&events[i].u, &aidl[i].u.data, sizeof(SensorEventPayload));
+        }
+    }
+}
+
 void HybrisBackendBinderAidl::readEvents()
 {
     sensors_event_t buffer[maxEvents];
@@ -190,23 +239,23 @@ void HybrisBackendBinderAidl::readEvents()
         return;
     }
 
-    for (unsigned int i = 0; i < numEvents; ++i) {
-        buffer[i].timestamp = aidl_buffer[i].timestamp;
-        buffer[i].sensor = aidl_buffer[i].sensor;
-        buffer[i].type = aidl_buffer[i].type;
-        // AIDL struct is too big so copy manually when needed
-        if (buffer[i].type == SENSOR_TYPE_ADDITIONAL_INFO) {
-            buffer[i].u.additional.type = aidl_buffer[i].u.data.additional.type;
-            buffer[i].u.additional.serial = aidl_buffer[i].u.data.additional.serial;
-            buffer[i].u.additional.u = aidl_buffer[i].u.data.additional.u;
-        } else {
-            memcpy(&buffer[i].u, &aidl_buffer[i].u.data, sizeof(SensorEventPayload));
+    // Convert events directly into the event ring, falling back to
+    // a local copy only if the ring is full
+    int wakeupEventCount = 0;
+    size_t converted = 0;
+    while (converted < numEvents) {
+        int granted;
+        sensors_event_t *slots = m_manager->reserveEvents(numEvents - converted, granted);
+        if (granted <= 0) {
+            convertEvents(aidl_buffer + converted, buffer, numEvents - converted);
+            wakeupEventCount += m_manager->queueEvents(buffer, numEvents - converted);
+            break;
         }
+        convertEvents(aidl_buffer + converted, slots, granted);
+        wakeupEventCount += m_manager->commitEvents(slots, granted);
+        converted += granted;
     }
 
-    // Queue received events for processing in main thread
-    int wakeupEventCount = m_manager->queueEvents(buffer, numEvents);
-
     // Acknowledge wakeup events
     if (wakeupEventCount) {
         if (gbinder_fmq_write(m_wakeLockQueue, &wakeupEventCount, 1)) {
@@ -250,6 +299,7 @@ GBinderLocalReply *HybrisBackendBinderAidl::sensorCallbackHandler(
 
 void HybrisBackendBinderAidl::getSensorList()
 {
+    StartupTrace::Scope trace("backend", "AIDL getSensorList");
     qCInfo(lcSensorFw) << "Get sensor list";
     GBinderReader reader;
     GBinderRemoteReply *reply;
@@ -311,6 +361,7 @@ void HybrisBackendBinderAidl::binderDied(GBinderRemoteObject *, void *)
 
 void HybrisBackendBinderAidl::startConnect()
 {
+    StartupTrace::Scope trace("backend", "AIDL startConnect");
     if (!m_serviceManager) {
         m_serviceManager = gbinder_servicemanager_new(SENSOR_BINDER_SERVICE_DEVICE);
     }
@@ -325,6 +376,7 @@ void HybrisBackendBinderAidl::startConnect()
 
 void HybrisBackendBinderAidl::finishConnect()
 {
+    StartupTrace::Scope trace("backend", "AIDL finishConnect");
     int initializeCode;
     m_remote = gbinder_servicemanager_get_service_sync(m_serviceManager,
                                     SENSOR_BINDER_SERVICE_NAME_AIDL, nullptr);
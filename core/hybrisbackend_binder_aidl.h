@@ -34,7 +34,8 @@ public:
     void initialize() override;
     bool needsReaderThread() override;
     int setActive(int handle, bool active) override;
-    int setDelay(int handle, int64_t delay_ns) override;
+    int setDelay(int handle, int64_t delay_ns, int64_t latency_ns) override;
+    int flush(int handle) override;
     void readEvents() override;
 
 protected:
@@ -49,6 +50,7 @@ protected:
     void startConnect();
     void finishConnect();
     static void binderDied(GBinderRemoteObject *, void *user_data);
+    static void convertEvents(const sensors_event_t_aidl *aidl, sensors_event_t *events, size_t count);
 };
 
 #endif // HYBRISBACKEND_BINDER_AIDL_H
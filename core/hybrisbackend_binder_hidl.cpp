@@ -23,6 +23,7 @@
 
 #include "hybrisadaptor.h"
 #include "logging.h"
+#include "startuptrace.h"
 
 #include <QCoreApplication>
 
@@ -181,7 +182,7 @@ int HybrisBackendBinderHidl::setActive(int handle, bool active)
     return error;
 }
 
-int HybrisBackendBinderHidl::setDelay(int handle, int64_t delay_ns)
+int HybrisBackendBinderHidl::setDelay(int handle, int64_t delay_ns, int64_t latency_ns)
 {
     int error;
     GBinderLocalRequest *req = gbinder_client_new_request2(m_client, BATCH);
@@ -194,7 +195,7 @@ int HybrisBackendBinderHidl::setDelay(int handle, int64_t delay_ns)
 
     gbinder_writer_append_int32(&writer, handle);
     gbinder_writer_append_int64(&writer, delay_ns);
-    gbinder_writer_append_int64(&writer, 0);
+    gbinder_writer_append_int64(&writer, latency_ns);
 
     reply = gbinder_client_transact_sync_reply(m_client, BATCH, req, &status);
     gbinder_local_request_unref(req);
@@ -212,6 +213,35 @@ int HybrisBackendBinderHidl::setDelay(int handle, int64_t delay_ns)
     return error;
 }
 
+int HybrisBackendBinderHidl::flush(int handle)
+{
+    int error;
+    GBinderLocalRequest *req = gbinder_client_new_request2(m_client, FLUSH);
+    GBinderRemoteReply *reply;
+    GBinderReader reader;
+    GBinderWriter writer;
+    int32_t status;
+
+    gbinder_local_request_init_writer(req, &writer);
+
+    gbinder_writer_append_int32(&writer, handle);
+
+    reply = gbinder_client_transact_sync_reply(m_client, FLUSH, req, &status);
+    gbinder_local_request_unref(req);
+
+    if (!reply || status != GBINDER_STATUS_OK) {
+        qCWarning(lcSensorFw) << "Flush failed";
+        return false;
+    }
+    gbinder_remote_reply_init_reader(reply, &reader);
+    gbinder_reader_read_int32(&reader, &status);
+    gbinder_reader_read_int32(&reader, &error);
+
+    gbinder_remote_reply_unref(reply);
+
+    return error;
+}
+
 /**
  * pollEvents is only called during initialization and after that from pollEventsCallback
  * triggered by binder reply so there is only maximum of one active poll at all times
@@ -342,6 +372,7 @@ GBinderLocalReply *HybrisBackendBinderHidl::sensorCallbackHandler(
 
 void HybrisBackendBinderHidl::getSensorList()
 {
+    StartupTrace::Scope trace("backend", "HIDL getSensorList");
     qCInfo(lcSensorFw) << "Get sensor list";
     GBinderReader reader;
     GBinderRemoteReply *reply;
@@ -414,6 +445,7 @@ void HybrisBackendBinderHidl::binderDied(GBinderRemoteObject *, void *)
 
 void HybrisBackendBinderHidl::startConnect()
 {
+    StartupTrace::Scope trace("backend", "HIDL startConnect");
     if (!m_serviceManager) {
         m_serviceManager = gbinder_servicemanager_new(SENSOR_BINDER_SERVICE_DEVICE);
     }
@@ -428,6 +460,7 @@ void HybrisBackendBinderHidl::startConnect()
 
 void HybrisBackendBinderHidl::finishConnect()
 {
+    StartupTrace::Scope trace("backend", "HIDL finishConnect");
     int initializeCode;
     m_remote = gbinder_servicemanager_get_service_sync(m_serviceManager,
                                     SENSOR_BINDER_SERVICE_NAME_2_1, nullptr);
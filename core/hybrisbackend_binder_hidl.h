@@ -34,7 +34,8 @@ public:
     void initialize() override;
     bool needsReaderThread() override;
     int setActive(int handle, bool active) override;
-    int setDelay(int handle, int64_t delay_ns) override;
+    int setDelay(int handle, int64_t delay_ns, int64_t latency_ns) override;
+    int flush(int handle) override;
     void readEvents() override;
 
 protected:
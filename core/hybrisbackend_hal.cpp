@@ -23,6 +23,7 @@
 
 #include "hybrisadaptor.h"
 #include "logging.h"
+#include "startuptrace.h"
 
 #include <QCoreApplication>
 #include <QObject>
@@ -62,6 +63,7 @@ HybrisBackendHal::~HybrisBackendHal()
 
 void HybrisBackendHal::initialize()
 {
+    StartupTrace::Scope trace("backend", "HAL initialize");
     int err;
 
     /* Open android sensor plugin */
@@ -234,6 +236,15 @@ float HybrisBackendHal::resolution(int index)
     return m_sensorArray[index].resolution;
 }
 
+int HybrisBackendHal::fifoMaxEventCount(int index)
+{
+#ifdef SENSORS_DEVICE_API_VERSION_1_1
+    if (m_halDevice->common.version >= SENSORS_DEVICE_API_VERSION_1_1)
+        return m_sensorArray[index].fifoMaxEventCount;
+#endif
+    return 0;
+}
+
 int HybrisBackendHal::setActive(int handle, bool active)
 {
     int error = m_halDevice->activate(&m_halDevice->v0, handle, active);
@@ -249,12 +260,12 @@ int HybrisBackendHal::setActive(int handle, bool active)
     return error;
 }
 
-int HybrisBackendHal::setDelay(int handle, int64_t delay_ns)
+int HybrisBackendHal::setDelay(int handle, int64_t delay_ns, int64_t latency_ns)
 {
     int error = EBADSLT;
     if (m_halDevice->common.version >= SENSORS_DEVICE_API_VERSION_1_0) {
         if (m_halDevice->batch)
-            error = m_halDevice->batch(m_halDevice, handle, 0, delay_ns, 0);
+            error = m_halDevice->batch(m_halDevice, handle, 0, delay_ns, latency_ns);
         else if (m_halDevice->setDelay)
             error = m_halDevice->setDelay(&m_halDevice->v0, handle, delay_ns);
     } else {
@@ -267,6 +278,18 @@ int HybrisBackendHal::setDelay(int handle, int64_t delay_ns)
     return error;
 }
 
+int HybrisBackendHal::flush(int handle)
+{
+    int error = EBADSLT;
+#ifdef SENSORS_DEVICE_API_VERSION_1_1
+    if (m_halDevice->common.version >= SENSORS_DEVICE_API_VERSION_1_1 && m_halDevice->flush)
+        error = m_halDevice->flush(m_halDevice, handle);
+#else
+    Q_UNUSED(handle);
+#endif
+    return error;
+}
+
 void HybrisBackendHal::readEvents()
 {
     sensors_event_t buffer[maxEvents];
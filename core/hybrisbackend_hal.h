@@ -43,8 +43,10 @@ public:
     int minDelay(int index) override;
     float maxRange(int index) override;
     float resolution(int index) override;
+    int fifoMaxEventCount(int index) override;
     int setActive(int handle, bool active) override;
-    int setDelay(int handle, int64_t delay_ns) override;
+    int setDelay(int handle, int64_t delay_ns, int64_t latency_ns) override;
+    int flush(int handle) override;
     void readEvents() override;
 
 private:
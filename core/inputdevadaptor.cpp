@@ -89,9 +89,9 @@ int InputDevAdaptor::getInputDevices(const QString& typeName)
         }
     }
 
-    QString pollConfigKey = QString(typeName + "/poll_file");
-    if (SensorFrameworkConfig::configuration()->exists(pollConfigKey)) {
-        m_usedDevicePollFilePath = SensorFrameworkConfig::configuration()->value<QString>(pollConfigKey, "");
+    QVariant pollFilePath = SensorFrameworkConfig::configuration()->value(typeName + "/poll_file");
+    if (pollFilePath.isValid()) {
+        m_usedDevicePollFilePath = pollFilePath.toString();
     } else {
         m_usedDevicePollFilePath = devicePollFilePath.arg(deviceNumber);
     }
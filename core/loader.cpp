@@ -29,23 +29,69 @@
 #include "loader.h"
 #include "plugin.h"
 #include <QPluginLoader>
+#include <QLibrary>
 #include <QStringList>
 #include <QList>
 #include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSettings>
+#include <QThread>
 #include <QCoreApplication>
 
 #include "logging.h"
 #include "config.h"
+#include "startuptrace.h"
+#include "datatypes/utils.h"
 
 #ifdef USE_SSUSYSINFO
 # include <ssusysinfo/ssusysinfo.h>
 #endif
 
+/**
+ * Thread loading plugin libraries without instantiating the plugins.
+ * Plugins are registered on the main thread, but the dynamic linking
+ * and relocation of their libraries can be done while the main thread
+ * sets up D-Bus. Libraries stay loaded when the QLibrary goes away.
+ */
+class PluginPreloader : public QThread
+{
+public:
+    explicit PluginPreloader(const QStringList &files)
+        : files_(files)
+    {
+    }
+
+protected:
+    void run() override
+    {
+        foreach (const QString &file, files_) {
+            StartupTrace::Scope trace("preload", QFileInfo(file).fileName());
+            QLibrary library(file);
+            library.setLoadHints(QLibrary::ExportExternalSymbolsHint);
+            if (!library.load()) {
+                qCWarning(lcSensorFw) << "Plugin preloading failed:" << library.errorString();
+            }
+        }
+    }
+
+private:
+    QStringList files_; /**< plugin libraries in load order */
+};
+
 Loader::Loader()
+    : manifest_(0)
+    , preloader_(0)
 {
     scanAvailablePlugins();
 }
 
+Loader::~Loader()
+{
+    waitForPreload();
+    delete manifest_;
+}
+
 Loader& Loader::instance()
 {
     static Loader the_loader;
@@ -82,12 +128,14 @@ bool Loader::loadPluginFile(const QString &name, QString &errorString, QStringLi
     PluginBase *plugin = 0;
     qCInfo(lcSensorFw) << "Loader loading plugin:" << resolvedName << "as:" << name << "from:" << qpl.fileName();
     bool loaded = false;
+    bool alreadyLoaded = loadedPluginNames_.contains(resolvedName);
+    quint64 start = Utils::getTimeStamp();
     bool cyclic = stack.contains(resolvedName);
     stack.prepend(resolvedName);
     if (cyclic) {
         errorString = "cyclic plugin dependency";
         qCCritical(lcSensorFw) << "Plugin has cyclic dependency:" << resolvedName;
-    } else if (loadedPluginNames_.contains(resolvedName)) {
+    } else if (alreadyLoaded) {
         qCInfo(lcSensorFw) << "Plugin is already loaded:" << resolvedName;
         loaded = true;
     } else if (!pluginAvailable(resolvedName)) {
@@ -115,12 +163,17 @@ bool Loader::loadPluginFile(const QString &name, QString &errorString, QStringLi
             plugin->Register(*this);
             loadedPluginNames_.append(resolvedName);
             plugin->Init(*this);
+            updateManifest(resolvedName, dependencies);
         }
     }
     stack.removeOne(resolvedName);
     if (!loaded) {
         invalidatePlugin(resolvedName);
     }
+    if (!alreadyLoaded) {
+        StartupTrace::record("plugin", loaded ? resolvedName : resolvedName + " (failed)",
+                             start, Utils::getTimeStamp());
+    }
     return loaded;
 }
 
@@ -128,6 +181,7 @@ bool Loader::loadPlugin(const QString& name, QString *errorString)
 {
     QString error;
     QStringList stack;
+    waitForPreload();
     bool loaded = loadPluginFile(name, error, stack);
     if (!loaded && errorString) {
         *errorString = error;
@@ -233,6 +287,97 @@ void Loader::invalidatePlugin(const QString &name)
     if (availablePluginNames_.removeAll(name) > 0) {
         qCWarning(lcSensorFw) << "plugin marked invalid: " << name;
     }
+    if (manifest_ && manifest_->childGroups().contains(name)) {
+        manifest_->remove(name);
+        manifest_->sync();
+    }
+}
+
+void Loader::preloadFromManifest(const QString &path)
+{
+    if (manifest_) {
+        qCWarning(lcSensorFw) << "Plugin manifest already in use:" << manifest_->fileName();
+        return;
+    }
+    manifest_ = new QSettings(path, QSettings::IniFormat);
+    if (manifest_->status() != QSettings::NoError) {
+        qCWarning(lcSensorFw) << "Plugin manifest" << path << "is not readable, rebuilding it";
+        manifest_->clear();
+    }
+
+    QStringList files;
+    QStringList visited;
+    foreach (const QString &name, manifest_->childGroups()) {
+        collectPreload(name, files, visited);
+    }
+    if (files.isEmpty())
+        return;
+
+    qCInfo(lcSensorFw) << "Preloading" << files.size() << "plugins from manifest" << path;
+    preloader_ = new PluginPreloader(files);
+    preloader_->start();
+}
+
+bool Loader::collectPreload(const QString &name, QStringList &files, QStringList &visited) const
+{
+    const QString path(getPluginPath(name));
+    if (visited.contains(name))
+        return files.contains(path);
+    visited.append(name);
+
+    if (!pluginAvailable(name) || loadedPluginNames_.contains(name))
+        return false;
+
+    QFileInfo info(path);
+    manifest_->beginGroup(name);
+    bool unchanged = info.exists()
+        && manifest_->value("size").toLongLong() == info.size()
+        && manifest_->value("modified").toLongLong() == info.lastModified().toMSecsSinceEpoch();
+    QStringList dependencies(manifest_->value("dependencies").toStringList());
+    manifest_->endGroup();
+    if (!unchanged) {
+        qCInfo(lcSensorFw) << "Plugin changed since manifest was written:" << name;
+        return false;
+    }
+
+    /* Dependencies must be loaded first for the symbols they export */
+    foreach (const QString &dependency, dependencies) {
+        const QString resolved(resolveRealPluginName(dependency));
+        if (!loadedPluginNames_.contains(resolved) && !collectPreload(resolved, files, visited))
+            return false;
+    }
+    files.append(path);
+    return true;
+}
+
+void Loader::waitForPreload()
+{
+    if (preloader_) {
+        preloader_->wait();
+        delete preloader_;
+        preloader_ = 0;
+    }
+}
+
+void Loader::updateManifest(const QString &name, const QStringList &dependencies)
+{
+    if (!manifest_)
+        return;
+
+    QFileInfo info(getPluginPath(name));
+    qlonglong modified = info.lastModified().toMSecsSinceEpoch();
+    manifest_->beginGroup(name);
+    bool changed = manifest_->value("size").toLongLong() != info.size()
+        || manifest_->value("modified").toLongLong() != modified
+        || manifest_->value("dependencies").toStringList() != dependencies;
+    if (changed) {
+        manifest_->setValue("size", info.size());
+        manifest_->setValue("modified", modified);
+        manifest_->setValue("dependencies", dependencies);
+    }
+    manifest_->endGroup();
+    if (changed)
+        manifest_->sync();
 }
 
 QString Loader::resolveRealPluginName(const QString& pluginName) const
@@ -32,6 +32,9 @@
 #include <QStringList>
 #include "plugin.h"
 
+class QSettings;
+class PluginPreloader;
+
 /**
  * Utility to load plugins. Class uses singleton-pattern.
  */
@@ -76,8 +79,21 @@ public:
      */
     QStringList availableSensorPlugins() const;
 
+    /**
+     * Use plugin manifest stored in given path. Plugins loaded during
+     * earlier runs are listed in the manifest with their dependencies.
+     * Libraries of those still available and unchanged are loaded on a
+     * worker thread, dependencies first, so that loading them later
+     * only needs to instantiate and register them. The manifest is
+     * updated as plugins get loaded.
+     *
+     * @param path manifest file path.
+     */
+    void preloadFromManifest(const QString &path);
+
 private:
     Loader();
+    ~Loader();
     Loader(const Loader&);
     Loader& operator=(const Loader&);
 
@@ -92,6 +108,29 @@ private:
 
     void invalidatePlugin(const QString &name);
 
+    /**
+     * Wait until preloading of plugin libraries has finished.
+     */
+    void waitForPreload();
+
+    /**
+     * Add plugin libraries to preload list, dependencies first.
+     *
+     * @param name plugin name.
+     * @param files list to add library paths to.
+     * @param visited plugins already processed.
+     * @return can the plugin be preloaded.
+     */
+    bool collectPreload(const QString &name, QStringList &files, QStringList &visited) const;
+
+    /**
+     * Record loaded plugin in the manifest.
+     *
+     * @param name plugin name.
+     * @param dependencies dependencies of the plugin.
+     */
+    void updateManifest(const QString &name, const QStringList &dependencies);
+
     /**
      * Resolve plugin name.
      *
@@ -104,6 +143,10 @@ private:
 
     QStringList availablePluginNames_; /**< list of loaded plugins */
 
+    QSettings *manifest_; /**< manifest of plugins loaded in earlier runs */
+
+    PluginPreloader *preloader_; /**< thread loading plugin libraries */
+
     void scanAvailablePlugins();
 };
 
@@ -29,12 +29,20 @@
 #include "ringbuffer.h"
 #include "config.h"
 
+/** Largest integer fraction of the fastest request tried as HW interval. */
+static const unsigned int maxIntervalDivisor = 8;
+
+/** Default accepted deviation (%) of a decimated rate from the requested one. */
+static const int defaultIntervalTolerance = 10;
+
 NodeBase::NodeBase(const QString& id, QObject* parent) :
     QObject(parent),
     m_dataRangeSource(nullptr),
     m_intervalSource(nullptr),
     m_hasDefault(false),
     m_defaultInterval_us(0),
+    m_intervalTolerance(qMax(0, SensorFrameworkConfig::configuration()->value<int>("global/interval_tolerance",
+                                                                                   defaultIntervalTolerance))),
     m_id(id),
     m_isValid(false)
 {
@@ -289,10 +297,15 @@ unsigned int NodeBase::getInterval(int sessionId) const
 }
 
 bool NodeBase::setIntervalRequest(const int sessionId, const unsigned int interval_us)
+{
+    return setIntervalRequest(sessionId, interval_us, decimatesInterval(sessionId));
+}
+
+bool NodeBase::setIntervalRequest(const int sessionId, const unsigned int interval_us, const bool decimated)
 {
     // Has single defined source, pass the request that way
     if (!hasLocalInterval()) {
-        return m_intervalSource->setIntervalRequest(sessionId, interval_us);
+        return m_intervalSource->setIntervalRequest(sessionId, interval_us, decimated);
     }
 
     // Validate interval request
@@ -300,6 +313,10 @@ bool NodeBase::setIntervalRequest(const int sessionId, const unsigned int interv
 
     // Store the request for the session
     m_intervalMap[sessionId] = validatedInterval_us;
+    if (decimated)
+        m_decimatedSessions.insert(sessionId);
+    else
+        m_decimatedSessions.remove(sessionId);
 
     // Store the current interval
     unsigned int previousInterval = interval();
@@ -402,11 +419,60 @@ unsigned int NodeBase::evaluateIntervalRequests(int& sessionId) const
     }
     if (chosenInterval_us == 0)
         chosenInterval_us = defaultInterval();
+    else
+        chosenInterval_us = planInterval(chosenInterval_us);
 
     sessionId = chosenSessionId;
     return chosenInterval_us;
 }
 
+unsigned int NodeBase::planInterval(unsigned int smallest_us) const
+{
+    // Sessions which are not decimated would get every sample
+    for (QMap<int, unsigned int>::const_iterator it = m_intervalMap.constBegin(); it != m_intervalMap.constEnd(); ++it) {
+        if (it.value() > 0 && !m_decimatedSessions.contains(it.key()))
+            return smallest_us;
+    }
+
+    // Slowest HW interval from which every session can be served by
+    // decimation. Only integer fractions of the fastest request are tried,
+    // so the first match is also the one with the lowest sensor rate.
+    for (unsigned int divisor = 1; divisor <= maxIntervalDivisor; ++divisor) {
+        unsigned int candidate_us = smallest_us / divisor;
+        if (candidate_us == 0 || validateIntervalRequest(candidate_us) != candidate_us)
+            continue;
+
+        bool matches = true;
+        for (QMap<int, unsigned int>::const_iterator it = m_intervalMap.constBegin(); matches && it != m_intervalMap.constEnd(); ++it) {
+            if (it.value() == 0)
+                continue;
+            quint64 decimated_us = (quint64)decimationFactor(it.value(), candidate_us) * candidate_us;
+            quint64 error_us = decimated_us > it.value() ? decimated_us - it.value() : it.value() - decimated_us;
+            matches = error_us * 100 <= (quint64)it.value() * m_intervalTolerance;
+        }
+        if (matches) {
+            if (divisor > 1)
+                qCInfo(lcSensorFw) << id() << "Running at" << candidate_us << "us to serve interval requests"
+                                   << m_intervalMap.values() << "by decimation";
+            return candidate_us;
+        }
+    }
+    return smallest_us;
+}
+
+bool NodeBase::decimatesInterval(int sessionId) const
+{
+    Q_UNUSED(sessionId);
+    return false;
+}
+
+unsigned int NodeBase::decimationFactor(unsigned int sessionInterval_us, unsigned int interval_us)
+{
+    if (interval_us == 0 || sessionInterval_us <= interval_us)
+        return 1;
+    return (sessionInterval_us + interval_us / 2) / interval_us;
+}
+
 unsigned int NodeBase::defaultInterval() const
 {
     return m_defaultInterval_us;
@@ -456,6 +522,7 @@ void NodeBase::removeIntervalRequest(const int sessionId)
         if (m_intervalMap.keys().contains(sessionId)) {
             m_intervalMap.remove(sessionId);
         }
+        m_decimatedSessions.remove(sessionId);
 
         // Re-evaluate local setting
         int winningSessionId;
@@ -581,25 +648,48 @@ bool NodeBase::setBufferSize(int sessionId, unsigned int value)
     if (!isInRange(value, getAvailableBufferSizes(hwbuffering)))
         return false;
     m_bufferSizeMap.insert(sessionId, value);
-    return updateBufferSize();
+
+    /* Hardware buffering is done by the adaptor at the bottom of the
+     * chain -> pass the request down to sources supporting it. */
+    bool handled = false;
+    bool success = false;
+    foreach (NodeBase* source, m_sourceList) {
+        bool sourceHwBuffering = false;
+        source->getAvailableBufferSizes(sourceHwBuffering);
+        if (sourceHwBuffering) {
+            handled = true;
+            success = source->setBufferSize(sessionId, value) || success;
+        }
+    }
+    return handled ? success : updateBuffering();
 }
 
 bool NodeBase::clearBufferSize(int sessionId)
 {
     int index = m_bufferSizeMap.remove(sessionId);
-    updateBufferSize();
+    bool handled = false;
+    foreach (NodeBase* source, m_sourceList) {
+        bool sourceHwBuffering = false;
+        source->getAvailableBufferSizes(sourceHwBuffering);
+        if (sourceHwBuffering) {
+            handled = true;
+            source->clearBufferSize(sessionId);
+        }
+    }
+    if (!handled)
+        updateBuffering();
     return index != 0;
 }
 
 bool NodeBase::updateBufferSize()
 {
-    int key = 0;
-    int value = 0;
-    for (QMap<int, unsigned int>::const_iterator it = m_bufferSizeMap.constBegin();
-         it != m_bufferSizeMap.constEnd(); ++it) {
-        if (it.key() >= key) {
-            key = it.key();
-            value = it.value();
+    /* No session may wait for more samples than it asked for */
+    unsigned int value = 0;
+    if (!hasUnbufferedSession()) {
+        for (QMap<int, unsigned int>::const_iterator it = m_bufferSizeMap.constBegin();
+             it != m_bufferSizeMap.constEnd(); ++it) {
+            if (it.value() > 1 && (!value || it.value() < value))
+                value = it.value();
         }
     }
     if (setBufferSize(value)) {
@@ -615,27 +705,47 @@ bool NodeBase::setBufferInterval(int sessionId, unsigned int interval_us)
     if (!isInRange(interval_us, getAvailableBufferIntervals(hwbuffering)))
         return false;
     m_bufferIntervalMap.insert(sessionId, interval_us);
-    return updateBufferInterval();
+
+    /* See setBufferSize() */
+    bool handled = false;
+    bool success = false;
+    foreach (NodeBase* source, m_sourceList) {
+        bool sourceHwBuffering = false;
+        source->getAvailableBufferIntervals(sourceHwBuffering);
+        if (sourceHwBuffering) {
+            handled = true;
+            success = source->setBufferInterval(sessionId, interval_us) || success;
+        }
+    }
+    return handled ? success : updateBuffering();
 }
 
 bool NodeBase::clearBufferInterval(int sessionId)
 {
     int index = m_bufferIntervalMap.remove(sessionId);
-    updateBufferInterval();
+    bool handled = false;
+    foreach (NodeBase* source, m_sourceList) {
+        bool sourceHwBuffering = false;
+        source->getAvailableBufferIntervals(sourceHwBuffering);
+        if (sourceHwBuffering) {
+            handled = true;
+            source->clearBufferInterval(sessionId);
+        }
+    }
+    if (!handled)
+        updateBuffering();
     return index != 0;
 }
 
 bool NodeBase::updateBufferInterval()
 {
-    int key = 0;
-    int value = 0;
-    for (QMap<int, unsigned int>::const_iterator it = m_bufferIntervalMap.constBegin();
-         it != m_bufferIntervalMap.constEnd(); ++it) {
-        // XXX: key is sessionId -> use value for latest client,
-        //      whatever they may be in relation to others. really?
-        if (it.key() >= key) {
-            key = it.key();
-            value = it.value();
+    /* No session may wait longer than it asked for */
+    unsigned int value = 0;
+    if (!hasUnbufferedSession()) {
+        for (QMap<int, unsigned int>::const_iterator it = m_bufferIntervalMap.constBegin();
+             it != m_bufferIntervalMap.constEnd(); ++it) {
+            if (it.value() > 0 && (!value || it.value() < value))
+                value = it.value();
         }
     }
     /* From doc/PLUGIN-GUIDE:
@@ -657,6 +767,56 @@ bool NodeBase::updateBufferInterval()
     return false;
 }
 
+bool NodeBase::updateBuffering()
+{
+    /* Size and interval both depend on whether some session is not
+     * buffered, so a change to either re-evaluates both */
+    bool success = true;
+    bool hwBuffering = false;
+    getAvailableBufferSizes(hwBuffering);
+    if (hwBuffering)
+        success = updateBufferSize();
+    hwBuffering = false;
+    getAvailableBufferIntervals(hwBuffering);
+    if (hwBuffering)
+        success = updateBufferInterval() && success;
+    return success;
+}
+
+bool NodeBase::hasUnbufferedSession() const
+{
+    foreach (int sessionId, m_bufferSessions) {
+        if (m_bufferSizeMap.value(sessionId, 0) <= 1 && m_bufferIntervalMap.value(sessionId, 0) == 0)
+            return true;
+    }
+    return false;
+}
+
+void NodeBase::setBufferSessionActive(int sessionId, bool active)
+{
+    if (active == m_bufferSessions.contains(sessionId))
+        return;
+    if (active)
+        m_bufferSessions.insert(sessionId);
+    else
+        m_bufferSessions.remove(sessionId);
+
+    /* See setBufferSize() */
+    bool handled = false;
+    foreach (NodeBase* source, m_sourceList) {
+        bool sourceHwBuffering = false;
+        source->getAvailableBufferSizes(sourceHwBuffering);
+        if (!sourceHwBuffering)
+            source->getAvailableBufferIntervals(sourceHwBuffering);
+        if (sourceHwBuffering) {
+            handled = true;
+            source->setBufferSessionActive(sessionId, active);
+        }
+    }
+    if (!handled)
+        updateBuffering();
+}
+
 bool NodeBase::setDataRangeIndex(int sessionId, int rangeIndex)
 {
     if (rangeIndex < 0)
@@ -674,6 +834,7 @@ void NodeBase::removeSession(int sessionId)
     setStandbyOverrideRequest(sessionId, false);
     removeIntervalRequest(sessionId);
     removeDataRangeRequest(sessionId);
+    setBufferSessionActive(sessionId, false);
     clearBufferSize(sessionId);
     clearBufferInterval(sessionId);
 }
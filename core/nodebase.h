@@ -30,6 +30,7 @@
 #include <QObject>
 #include <QString>
 #include <QList>
+#include <QSet>
 #include "datarange.h"
 #include "logging.h"
 
@@ -221,6 +222,16 @@ public Q_SLOTS:
      */
     unsigned int getInterval(int sessionId) const;
 
+    /**
+     * Number of samples at \a interval_us averaged into one sample for a
+     * session requesting \a sessionInterval_us, rounded to the nearest.
+     *
+     * @param sessionInterval_us interval requested by the session.
+     * @param interval_us interval of the node.
+     * @return decimation factor, at least 1.
+     */
+    static unsigned int decimationFactor(unsigned int sessionInterval_us, unsigned int interval_us);
+
     /**
      * Returns list of available buffer sizes. The list is ordered by
      * efficiency of the size.
@@ -286,6 +297,16 @@ public Q_SLOTS:
      */
     bool clearBufferInterval(int sessionId);
 
+    /**
+     * Tell whether given session is running. Buffering is shared by the
+     * sessions, and running sessions without buffer requests need every
+     * sample right away.
+     *
+     * @param sessionId Session ID.
+     * @param active is the session running.
+     */
+    void setBufferSessionActive(int sessionId, bool active);
+
     /**
      * Removes session related associates from the node.
      *
@@ -446,8 +467,10 @@ protected:
      * setDefaultInterval()) is returned.
      *
      * This implementation considers smallest non-negative interval request
-     * as the winner. Reimplement for nodes that need to use different
-     * approach.
+     * as the winner, unless the requests are not multiples of it and all
+     * sessions are decimated. In that case the interval is lowered to a
+     * fraction of it chosen by planInterval(). Reimplement for nodes that
+     * need to use different approach.
      *
      * <b>Note that this approach has been considered 'proper' by design.
      * Consider carefully what the consequences may be for other parts of
@@ -460,6 +483,39 @@ protected:
      */
     virtual unsigned int evaluateIntervalRequests(int& sessionId) const;
 
+    /**
+     * Choose interval for serving all requests when the fastest one is
+     * \a smallest_us. The slowest integer fraction of it which is listed by
+     * getAvailableIntervals() and from which every request can be reached
+     * by decimation within \c global/interval_tolerance percent is used.
+     * Running faster than \a smallest_us is only considered when every
+     * requesting session is decimated, others would get all the samples.
+     *
+     * @param smallest_us smallest positive interval request.
+     * @return interval to use, \a smallest_us if no better one is found.
+     */
+    unsigned int planInterval(unsigned int smallest_us) const;
+
+    /**
+     * Are samples delivered to the session decimated to its requested
+     * interval. Sensor channels reimplement this to report their
+     * downsampling state.
+     *
+     * @param sessionId Session ID.
+     * @return is output for the session decimated.
+     */
+    virtual bool decimatesInterval(int sessionId) const;
+
+    /**
+     * Store interval request, see setIntervalRequest(int, unsigned int).
+     *
+     * @param sessionId Session ID.
+     * @param interval_us interval value in microseconds.
+     * @param decimated is output for the session decimated.
+     * @return was request succesful.
+     */
+    bool setIntervalRequest(int sessionId, unsigned int interval_us, bool decimated);
+
     /**
      * Node to fetch interval from
      *
@@ -511,6 +567,7 @@ protected:
     virtual bool setBufferInterval(unsigned int interval_us);
 
     QMap<int, unsigned int> m_intervalMap;    /**< active interval requests for sessions */
+    QSet<int>               m_decimatedSessions; /**< requesting sessions which are decimated */
 
 private:
     /**
@@ -522,12 +579,28 @@ private:
     bool hasLocalRange() const;
 
     /**
-     * Re-evaluate buffer size for the node.
+     * Re-evaluate buffer size for the node. The smallest request wins,
+     * unless a running session does not buffer at all.
      *
      * @return was buffer size changed.
      */
     bool updateBufferSize();
 
+    /**
+     * Re-evaluate buffer size and interval, whichever the node handles.
+     *
+     * @return were the re-evaluated values set successfully.
+     */
+    bool updateBuffering();
+
+    /**
+     * Is there a running session without buffer size or interval
+     * request.
+     *
+     * @return does some session need every sample right away.
+     */
+    bool hasUnbufferedSession() const;
+
     /**
      * Parse data range list from given text input.
      *
@@ -538,7 +611,8 @@ private:
     DataRangeList parseDataRangeList(const QString& input, int defaultResolution) const;
 
     /**
-     * Re-evaluate buffer interval for the node.
+     * Re-evaluate buffer interval for the node. The shortest request
+     * wins, unless a running session does not buffer at all.
      *
      * @return was buffer interval changed.
      */
@@ -556,12 +630,14 @@ private:
     NodeBase*               m_intervalSource; /**< interval sources */
     bool                    m_hasDefault;     /**< does node have locally set interval */
     unsigned int            m_defaultInterval_us; /**< locally set interval */
+    int                     m_intervalTolerance; /**< allowed decimation error in percent */
 
     QList<NodeBase*>        m_sourceList; /**< source nodes */
 
     //Oldest session wins for these:
     QMap<int, unsigned int> m_bufferSizeMap; /**< buffersize requests for sessions. */
     QMap<int, unsigned int> m_bufferIntervalMap; /**< buffer interval requests for sessions. */
+    QSet<int>               m_bufferSessions; /**< running sessions sharing the buffering */
 
     QString                 m_id; /**< node ID */
     bool                    m_isValid; /**< is node correctly initialized */
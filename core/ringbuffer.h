@@ -33,7 +33,8 @@
 #include "sink.h"
 #include "pusher.h"
 #include "logging.h"
-#include <QSet>
+#include <QVector>
+#include <algorithm>
 
 template <class TYPE>
 class RingBuffer;
@@ -116,6 +117,24 @@ public:
      */
     bool unjoin(RingBufferReaderBase* reader);
 
+    /**
+     * Capacity of the buffer.
+     *
+     * @return number of objects which fit into buffer.
+     */
+    virtual unsigned size() const = 0;
+
+    /**
+     * Start a batch of writes. Reader wakeups are deferred until the
+     * matching endBatch(). Batches may nest.
+     */
+    virtual void beginBatch() = 0;
+
+    /**
+     * End a batch of writes and wake up readers if anything was written.
+     */
+    virtual void endBatch() = 0;
+
 private:
     /**
      * Connect reader to this buffer.
@@ -137,6 +156,16 @@ private:
 /**
  * Ring buffer implementation.
  *
+ * Capacity is rounded up to a power of two so slots are located with a
+ * mask instead of a division. Reads and writes copy in at most two
+ * contiguous spans, which std::copy turns into memmove for trivially
+ * copyable types. Producers can also decode directly into the buffer
+ * with reserve() and commit(unsigned).
+ *
+ * Reader wakeups are skipped when nothing was written since the previous
+ * wakeup, and are deferred to endBatch() while a batch is open, so
+ * several writes within one dispatch wake readers only once.
+ *
  * @tparam TYPE data type in buffer.
  */
 template <class TYPE>
@@ -146,14 +175,18 @@ public:
     /**
      * Constructor.
      *
-     * @param size how many elements can be buffered.
+     * @param size how many elements can be buffered. Rounded up to
+     *             the next power of two.
      */
     RingBuffer(unsigned size) :
         sink_(this, &RingBuffer::write),
-        bufferSize_(size),
-        writeCount_()
+        bufferSize_(roundUpToPowerOfTwo(size)),
+        mask_(bufferSize_ - 1),
+        writeCount_(0),
+        wakeupCount_(0),
+        batchDepth_(0)
     {
-        buffer_ = new TYPE[size];
+        buffer_ = new TYPE[bufferSize_];
         addSink(&sink_, "sink");
     }
 
@@ -166,7 +199,8 @@ public:
     }
 
     /**
-     * Read data from buffer.
+     * Read data from buffer. A reader which has fallen behind by more
+     * than the buffer size skips the overwritten objects.
      *
      * @param n how many objects try to read.
      * @param values location to write objects.
@@ -177,15 +211,32 @@ public:
                   TYPE*                   values,
                   RingBufferReader<TYPE>& reader) const
     {
-        unsigned itemsRead = 0;
-        while (itemsRead < n && reader.readCount_ != (unsigned)writeCount_) {
+        unsigned available = writeCount_ - reader.readCount_;
+        if (available > bufferSize_) {
+            qCWarning(lcSensorFw) << "Ringbuffer reader overrun, skipping" << available - bufferSize_ << "objects";
+            reader.readCount_ = writeCount_ - bufferSize_;
+            available = bufferSize_;
+        }
 
-            *values++ = buffer_[reader.readCount_++ % bufferSize_];
+        unsigned count = qMin(n, available);
+        unsigned start = reader.readCount_ & mask_;
+        unsigned first = qMin(count, bufferSize_ - start);
 
-            ++itemsRead;
-        }
+        std::copy(buffer_ + start, buffer_ + start + first, values);
+        std::copy(buffer_, buffer_ + (count - first), values + first);
 
-        return itemsRead;
+        reader.readCount_ += count;
+        return count;
+    }
+
+    /**
+     * Capacity of the buffer.
+     *
+     * @return number of objects which fit into buffer.
+     */
+    unsigned size() const
+    {
+        return bufferSize_;
     }
 
 protected:
@@ -196,7 +247,23 @@ protected:
      */
     TYPE* nextSlot()
     {
-        return &buffer_[writeCount_ % bufferSize_];
+        return &buffer_[writeCount_ & mask_];
+    }
+
+    /**
+     * Reserve contiguous slots for writing. The span ends at the end of
+     * the underlying storage, so fewer slots than requested may be
+     * granted. Written slots are published with commit(unsigned).
+     *
+     * @param n how many slots are wanted.
+     * @param granted set to number of slots available in the span.
+     * @return first slot of the span.
+     */
+    TYPE* reserve(unsigned n, unsigned& granted)
+    {
+        unsigned start = writeCount_ & mask_;
+        granted = qMin(n, bufferSize_ - start);
+        return &buffer_[start];
     }
 
     /**
@@ -208,13 +275,45 @@ protected:
     }
 
     /**
-     * Wake up connected buffer readers.
+     * Publish given number of objects written into reserved slots.
+     *
+     * @param n number of objects written.
+     */
+    void commit(unsigned n)
+    {
+        writeCount_ += n;
+    }
+
+    /**
+     * Start a batch of writes. Reader wakeups are deferred until the
+     * matching endBatch(). Batches may nest.
+     */
+    void beginBatch()
+    {
+        ++batchDepth_;
+    }
+
+    /**
+     * End a batch of writes and wake up readers if anything was written.
+     */
+    void endBatch()
+    {
+        if (batchDepth_ && !--batchDepth_)
+            wakeUpReaders();
+    }
+
+    /**
+     * Wake up connected buffer readers if new objects have been written
+     * since the previous wakeup.
      */
     void wakeUpReaders()
     {
-        RingBufferReader<TYPE>* reader;
-        foreach (reader, readers_) {
-            reader->wakeup();
+        if (batchDepth_ || wakeupCount_ == writeCount_)
+            return;
+        wakeupCount_ = writeCount_;
+
+        for (int i = 0; i < readers_.size(); ++i) {
+            readers_.at(i)->wakeup();
         }
     }
 
@@ -226,11 +325,20 @@ protected:
      */
     void write(unsigned n, const TYPE* values)
     {
-        // buffer incoming data
+        // Only the newest bufferSize_ objects can be held
+        if (n > bufferSize_) {
+            writeCount_ += n - bufferSize_;
+            values += n - bufferSize_;
+            n = bufferSize_;
+        }
+
         while (n) {
-            *nextSlot() = *values++;
-            commit();
-            --n;
+            unsigned granted;
+            TYPE* slot = reserve(n, granted);
+            std::copy(values, values + granted, slot);
+            commit(granted);
+            values += granted;
+            n -= granted;
         }
         wakeUpReaders();
     }
@@ -253,7 +361,8 @@ protected:
         r->readCount_ = writeCount_;
         r->buffer_    = this;
 
-        readers_.insert(r);
+        if (!readers_.contains(r))
+            readers_.append(r);
         return true;
     }
 
@@ -270,17 +379,33 @@ protected:
             return false;
         }
 
-        readers_.remove(r);
+        readers_.removeAll(r);
         return true;
     }
 
 private:
+    /**
+     * Round value up to the next power of two.
+     *
+     * @param value value to round, zero is treated as one.
+     * @return power of two not smaller than value.
+     */
+    static unsigned roundUpToPowerOfTwo(unsigned value)
+    {
+        unsigned size = 1;
+        while (size < value)
+            size <<= 1;
+        return size;
+    }
 
-    Sink<RingBuffer, TYPE>        sink_;       /**< data sink */
-    const unsigned                bufferSize_; /**< buffer size */
-    TYPE*                         buffer_;     /**< buffer */
-    unsigned int                  writeCount_; /**< how many objects have been written */
-    QSet<RingBufferReader<TYPE>*> readers_;    /**< connected readers */
+    Sink<RingBuffer, TYPE>           sink_;        /**< data sink */
+    const unsigned                   bufferSize_;  /**< buffer size, power of two */
+    const unsigned                   mask_;        /**< index mask */
+    TYPE*                            buffer_;      /**< buffer */
+    unsigned int                     writeCount_;  /**< how many objects have been written */
+    unsigned int                     wakeupCount_; /**< writeCount_ at previous wakeup */
+    unsigned int                     batchDepth_;  /**< nesting level of open batches */
+    QVector<RingBufferReader<TYPE>*> readers_;     /**< connected readers */
 };
 
 #endif
@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (c) 2026 Jolla Mobile Ltd
+**
+**
+** $QT_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "samplestagingarea.h"
+#include "sockethandler.h"
+#include "logging.h"
+#include "datatypes/utils.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+const int recordAlignment = 8;
+}
+
+SampleStagingArea::SampleStagingArea(int capacity, int maxCapacity)
+    : m_pending(0)
+    , m_maxCapacity(maxCapacity)
+    , m_eventFd(-1)
+    , m_dropped(0)
+    , m_stampInterval(0)
+    , m_sinceStamp(0)
+{
+    for (int i = 0; i < 2; ++i) {
+        m_arenas[i].data = static_cast<char*>(malloc(capacity));
+        m_arenas[i].used = 0;
+        m_arenas[i].capacity = m_arenas[i].data ? capacity : 0;
+    }
+
+    m_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_eventFd == -1)
+        qCCritical(lcSensorFw) << "Failed to create eventfd: " << strerror(errno);
+}
+
+SampleStagingArea::~SampleStagingArea()
+{
+    if (m_eventFd != -1)
+        close(m_eventFd);
+    for (int i = 0; i < 2; ++i)
+        free(m_arenas[i].data);
+}
+
+bool SampleStagingArea::isValid() const
+{
+    return m_eventFd != -1 && m_arenas[0].capacity && m_arenas[1].capacity;
+}
+
+int SampleStagingArea::notifyFd() const
+{
+    return m_eventFd;
+}
+
+void SampleStagingArea::setStampInterval(unsigned int interval)
+{
+    QMutexLocker locker(&m_mutex);
+    m_stampInterval = interval;
+    m_sinceStamp = 0;
+}
+
+unsigned int SampleStagingArea::dropped() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_dropped;
+}
+
+int SampleStagingArea::recordSize(int size)
+{
+    int bytes = sizeof(Record) + size;
+    return (bytes + recordAlignment - 1) & ~(recordAlignment - 1);
+}
+
+bool SampleStagingArea::reserve(Arena& arena, int bytes)
+{
+    if (arena.used + bytes <= arena.capacity)
+        return true;
+
+    int capacity = arena.capacity ? arena.capacity : recordAlignment;
+    while (capacity < arena.used + bytes)
+        capacity *= 2;
+    if (capacity > m_maxCapacity)
+        return false;
+
+    char* data = static_cast<char*>(realloc(arena.data, capacity));
+    if (!data) {
+        qCCritical(lcSensorFw) << "Failed to grow sample staging arena to" << capacity << "bytes";
+        return false;
+    }
+    qCDebug(lcSensorFw) << "Sample staging arena grown to" << capacity << "bytes";
+    arena.data = data;
+    arena.capacity = capacity;
+    return true;
+}
+
+bool SampleStagingArea::write(int sessionId, const void* source, int size)
+{
+    if (size < 0)
+        return false;
+
+    int bytes = recordSize(size);
+    bool wasEmpty;
+    {
+        QMutexLocker locker(&m_mutex);
+        Arena& arena = m_arenas[m_pending];
+        if (!reserve(arena, bytes)) {
+            if (!m_dropped++)
+                qCWarning(lcSensorFw) << "Sample staging arena full, dropping samples";
+            return false;
+        }
+
+        Record* record = reinterpret_cast<Record*>(arena.data + arena.used);
+        record->sessionId = sessionId;
+        record->size = size;
+        record->staged = 0;
+        if (m_stampInterval && ++m_sinceStamp >= m_stampInterval) {
+            m_sinceStamp = 0;
+            record->staged = Utils::getTimeStamp();
+        }
+        memcpy(record + 1, source, size);
+
+        wasEmpty = (arena.used == 0);
+        arena.used += bytes;
+    }
+
+    if (wasEmpty) {
+        uint64_t one = 1;
+        if (::write(m_eventFd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+            qCWarning(lcSensorFw) << "Failed to signal sample staging eventfd: " << strerror(errno);
+            return false;
+        }
+    }
+    return true;
+}
+
+int SampleStagingArea::drain(SocketHandler& socketHandler)
+{
+    uint64_t counter;
+    if (::read(m_eventFd, &counter, sizeof(counter)) < 0 && errno != EAGAIN)
+        qCWarning(lcSensorFw) << "Failed to clear sample staging eventfd: " << strerror(errno);
+
+    int drained;
+    {
+        QMutexLocker locker(&m_mutex);
+        drained = m_pending;
+        m_pending ^= 1;
+    }
+
+    Arena& arena = m_arenas[drained];
+    int count = 0;
+    int offset = 0;
+    while (offset < arena.used) {
+        const Record* record = reinterpret_cast<const Record*>(arena.data + offset);
+        if (!socketHandler.write(record->sessionId, record + 1, record->size, record->staged))
+            qCWarning(lcSensorFw) << "Failed to write data to socket.";
+        offset += recordSize(record->size);
+        ++count;
+    }
+    arena.used = 0;
+
+    return count;
+}
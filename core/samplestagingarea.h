@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (c) 2026 Jolla Mobile Ltd
+**
+**
+** $QT_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef SAMPLESTAGINGAREA_H
+#define SAMPLESTAGINGAREA_H
+
+#include <QMutex>
+
+class SocketHandler;
+
+/**
+ * Staging area for samples written by sensor channels towards client
+ * sessions.
+ *
+ * Sensor channels may run in adaptor reader threads, while the sessions
+ * are served from the main thread. Samples are appended into a
+ * preallocated arena which is handed over to the main thread as a whole.
+ * Two arenas are used in turns, so in steady state no memory is allocated
+ * and the notification descriptor is signaled only once per batch, when
+ * the pending arena turns non-empty.
+ */
+class SampleStagingArea
+{
+    Q_DISABLE_COPY(SampleStagingArea)
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param capacity Initial capacity of each arena in bytes.
+     * @param maxCapacity Upper limit for arena growth in bytes.
+     */
+    SampleStagingArea(int capacity = 64 * 1024, int maxCapacity = 4 * 1024 * 1024);
+
+    /**
+     * Destructor.
+     */
+    ~SampleStagingArea();
+
+    /**
+     * Is the staging area usable.
+     *
+     * @return was notification descriptor and arena set up succesfully.
+     */
+    bool isValid() const;
+
+    /**
+     * Descriptor which becomes readable when there is data to be drained.
+     *
+     * @return eventfd descriptor or -1 if not available.
+     */
+    int notifyFd() const;
+
+    /**
+     * Append sample for given session. Can be called from any thread.
+     *
+     * @param sessionId Session ID.
+     * @param source Source from where to copy.
+     * @param size How many bytes to copy.
+     * @return was sample staged.
+     */
+    bool write(int sessionId, const void* source, int size);
+
+    /**
+     * Write all staged samples into given socket handler. Must be called
+     * from the thread owning the socket handler.
+     *
+     * @param socketHandler Target socket handler.
+     * @return number of samples handled.
+     */
+    int drain(SocketHandler& socketHandler);
+
+    /**
+     * Set how often staged samples are stamped with the time they were
+     * staged, for measuring how long they wait before reaching their
+     * session.
+     *
+     * @param interval Stamp every this many samples, 0 disables.
+     */
+    void setStampInterval(unsigned int interval);
+
+    /**
+     * Number of samples dropped because the arena limit was reached.
+     *
+     * @return dropped sample count.
+     */
+    unsigned int dropped() const;
+
+private:
+    /**
+     * Header preceding each staged sample.
+     */
+    struct Record
+    {
+        int sessionId;  /**< target session */
+        int size;       /**< payload size in bytes */
+        quint64 staged; /**< CLOCK_MONOTONIC time of staging in us, 0 if not stamped */
+    };
+
+    /**
+     * Single arena of consecutive records.
+     */
+    struct Arena
+    {
+        char* data;    /**< storage */
+        int used;      /**< bytes in use */
+        int capacity;  /**< allocated bytes */
+    };
+
+    /**
+     * Make room for given number of bytes in the arena.
+     *
+     * @param arena Arena to grow.
+     * @param bytes Required free space.
+     * @return is there enough room.
+     */
+    bool reserve(Arena& arena, int bytes);
+
+    /**
+     * Size of a record with given payload including alignment padding.
+     *
+     * @param size payload size.
+     * @return bytes used from the arena.
+     */
+    static int recordSize(int size);
+
+    mutable QMutex m_mutex;  /**< protects pending arena and index */
+    Arena m_arenas[2];       /**< arenas used in turns */
+    int m_pending;           /**< index of the arena producers append to */
+    int m_maxCapacity;       /**< maximum size of single arena */
+    int m_eventFd;           /**< wakeup descriptor */
+    unsigned int m_dropped;  /**< samples dropped due to arena limit */
+    unsigned int m_stampInterval; /**< stamp every this many samples */
+    unsigned int m_sinceStamp;    /**< samples staged since last stamp */
+};
+
+#endif // SAMPLESTAGINGAREA_H
@@ -34,6 +34,7 @@
 #include "loader.h"
 #include "idutils.h"
 #include "logging.h"
+#include "config.h"
 #ifdef SENSORFW_MCE_WATCHER
 #include "mcewatcher.h"
 #endif // SENSORFW_MCE_WATCHER
@@ -44,6 +45,7 @@
 #include <errno.h>
 #include <functional>
 #include "sockethandler.h"
+#include "samplestagingarea.h"
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -51,13 +53,6 @@
 #include <QTimer>
 #include <QSettings>
 
-
-typedef struct {
-    int id;
-    int size;
-    void* buffer;
-} PipeData;
-
 const int SensorManager::SOCKET_CONNECTION_TIMEOUT_MS = 10000;
 
 SensorManager* SensorManager::instance_ = NULL;
@@ -163,7 +158,8 @@ SensorManager& SensorManager::instance()
 
 SensorManager::SensorManager()
     : errorCode_(SmNoError),
-    pipeNotifier_(0),
+    stagingArea_(0),
+    stagingNotifier_(0),
     deviation(0)
 {
     QString pluginPath;
@@ -181,12 +177,13 @@ SensorManager::SensorManager()
 
     Q_ASSERT(socketHandler_->listen(SOCKET_NAME));
 
-    if (pipe(pipefds_) == -1) {
-        qCCritical(lcSensorFw) << "Failed to create pipe: " << strerror(errno);
-        pipefds_[0] = pipefds_[1] = 0;
+    stagingArea_ = new SampleStagingArea();
+    if (!stagingArea_->isValid()) {
+        qCCritical(lcSensorFw) << "Failed to set up sample staging area";
     } else {
-        pipeNotifier_ = new QSocketNotifier(pipefds_[0], QSocketNotifier::Read);
-        connect(pipeNotifier_, SIGNAL(activated(int)), this, SLOT(sensorDataHandler(int)));
+        stagingArea_->setStampInterval(qMax(0, SensorFrameworkConfig::configuration()->value<int>("latency/sample_interval", 16)));
+        stagingNotifier_ = new QSocketNotifier(stagingArea_->notifyFd(), QSocketNotifier::Read);
+        connect(stagingNotifier_, SIGNAL(activated(int)), this, SLOT(sensorDataHandler(int)));
     }
 
     if (chmod(SOCKET_NAME, S_IRWXU|S_IRWXG|S_IRWXO) != 0) {
@@ -266,10 +263,9 @@ SensorManager::~SensorManager()
     }
 
     delete socketHandler_;
-    delete pipeNotifier_;
+    delete stagingNotifier_;
+    delete stagingArea_;
     delete serviceWatcher_;
-    if (pipefds_[0]) close(pipefds_[0]);
-    if (pipefds_[1]) close(pipefds_[1]);
 
 #ifdef SENSORFW_MCE_WATCHER
     delete mceWatcher_;
@@ -684,37 +680,20 @@ FilterBase* SensorManager::instantiateFilter(const QString& id)
     return it.value()();
 }
 
-bool SensorManager::write(int id, const void* source, int size)
+QVariantMap SensorManager::sessionStatistics(int sessionId) const
 {
-    void* buffer = malloc(size);
-    if (!buffer) {
-        qCCritical(lcSensorFw) << "Malloc failed!";
-        return false;
-    }
-    PipeData pipeData;
-    pipeData.id = id;
-    pipeData.size = size;
-    pipeData.buffer = buffer;
-
-    memcpy(buffer, source, size);
+    return socketHandler_->sessionStatistics(sessionId);
+}
 
-    if (::write(pipefds_[1], &pipeData, sizeof(pipeData)) < (int)sizeof(pipeData)) {
-        qCWarning(lcSensorFw) << "Failed to write all data to pipe.";
-        return false;
-    }
-    return true;
+bool SensorManager::write(int id, const void* source, int size)
+{
+    return stagingArea_->write(id, source, size);
 }
 
 void SensorManager::sensorDataHandler(int)
 {
-    PipeData pipeData;
-    ssize_t bytesRead = read(pipefds_[0], &pipeData, sizeof(pipeData));
-
-    if (!bytesRead || !socketHandler_->write(pipeData.id, pipeData.buffer, pipeData.size)) {
-        qCWarning(lcSensorFw) << "Failed to write data to socket.";
-    }
-
-    free(pipeData.buffer);
+    stagingArea_->drain(*socketHandler_);
+    socketHandler_->flush();
 }
 
 void SensorManager::lostClient(int sessionId)
@@ -817,12 +796,37 @@ QStringList SensorManager::printStatus() const
         else
             str.append("No sessions]");
         str.append(QString(". %1").arg((it.value().sensor_ && it.value().sensor_->running()) ? "Running" : "Stopped"));
+        if (it.value().sensor_)
+            str.append(formatLatency(", latency", it.value().sensor_->latencyStatistics()));
         output.append(str);
     }
 
+    output.append("  Sessions:");
+    foreach (int sessionId, socketHandler_->sessions()) {
+        QVariantMap stats = socketHandler_->sessionStatistics(sessionId);
+        output.append(QString("    %1 [queued %2 frame(s), %3 byte(s), dropped %4, policy %5]%6%7")
+                      .arg(sessionId)
+                      .arg(stats.value("queuedFrames").toInt())
+                      .arg(stats.value("queuedBytes").toInt())
+                      .arg(stats.value("droppedFrames").toUInt())
+                      .arg(stats.value("dropPolicy").toString())
+                      .arg(formatLatency(", queue latency", stats.value("queueLatency").toMap()))
+                      .arg(formatLatency(", send latency", stats.value("sendLatency").toMap())));
+    }
+
     return output;
 }
 
+QString SensorManager::formatLatency(const QString& label, const QVariantMap& latency)
+{
+    if (!latency.value("samples").toULongLong())
+        return QString();
+    return QString("%1 p50 %2 us, p99 %3 us, max %4 us").arg(label)
+        .arg(latency.value("p50_us").toULongLong())
+        .arg(latency.value("p99_us").toULongLong())
+        .arg(latency.value("max_us").toULongLong());
+}
+
 QString SensorManager::socketToPid(int id) const
 {
     struct ucred cr;
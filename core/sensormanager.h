@@ -55,6 +55,7 @@ class MceWatcher;
 class QSocketNotifier;
 class QTimer;
 class SocketHandler;
+class SampleStagingArea;
 
 /**
  * Sensor instance entry. Contains list of connected sessions.
@@ -361,6 +362,14 @@ public:
      */
     bool releaseSensor(const QString& id, int sessionId);
 
+    /**
+     * Get outgoing data queue statistics for session.
+     *
+     * @param sessionId Session ID.
+     * @return statistics, see #SessionData::statistics().
+     */
+    QVariantMap sessionStatistics(int sessionId) const;
+
     /**
      * Get sensor instance.
      *
@@ -437,8 +446,8 @@ private Q_SLOTS:
     void devicePSMStateChanged(bool deviceMode);
 
     /**
-     * Callback for arrived sensor data in internal pipe which SensorManager
-     * needs to propagate to the SocketHandler.
+     * Callback for arrived sensor data in the staging area which
+     * SensorManager needs to propagate to the SocketHandler.
      */
     void sensorDataHandler(int);
 
@@ -510,6 +519,15 @@ private:
      */
     int createNewSessionId();
 
+    /**
+     * Format latency summary for status output.
+     *
+     * @param label text preceding the numbers.
+     * @param latency summary from LatencyHistogram::summary().
+     * @return formatted text, empty if nothing was measured.
+     */
+    static QString formatLatency(const QString& label, const QVariantMap& latency);
+
     /**
      * Resolve peer PID of given session.
      *
@@ -546,8 +564,8 @@ private:
 #endif
     SensorManagerError                             errorCode_; /** global error code */
     QString                                        errorString_; /** global error description */
-    int                                            pipefds_[2]; /** pipe for sensor samples */
-    QSocketNotifier*                               pipeNotifier_; /** notifier for pipe stream */
+    SampleStagingArea*                             stagingArea_; /** staging area for sensor samples */
+    QSocketNotifier*                               stagingNotifier_; /** notifier for staged samples */
 
     static SensorManager*                          instance_; /** singleton */
     static int                                     sessionIdCount_; /** session ID counter */
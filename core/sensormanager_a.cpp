@@ -92,6 +92,11 @@ double SensorManagerAdaptor::magneticDeviation()
     return sensorManager()->magneticDeviation();
 }
 
+QVariantMap SensorManagerAdaptor::sessionStatistics(int sessionId) const
+{
+    return sensorManager()->sessionStatistics(sessionId);
+}
+
 SensorManager* SensorManagerAdaptor::sensorManager() const
 {
     return dynamic_cast<SensorManager*>(parent());
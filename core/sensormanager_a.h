@@ -130,6 +130,15 @@ public Q_SLOTS:
     double magneticDeviation();
     void setMagneticDeviation(double level);
 
+    /**
+     * Get outgoing data queue statistics for session.
+     *
+     * @param sessionId Session ID.
+     * @return map with queuedFrames, queuedBytes, droppedFrames and
+     *         dropPolicy entries. Empty for unknown session.
+     */
+    QVariantMap sessionStatistics(int sessionId) const;
+
 Q_SIGNALS:
     /**
      * Signal which is emitted for occured errors.
@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (c) 2026 Jolla Mobile Ltd
+**
+**
+** $QT_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "sharedsessionring.h"
+#include "logging.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+SharedSessionRing::SharedSessionRing(unsigned int slotCount)
+    : m_fd(-1)
+    , m_mapping(MAP_FAILED)
+    , m_size(sessionRingMappingSize(slotCount))
+{
+    if (!slotCount || (slotCount & (slotCount - 1))) {
+        qCWarning(lcSensorFw) << "Session ring slot count must be a power of two:" << slotCount;
+        return;
+    }
+
+    m_fd = memfd_create("sensord-session-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (m_fd == -1) {
+        qCWarning(lcSensorFw) << "memfd_create(): " << strerror(errno);
+        return;
+    }
+
+    if (ftruncate(m_fd, m_size) == -1) {
+        qCWarning(lcSensorFw) << "ftruncate(): " << strerror(errno);
+        return;
+    }
+
+    // Clients must not be able to resize the memory under us
+    if (fcntl(m_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == -1)
+        qCWarning(lcSensorFw) << "Failed to seal session ring: " << strerror(errno);
+
+    m_mapping = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (m_mapping == MAP_FAILED) {
+        qCWarning(lcSensorFw) << "mmap(): " << strerror(errno);
+        return;
+    }
+
+    m_writer.initialize(m_mapping, slotCount);
+}
+
+SharedSessionRing::~SharedSessionRing()
+{
+    if (m_mapping != MAP_FAILED)
+        munmap(m_mapping, m_size);
+    if (m_fd != -1)
+        close(m_fd);
+}
+
+bool SharedSessionRing::isValid() const
+{
+    return m_mapping != MAP_FAILED;
+}
+
+int SharedSessionRing::fd() const
+{
+    return m_fd;
+}
+
+bool SharedSessionRing::write(const void* source, int size, bool& wakeup)
+{
+    if (size < 0 || (unsigned int)size > SESSION_RING_SLOT_PAYLOAD) {
+        qCWarning(lcSensorFw) << "Sample of" << size << "bytes does not fit into session ring";
+        return false;
+    }
+    wakeup = m_writer.write(source, size);
+    return true;
+}
@@ -0,0 +1,76 @@
+/****************************************************************************
+**
+** Copyright (c) 2026 Jolla Mobile Ltd
+**
+**
+** $QT_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef SHAREDSESSIONRING_H
+#define SHAREDSESSIONRING_H
+
+#include <QtGlobal>
+#include "sessionring.h"
+
+/**
+ * memfd backed sample ring shared with a single client session. See
+ * sessionring.h for the memory layout.
+ */
+class SharedSessionRing
+{
+    Q_DISABLE_COPY(SharedSessionRing)
+
+public:
+    /**
+     * Constructor. Creates and maps the shared memory.
+     *
+     * @param slotCount number of slots, power of two.
+     */
+    SharedSessionRing(unsigned int slotCount = SESSION_RING_DEFAULT_SLOTS);
+
+    /**
+     * Destructor.
+     */
+    ~SharedSessionRing();
+
+    /**
+     * Was the shared memory set up succesfully.
+     */
+    bool isValid() const;
+
+    /**
+     * File descriptor of the shared memory. Ownership stays in this object.
+     *
+     * @return memfd descriptor or -1.
+     */
+    int fd() const;
+
+    /**
+     * Publish sample into the ring.
+     *
+     * @param source sample data.
+     * @param size sample size in bytes.
+     * @param wakeup set to \c true if client has asked to be notified.
+     * @return was sample published.
+     */
+    bool write(const void* source, int size, bool& wakeup);
+
+private:
+    int               m_fd;      /**< memfd */
+    void*             m_mapping; /**< mapped ring */
+    size_t            m_size;    /**< size of the mapping */
+    SessionRingWriter m_writer;  /**< ring producer */
+};
+
+#endif // SHAREDSESSIONRING_H
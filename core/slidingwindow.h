@@ -0,0 +1,226 @@
+/****************************************************************************
+**
+** Copyright (c) 2026 Jolla Mobile Ltd
+**
+**
+** $QT_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef SLIDINGWINDOW_H
+#define SLIDINGWINDOW_H
+
+#include <QtGlobal>
+#include <QVector>
+
+/**
+ * Fixed capacity window over the latest samples of a DIM dimensional
+ * signal, with running sums for O(1) mean and variance.
+ *
+ * Pushing into a full window evicts the oldest sample. Sums are updated
+ * incrementally; with floating point SUM types they are recomputed from
+ * the stored values every now and then to keep rounding errors from
+ * accumulating.
+ *
+ * @tparam DIM number of channels.
+ * @tparam SUM type used for stored values and sums.
+ */
+template <int DIM, class SUM = double>
+class SlidingWindow
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param capacity maximum number of samples in the window.
+     */
+    explicit SlidingWindow(unsigned capacity = 1)
+        : m_head(0)
+        , m_count(0)
+        , m_sinceResum(0)
+    {
+        m_samples.resize(qMax(1u, capacity));
+        resetSums();
+    }
+
+    /**
+     * Change capacity. The newest samples which still fit are kept.
+     *
+     * @param capacity maximum number of samples in the window.
+     */
+    void setCapacity(unsigned capacity)
+    {
+        capacity = qMax(1u, capacity);
+        if (capacity == this->capacity())
+            return;
+
+        QVector<Sample> samples(capacity);
+        unsigned keep = qMin(m_count, capacity);
+        for (unsigned i = 0; i < keep; ++i)
+            samples[i] = at(m_count - keep + i);
+        m_samples = samples;
+        m_head = 0;
+        m_count = keep;
+        resum();
+    }
+
+    /**
+     * Maximum number of samples in the window.
+     */
+    unsigned capacity() const { return m_samples.size(); }
+
+    /**
+     * Number of samples in the window.
+     */
+    unsigned count() const { return m_count; }
+
+    /**
+     * Is the window empty.
+     */
+    bool isEmpty() const { return m_count == 0; }
+
+    /**
+     * Does the window hold capacity() samples.
+     */
+    bool isFull() const { return m_count == capacity(); }
+
+    /**
+     * Add sample, evicting the oldest one if the window is full.
+     *
+     * @param timestamp sample timestamp.
+     * @param values sample values, one per channel.
+     */
+    void push(quint64 timestamp, const SUM (&values)[DIM])
+    {
+        if (isFull())
+            popOldest();
+
+        Sample& sample = m_samples[(m_head + m_count) % capacity()];
+        sample.timestamp = timestamp;
+        for (int i = 0; i < DIM; ++i) {
+            sample.values[i] = values[i];
+            m_sum[i] += values[i];
+            m_sumSquares[i] += values[i] * values[i];
+        }
+        ++m_count;
+
+        if (++m_sinceResum >= resumInterval)
+            resum();
+    }
+
+    /**
+     * Evict samples older than given timestamp from the beginning of
+     * the window.
+     *
+     * @param timestamp samples with earlier timestamp are evicted.
+     * @param keep minimum number of samples to leave in the window.
+     */
+    void expireBefore(quint64 timestamp, unsigned keep = 0)
+    {
+        while (m_count > keep && oldestTimestamp() < timestamp)
+            popOldest();
+    }
+
+    /**
+     * Timestamp of the oldest sample. Window must not be empty.
+     */
+    quint64 oldestTimestamp() const { return m_samples.at(m_head).timestamp; }
+
+    /**
+     * Remove all samples.
+     */
+    void clear()
+    {
+        m_head = 0;
+        m_count = 0;
+        resetSums();
+    }
+
+    /**
+     * Sum of samples in given channel.
+     */
+    SUM sum(int channel) const { return m_sum[channel]; }
+
+    /**
+     * Mean of samples in given channel. Window must not be empty.
+     */
+    SUM mean(int channel) const { return m_sum[channel] / (SUM)m_count; }
+
+    /**
+     * Population variance of samples in given channel. Window must not
+     * be empty.
+     */
+    SUM variance(int channel) const
+    {
+        SUM m = mean(channel);
+        SUM v = m_sumSquares[channel] / (SUM)m_count - m * m;
+        return v > 0 ? v : 0;
+    }
+
+private:
+    struct Sample
+    {
+        quint64 timestamp;
+        SUM values[DIM];
+    };
+
+    /** Pushes between recomputing sums from stored values. */
+    static const unsigned resumInterval = 1024;
+
+    const Sample& at(unsigned index) const
+    {
+        return m_samples.at((m_head + index) % capacity());
+    }
+
+    void popOldest()
+    {
+        const Sample& sample = m_samples.at(m_head);
+        for (int i = 0; i < DIM; ++i) {
+            m_sum[i] -= sample.values[i];
+            m_sumSquares[i] -= sample.values[i] * sample.values[i];
+        }
+        m_head = (m_head + 1) % capacity();
+        if (!--m_count)
+            resetSums();
+    }
+
+    void resetSums()
+    {
+        for (int i = 0; i < DIM; ++i) {
+            m_sum[i] = 0;
+            m_sumSquares[i] = 0;
+        }
+        m_sinceResum = 0;
+    }
+
+    void resum()
+    {
+        resetSums();
+        for (unsigned n = 0; n < m_count; ++n) {
+            const Sample& sample = at(n);
+            for (int i = 0; i < DIM; ++i) {
+                m_sum[i] += sample.values[i];
+                m_sumSquares[i] += sample.values[i] * sample.values[i];
+            }
+        }
+    }
+
+    QVector<Sample> m_samples;  /**< circular storage */
+    unsigned m_head;            /**< index of the oldest sample */
+    unsigned m_count;           /**< number of samples */
+    unsigned m_sinceResum;      /**< pushes since sums were recomputed */
+    SUM m_sum[DIM];             /**< running sums */
+    SUM m_sumSquares[DIM];      /**< running sums of squares */
+};
+
+#endif // SLIDINGWINDOW_H
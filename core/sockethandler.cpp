@@ -28,13 +28,40 @@
 
 #include <QLocalSocket>
 #include <QLocalServer>
+#include <QSocketNotifier>
+#include <errno.h>
+#include <string.h>
 #include <sys/socket.h>
 #include <sys/time.h>
 #include "logging.h"
 #include "sockethandler.h"
+#include "sharedsessionring.h"
+#include "config.h"
+#include "wireformat.h"
+#include "datatypes/utils.h"
 #include <unistd.h>
 #include <limits.h>
 
+namespace {
+/** Default upper limit for frames queued towards a client. */
+const int defaultQueueLimit = 256 * 1024;
+/** Default time a client may stall before Disconnect policy kicks in. */
+const int defaultStallTimeout_ms = 5000;
+/** Default number of samples per latency measurement. */
+const int defaultLatencySampleInterval = 16;
+
+const char* const dropPolicyNames[] = { "drop_oldest", "drop_newest", "decimate", "disconnect" };
+
+long elapsed_us(const struct timeval& since)
+{
+    struct timeval now = {0, 0};
+    gettimeofday(&now, 0);
+    struct timeval diff;
+    timersub(&now, &since, &diff);
+    return diff.tv_sec * 1000000L + diff.tv_usec;
+}
+}
+
 SessionData::SessionData(QLocalSocket* socket, QObject* parent)
     : QObject(parent),
       m_socket(socket),
@@ -44,24 +71,53 @@ SessionData::SessionData(QLocalSocket* socket, QObject* parent)
       m_count(0),
       m_bufferSize(1),
       m_bufferInterval_us(0),
-      m_downsampling(false)
+      m_downsampling(false),
+      m_ring(nullptr),
+      m_wakeupPending(false),
+      m_outgoingOffset(0),
+      m_writeNotifier(nullptr),
+      m_firstFrame(0),
+      m_dropPolicy(DropOldest),
+      m_queueLimit(defaultQueueLimit),
+      m_stallTimeout_ms(defaultStallTimeout_ms),
+      m_decimateSkip(false),
+      m_stallReported(false),
+      m_droppedFrames(0),
+      m_dropBurst(0),
+      m_multiplex(nullptr),
+      m_channel(-1),
+      m_queueLatency(0),
+      m_sendLatency(defaultLatencySampleInterval),
+      m_tracedQueued(0),
+      m_tracedEnd(-1)
 {
     m_lastWrite.tv_sec = 0;
     m_lastWrite.tv_usec = 0;
+    gettimeofday(&m_lastProgress, 0);
     m_timer.setSingleShot(true);
     connect(&m_timer, SIGNAL(timeout()), this, SLOT(timerTimeout()));
+    // Reserved capacity is kept when the queue is emptied
+    m_outgoing.reserve(4096);
 }
 
 SessionData::~SessionData()
 {
     m_timer.stop();
+    delete m_writeNotifier;
     delete m_socket;
     delete[] m_buffer;
+    delete m_ring;
 }
 
 void SessionData::timerTimeout()
 {
     delayedWrite();
+    flush();
+}
+
+void SessionData::socketWritable()
+{
+    flush();
 }
 
 long SessionData::sinceLastWrite() const
@@ -76,66 +132,335 @@ long SessionData::sinceLastWrite() const
     return interval_us;
 }
 
-bool SessionData::write(void* source, int size, unsigned int count)
+bool SessionData::queueFrame(const void* source, int size, unsigned int count)
+{
+    if ((!m_socket && !m_multiplex) || !count)
+        return false;
+
+    int frameSize = frameHeaderSize() + size * count;
+    int queued = m_outgoing.size() - m_outgoingOffset;
+    bool accept = true;
+
+    if (m_dropPolicy == Decimate && queued > m_queueLimit / 2) {
+        accept = !m_decimateSkip;
+        m_decimateSkip = !m_decimateSkip;
+    }
+    if (accept && queued + frameSize > m_queueLimit) {
+        accept = (m_dropPolicy == DropOldest) && dropOldest(frameSize);
+    }
+
+    if (!accept) {
+        ++m_droppedFrames;
+        if (!m_dropBurst++)
+            qCWarning(lcSensorFw) << "[SocketHandler]: client does not keep up, dropping frames";
+        checkStall();
+        return false;
+    }
+    if (m_dropBurst) {
+        qCWarning(lcSensorFw) << "[SocketHandler]: client recovered," << m_dropBurst << "frames dropped";
+        m_dropBurst = 0;
+    }
+
+    appendFrame(source, size * count, count);
+    return true;
+}
+
+void SessionData::appendFrame(const void* source, int bytes, unsigned int count)
+{
+    if (!hasPendingOutput()) {
+        resetQueue();
+        gettimeofday(&m_lastProgress, 0);
+    }
+    m_frameOffsets.append(m_outgoing.size());
+    if (m_multiplex) {
+        SensorWireChannelHeader header;
+        header.channel = m_channel;
+        header.sampleSize = count ? bytes / count : 0;
+        header.count = count;
+        m_outgoing.append((const char*)&header, sizeof(header));
+    } else {
+        m_outgoing.append((const char*)&count, sizeof(unsigned int));
+    }
+    if (bytes)
+        m_outgoing.append((const char*)source, bytes);
+
+    // Trace the frame until it leaves the queue
+    if (count && m_tracedEnd < 0 && m_sendLatency.sample()) {
+        m_tracedQueued = Utils::getTimeStamp();
+        m_tracedEnd = m_outgoing.size();
+    }
+}
+
+int SessionData::frameHeaderSize() const
+{
+    return m_multiplex ? sizeof(SensorWireChannelHeader) : sizeof(unsigned int);
+}
+
+bool SessionData::dropOldest(int bytes)
+{
+    // A frame which is partially sent must be completed
+    int first = m_firstFrame;
+    if (first < m_frameOffsets.size() && m_frameOffsets.at(first) < m_outgoingOffset)
+        ++first;
+
+    int last = first;
+    int room = m_queueLimit - (m_outgoing.size() - m_outgoingOffset);
+    while (room < bytes && last < m_frameOffsets.size()) {
+        int end = (last + 1 < m_frameOffsets.size()) ? m_frameOffsets.at(last + 1) : m_outgoing.size();
+        room += end - m_frameOffsets.at(last);
+        ++last;
+    }
+    if (room < bytes || last == first)
+        return false;
+
+    int from = m_frameOffsets.at(first);
+    int to = (last < m_frameOffsets.size()) ? m_frameOffsets.at(last) : m_outgoing.size();
+    m_outgoing.remove(from, to - from);
+    if (m_tracedEnd > from)
+        m_tracedEnd = -1;
+    m_frameOffsets.remove(first, last - first);
+    for (int i = first; i < m_frameOffsets.size(); ++i)
+        m_frameOffsets[i] -= to - from;
+
+    m_droppedFrames += last - first;
+    if (!m_dropBurst)
+        qCWarning(lcSensorFw) << "[SocketHandler]: client does not keep up, dropping oldest frames";
+    m_dropBurst += last - first;
+    return true;
+}
+
+void SessionData::recordSent()
+{
+    if (m_tracedEnd >= 0 && m_outgoingOffset >= m_tracedEnd) {
+        m_sendLatency.recordSince(m_tracedQueued, Utils::getTimeStamp());
+        m_tracedEnd = -1;
+    }
+}
+
+void SessionData::resetQueue()
+{
+    m_tracedEnd = -1;
+    m_outgoing.resize(0);
+    m_outgoingOffset = 0;
+    m_frameOffsets.resize(0);
+    m_firstFrame = 0;
+}
+
+void SessionData::compactQueue()
+{
+    int sent = m_outgoingOffset;
+    m_outgoing.remove(0, sent);
+    m_outgoingOffset = 0;
+    m_frameOffsets.remove(0, m_firstFrame);
+    m_firstFrame = 0;
+    for (int i = 0; i < m_frameOffsets.size(); ++i)
+        m_frameOffsets[i] -= sent;
+    if (m_tracedEnd >= 0)
+        m_tracedEnd -= sent;
+}
+
+void SessionData::checkStall()
+{
+    if (m_dropPolicy != Disconnect || m_stallReported || !hasPendingOutput())
+        return;
+    if (elapsed_us(m_lastProgress) / 1000 >= m_stallTimeout_ms) {
+        qCWarning(lcSensorFw) << "[SocketHandler]: client has not read data for" << m_stallTimeout_ms << "ms, disconnecting";
+        m_stallReported = true;
+        emit stalled();
+    }
+}
+
+void SessionData::setQueuePolicy(DropPolicy policy, int limit, int stallTimeout_ms)
 {
-    if (m_socket && count) {
-        memcpy(source, &count, sizeof(unsigned int));
-        int written = m_socket->write((const char*)source, size * count + sizeof(unsigned int));
-        if (written < 0) {
-            qCWarning(lcSensorFw) << "[SocketHandler]: failed to write payload to the socket: " << m_socket->errorString();
+    m_dropPolicy = policy;
+    m_queueLimit = limit;
+    m_stallTimeout_ms = stallTimeout_ms;
+}
+
+QVariantMap SessionData::statistics() const
+{
+    QVariantMap stats;
+    stats.insert("queuedFrames", m_frameOffsets.size() - m_firstFrame);
+    stats.insert("queuedBytes", m_outgoing.size() - m_outgoingOffset);
+    stats.insert("droppedFrames", m_droppedFrames);
+    stats.insert("dropPolicy", QString(dropPolicyNames[m_dropPolicy]));
+    stats.insert("queueLatency", m_queueLatency.summary());
+    stats.insert("sendLatency", m_sendLatency.summary());
+    return stats;
+}
+
+void SessionData::setLatencySampleInterval(unsigned int interval)
+{
+    m_sendLatency.setSampleInterval(interval);
+}
+
+void SessionData::queueBuffered()
+{
+    if (m_count && m_buffer)
+        queueFrame(m_buffer, m_size, m_count);
+    m_count = 0;
+}
+
+bool SessionData::hasPendingOutput() const
+{
+    return m_outgoingOffset < m_outgoing.size();
+}
+
+bool SessionData::flush()
+{
+    if (!hasPendingOutput())
+        return true;
+    if (m_multiplex) {
+        flushToMultiplex();
+        return true;
+    }
+    if (!m_socket) {
+        resetQueue();
+        return false;
+    }
+
+    int fd = m_socket->socketDescriptor();
+    int start = m_outgoingOffset;
+    while (m_outgoingOffset < m_outgoing.size()) {
+        ssize_t sent = ::send(fd, m_outgoing.constData() + m_outgoingOffset,
+                              m_outgoing.size() - m_outgoingOffset, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            qCWarning(lcSensorFw) << "[SocketHandler]: failed to write payload to the socket: " << strerror(errno);
+            resetQueue();
             return false;
         }
-        return true;
+        m_outgoingOffset += sent;
     }
-    return false;
+    recordSent();
+
+    bool pending = hasPendingOutput();
+    if (!pending) {
+        resetQueue();
+    } else {
+        // Forget frames which have been sent completely
+        while (m_firstFrame + 1 < m_frameOffsets.size()
+               && m_frameOffsets.at(m_firstFrame + 1) <= m_outgoingOffset)
+            ++m_firstFrame;
+        // Reclaim sent bytes once they dominate the queue
+        if (m_outgoingOffset > m_outgoing.size() / 2)
+            compactQueue();
+        if (!m_writeNotifier) {
+            m_writeNotifier = new QSocketNotifier(fd, QSocketNotifier::Write, this);
+            connect(m_writeNotifier, &QSocketNotifier::activated, this, &SessionData::socketWritable);
+        }
+    }
+    if (m_writeNotifier)
+        m_writeNotifier->setEnabled(pending);
+
+    if (m_outgoingOffset != start)
+        gettimeofday(&m_lastProgress, 0);
+    else
+        checkStall();
+    return true;
 }
 
-bool SessionData::write(const void* source, int size)
+void SessionData::flushToMultiplex()
 {
-    long since_us = sinceLastWrite();
-    int allocSize = m_bufferSize * size + sizeof(unsigned int);
-
-    if (!m_buffer) {
-        m_buffer = new char[allocSize];
-    } else if (size != m_size) {
-        m_socket->waitForBytesWritten();
-        delete[] m_buffer;
-        m_buffer = new char[allocSize];
+    if (!m_multiplex->append(m_outgoing.constData() + m_outgoingOffset,
+                             m_outgoing.size() - m_outgoingOffset)) {
+        checkStall();
+        return;
     }
+    m_outgoingOffset = m_outgoing.size();
+    recordSent();
+    resetQueue();
+    gettimeofday(&m_lastProgress, 0);
+}
+
+bool SessionData::write(const void* source, int size, quint64 staged)
+{
+    if (staged)
+        m_queueLatency.recordSince(staged, Utils::getTimeStamp());
+
+    if (m_ring)
+        return writeToRing(source, size);
+
+    long since_us = sinceLastWrite();
 
-    m_size = size;
     if (m_bufferSize <= 1) {
-        memcpy(m_buffer + sizeof(unsigned int), source, size);
         if (!m_downsampling || (m_downsampling && since_us >= m_interval_us)) {
             gettimeofday(&m_lastWrite, 0);
-            return write(m_buffer, size, 1);
-        }
-    } else {
-        memcpy(m_buffer + sizeof(unsigned int) + size * m_count, source, size);
-        ++m_count;
-        if (m_bufferSize == m_count) {
-            return delayedWrite();
+            return queueFrame(source, size, 1);
         }
+        return true;
     }
 
-    if (!m_timer.isActive()) {
-        if (m_bufferSize > 1 && m_bufferInterval_us) {
-            int interval_ms = (m_bufferInterval_us + 999) / 1000;
-            m_timer.start(interval_ms);
-        } else if (!m_bufferSize && m_interval_us > since_us) {
-            int interval_ms = (m_interval_us - since_us + 999) / 1000;
-            m_timer.start(interval_ms);
-        }
+    if (!m_buffer || size != m_size) {
+        // Sample size changed, send what was collected with the old size
+        queueBuffered();
+        delete[] m_buffer;
+        m_buffer = new char[m_bufferSize * size];
+        m_size = size;
+    }
+
+    memcpy(m_buffer + size * m_count, source, size);
+    ++m_count;
+    if (m_bufferSize == m_count) {
+        return delayedWrite();
+    }
+
+    if (!m_timer.isActive() && m_bufferInterval_us) {
+        int interval_ms = (m_bufferInterval_us + 999) / 1000;
+        m_timer.start(interval_ms);
     }
     return true;
 }
 
+bool SessionData::writeToRing(const void* source, int size)
+{
+    if (m_downsampling && sinceLastWrite() < m_interval_us)
+        return true;
+    gettimeofday(&m_lastWrite, 0);
+
+    bool wakeup = false;
+    if (!m_ring->write(source, size, wakeup))
+        return false;
+    m_wakeupPending |= wakeup;
+    ++m_count;
+
+    if (!m_wakeupPending)
+        return true;
+    if (m_bufferSize <= 1 || m_count >= m_bufferSize)
+        return delayedWrite();
+    if (!m_timer.isActive() && m_bufferInterval_us) {
+        int interval_ms = (m_bufferInterval_us + 999) / 1000;
+        m_timer.start(interval_ms);
+    }
+    return true;
+}
+
+bool SessionData::writeWakeup()
+{
+    // Empty frame tells the client to look into the shared ring
+    unsigned int count = 0;
+    m_wakeupPending = false;
+    if (!m_socket && !m_multiplex)
+        return false;
+    if (hasPendingOutput())
+        return true;
+    appendFrame(nullptr, 0, count);
+    return true;
+}
+
 bool SessionData::delayedWrite()
 {
     if (m_timer.isActive())
         m_timer.stop();
+    if (m_ring) {
+        m_count = 0;
+        return m_wakeupPending ? writeWakeup() : true;
+    }
     gettimeofday(&m_lastWrite, 0);
-    bool ret = write(m_buffer, m_size, m_count);
+    bool ret = m_count ? queueFrame(m_buffer, m_size, m_count) : true;
     m_count = 0;
     return ret;
 }
@@ -177,10 +502,11 @@ void SessionData::setBufferSize(unsigned int size)
     if (size != m_bufferSize) {
         if (m_timer.isActive())
             m_timer.stop();
-        m_socket->waitForBytesWritten();
+        // Collected samples are sent as a short frame instead of waiting
+        queueBuffered();
+        flush();
         delete[] m_buffer;
         m_buffer = 0;
-        m_count = 0;
         m_bufferSize = size;
         if (m_bufferSize < 1)
             m_bufferSize = 1;
@@ -207,14 +533,165 @@ bool SessionData::getDownsampling() const
     return m_downsampling;
 }
 
-SocketHandler::SocketHandler(QObject* parent) : QObject(parent), m_server(NULL)
+void SessionData::setSharedRing(SharedSessionRing* ring)
 {
+    if (m_timer.isActive())
+        m_timer.stop();
+    delete m_ring;
+    m_ring = ring;
+    m_count = 0;
+    m_wakeupPending = false;
+}
+
+void SessionData::setMultiplexConnection(MultiplexConnection* connection, int channel)
+{
+    if (m_multiplex)
+        disconnect(m_multiplex, &MultiplexConnection::drained, this, &SessionData::socketWritable);
+    resetQueue();
+    m_multiplex = connection;
+    m_channel = channel;
+    if (m_multiplex)
+        connect(m_multiplex, &MultiplexConnection::drained, this, &SessionData::socketWritable);
+}
+
+MultiplexConnection* SessionData::multiplexConnection() const
+{
+    return m_multiplex;
+}
+
+MultiplexConnection::MultiplexConnection(QLocalSocket* socket, int queueLimit, QObject* parent)
+    : QObject(parent),
+      m_socket(socket),
+      m_outgoingOffset(0),
+      m_queueLimit(queueLimit),
+      m_refused(false),
+      m_writeNotifier(nullptr)
+{
+    m_outgoing.reserve(4096);
+}
+
+MultiplexConnection::~MultiplexConnection()
+{
+    delete m_writeNotifier;
+    delete m_socket;
+}
+
+bool MultiplexConnection::append(const char* data, int size)
+{
+    int queued = m_outgoing.size() - m_outgoingOffset;
+    if (queued && queued + size > m_queueLimit) {
+        m_refused = true;
+        return false;
+    }
+    m_outgoing.append(data, size);
+    // Frames handed over outside SocketHandler::flush(), e.g. by session
+    // timers, are sent as soon as the socket is writable
+    if (!queued)
+        watchWritable(true);
+    return true;
+}
+
+bool MultiplexConnection::hasPendingOutput() const
+{
+    return m_outgoingOffset < m_outgoing.size();
+}
+
+QLocalSocket* MultiplexConnection::getSocket() const
+{
+    return m_socket;
+}
+
+bool MultiplexConnection::flush()
+{
+    if (!hasPendingOutput())
+        return true;
+
+    int fd = m_socket->socketDescriptor();
+    while (m_outgoingOffset < m_outgoing.size()) {
+        ssize_t sent = ::send(fd, m_outgoing.constData() + m_outgoingOffset,
+                              m_outgoing.size() - m_outgoingOffset, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            qCWarning(lcSensorFw) << "[SocketHandler]: failed to write payload to the socket: " << strerror(errno);
+            m_outgoing.resize(0);
+            m_outgoingOffset = 0;
+            return false;
+        }
+        m_outgoingOffset += sent;
+    }
+
+    bool pending = hasPendingOutput();
+    if (!pending) {
+        m_outgoing.resize(0);
+        m_outgoingOffset = 0;
+    } else {
+        // Frames are appended whole, so sent bytes can be dropped at any point
+        if (m_outgoingOffset > m_outgoing.size() / 2) {
+            m_outgoing.remove(0, m_outgoingOffset);
+            m_outgoingOffset = 0;
+        }
+    }
+    watchWritable(pending);
+    return true;
+}
+
+void MultiplexConnection::watchWritable(bool enable)
+{
+    if (!m_writeNotifier) {
+        if (!enable)
+            return;
+        m_writeNotifier = new QSocketNotifier(m_socket->socketDescriptor(), QSocketNotifier::Write, this);
+        connect(m_writeNotifier, &QSocketNotifier::activated, this, &MultiplexConnection::socketWritable);
+    }
+    m_writeNotifier->setEnabled(enable);
+}
+
+void MultiplexConnection::socketWritable()
+{
+    flush();
+    if (m_refused && !hasPendingOutput()) {
+        // Let sessions hand over what they kept queued meanwhile
+        m_refused = false;
+        emit drained();
+        flush();
+    }
+}
+
+SocketHandler::SocketHandler(QObject* parent)
+    : QObject(parent),
+      m_dropPolicy(SessionData::DropOldest),
+      m_queueLimit(defaultQueueLimit),
+      m_stallTimeout_ms(defaultStallTimeout_ms),
+      m_latencySampleInterval(defaultLatencySampleInterval),
+      m_server(NULL)
+{
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+    if (config) {
+        QString policy = config->value<QString>("socket/drop_policy", dropPolicyNames[m_dropPolicy]);
+        bool known = false;
+        for (int i = 0; i <= SessionData::Disconnect; ++i) {
+            if (policy == dropPolicyNames[i]) {
+                m_dropPolicy = static_cast<SessionData::DropPolicy>(i);
+                known = true;
+            }
+        }
+        if (!known)
+            qCWarning(lcSensorFw) << "[SocketHandler]: Unknown drop policy" << policy << ", using" << dropPolicyNames[m_dropPolicy];
+        m_queueLimit = qMax(1024, config->value<int>("socket/queue_limit", defaultQueueLimit));
+        m_stallTimeout_ms = config->value<int>("socket/stall_timeout", defaultStallTimeout_ms);
+        m_latencySampleInterval = qMax(0, config->value<int>("latency/sample_interval", defaultLatencySampleInterval));
+    }
+
     m_server = new QLocalServer(this);
     connect(m_server, SIGNAL(newConnection()), this, SLOT(newConnection()));
 }
 
 SocketHandler::~SocketHandler()
 {
+    qDeleteAll(m_pendingRings);
     delete m_server;
 }
 
@@ -237,14 +714,28 @@ bool SocketHandler::listen(const QString& serverName)
     return m_server->isListening();
 }
 
-bool SocketHandler::write(int id, const void* source, int size)
+bool SocketHandler::write(int id, const void* source, int size, quint64 staged)
 {
     QMap<int, SessionData*>::iterator it = m_idMap.find(id);
     if (it == m_idMap.end()) {
         qCInfo(lcSensorFw) << "[SocketHandler]: Trying to write to nonexistent session (normal, no panic).";
         return false;
     }
-    return (*it)->write(source, size);
+    bool ret = (*it)->write(source, size, staged);
+    if ((*it)->hasPendingOutput())
+        m_dirty.insert(*it);
+    return ret;
+}
+
+void SocketHandler::flush()
+{
+    foreach (SessionData* session, m_dirty) {
+        session->flush();
+    }
+    m_dirty.clear();
+    foreach (MultiplexConnection* connection, m_multiplexed) {
+        connection->flush();
+    }
 }
 
 bool SocketHandler::removeSession(int sessionId)
@@ -264,7 +755,10 @@ bool SocketHandler::removeSession(int sessionId)
         socket->deleteLater();
     }
 
-    delete m_idMap.take(sessionId);
+    SessionData* session = m_idMap.take(sessionId);
+    m_dirty.remove(session);
+    delete session;
+    delete m_pendingRings.take(sessionId);
 
     return true;
 }
@@ -291,7 +785,7 @@ void SocketHandler::newConnection()
                 this, SLOT(socketError(QLocalSocket::LocalSocketError)));
 
         // Initialize socket
-        socket->write("\n", 1);
+        socket->write(&SENSOR_WIRE_TAG, 1);
         socket->waitForBytesWritten();
     }
 }
@@ -306,16 +800,88 @@ void SocketHandler::socketReadable()
 
     if (sessionId >= 0) {
         if (!m_idMap.contains(sessionId))
-            m_idMap.insert(sessionId, new SessionData((QLocalSocket*)sender(), this));
+            createSession(sessionId, socket);
+    } else if (sessionId == SENSOR_WIRE_MULTIPLEX) {
+        qCDebug(lcSensorFw) << "[SocketHandler]: New multiplexed connection.";
+        MultiplexConnection* connection = new MultiplexConnection(socket, m_queueLimit, this);
+        m_multiplexed.insert(socket, connection);
+        connect(socket, SIGNAL(readyRead()), this, SLOT(multiplexReadable()));
+        readAttachRequests(connection);
     } else {
         qCCritical(lcSensorFw) << "[SocketHandler]: Failed to read valid session ID from client. Closing socket.";
         socket->abort();
     }
 }
 
+SessionData* SocketHandler::createSession(int sessionId, QLocalSocket* socket)
+{
+    SessionData* session = new SessionData(socket, this);
+    session->setQueuePolicy(m_dropPolicy, m_queueLimit, m_stallTimeout_ms);
+    session->setLatencySampleInterval(m_latencySampleInterval);
+    connect(session, SIGNAL(stalled()), this, SLOT(sessionStalled()), Qt::QueuedConnection);
+    SharedSessionRing* ring = m_pendingRings.take(sessionId);
+    if (ring)
+        session->setSharedRing(ring);
+    m_idMap.insert(sessionId, session);
+    return session;
+}
+
+void SocketHandler::multiplexReadable()
+{
+    MultiplexConnection* connection = m_multiplexed.value((QLocalSocket*)sender());
+    if (connection)
+        readAttachRequests(connection);
+}
+
+void SocketHandler::readAttachRequests(MultiplexConnection* connection)
+{
+    QLocalSocket* socket = connection->getSocket();
+    while (socket->bytesAvailable() >= (qint64)sizeof(int)) {
+        int sessionId = -1;
+        socket->read((char*)&sessionId, sizeof(int));
+        if (sessionId < 0) {
+            qCWarning(lcSensorFw) << "[SocketHandler]: Invalid session ID on multiplexed connection.";
+            continue;
+        }
+        QMap<int, SessionData*>::const_iterator it = m_idMap.constFind(sessionId);
+        if (it != m_idMap.constEnd()) {
+            if ((*it)->multiplexConnection() != connection)
+                qCWarning(lcSensorFw) << "[SocketHandler]: Session" << sessionId << "is already connected.";
+            continue;
+        }
+        createSession(sessionId, nullptr)->setMultiplexConnection(connection, sessionId);
+        qCDebug(lcSensorFw) << "[SocketHandler]: Session" << sessionId << "attached to multiplexed connection.";
+    }
+}
+
+bool SocketHandler::multiplexDisconnected(QLocalSocket* socket)
+{
+    MultiplexConnection* connection = m_multiplexed.take(socket);
+    if (!connection)
+        return false;
+
+    QList<int> lost;
+    for (QMap<int, SessionData*>::const_iterator it = m_idMap.constBegin(); it != m_idMap.constEnd(); ++it) {
+        if (it.value()->multiplexConnection() == connection) {
+            it.value()->setMultiplexConnection(nullptr, -1);
+            lost.append(it.key());
+        }
+    }
+    // Socket is owned by the connection and is emitting the signal
+    connection->deleteLater();
+
+    foreach (int sessionId, lost) {
+        qCWarning(lcSensorFw) << "[SocketHandler]: Noticed lost session: " << sessionId;
+        emit lostSession(sessionId);
+    }
+    return true;
+}
+
 void SocketHandler::socketDisconnected()
 {
     QLocalSocket* socket = (QLocalSocket*)sender();
+    if (multiplexDisconnected(socket))
+        return;
 
     int sessionId = -1;
     for (QMap<int, SessionData*>::const_iterator it = m_idMap.constBegin(); it != m_idMap.constEnd(); ++it) {
@@ -332,6 +898,17 @@ void SocketHandler::socketDisconnected()
     emit lostSession(sessionId);
 }
 
+void SocketHandler::sessionStalled()
+{
+    SessionData* session = qobject_cast<SessionData*>(sender());
+    int sessionId = m_idMap.key(session, -1);
+    if (sessionId == -1)
+        return;
+
+    qCWarning(lcSensorFw) << "[SocketHandler]: Session" << sessionId << "stalled, disconnecting";
+    emit lostSession(sessionId);
+}
+
 void SocketHandler::socketError(QLocalSocket::LocalSocketError socketError)
 {
     qCWarning(lcSensorFw) << "[SocketHandler]: Socket error: " << socketError;
@@ -341,8 +918,12 @@ void SocketHandler::socketError(QLocalSocket::LocalSocketError socketError)
 int SocketHandler::getSocketFd(int sessionId) const
 {
     QMap<int, SessionData*>::const_iterator it = m_idMap.find(sessionId);
-    if (it != m_idMap.end() && (*it)->getSocket())
-        return (*it)->getSocket()->socketDescriptor();
+    if (it != m_idMap.end()) {
+        if ((*it)->getSocket())
+            return (*it)->getSocket()->socketDescriptor();
+        if ((*it)->multiplexConnection())
+            return (*it)->multiplexConnection()->getSocket()->socketDescriptor();
+    }
     return 0;
 }
 
@@ -422,3 +1003,37 @@ void SocketHandler::setDownsampling(int sessionId, bool value)
     if (it != m_idMap.end())
         (*it)->setBufferInterval(value);
 }
+
+QVariantMap SocketHandler::sessionStatistics(int sessionId) const
+{
+    QMap<int, SessionData*>::const_iterator it = m_idMap.find(sessionId);
+    if (it != m_idMap.end())
+        return (*it)->statistics();
+    return QVariantMap();
+}
+
+QList<int> SocketHandler::sessions() const
+{
+    return m_idMap.keys();
+}
+
+int SocketHandler::openSharedRing(int sessionId)
+{
+    SharedSessionRing* ring = new SharedSessionRing();
+    if (!ring->isValid()) {
+        qCWarning(lcSensorFw) << "[SocketHandler]: Failed to create shared ring for session" << sessionId;
+        delete ring;
+        return -1;
+    }
+
+    int fd = ring->fd();
+    QMap<int, SessionData*>::iterator it = m_idMap.find(sessionId);
+    if (it != m_idMap.end()) {
+        (*it)->setSharedRing(ring);
+    } else {
+        delete m_pendingRings.take(sessionId);
+        m_pendingRings.insert(sessionId, ring);
+    }
+    qCInfo(lcSensorFw) << "[SocketHandler]: Session" << sessionId << "uses shared memory transport";
+    return fd;
+}
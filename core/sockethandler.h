@@ -34,13 +34,30 @@
 #include <QList>
 #include <QMutex>
 #include <QLocalSocket>
+#include <QByteArray>
+#include <QSet>
+#include <QVector>
+#include <QVariantMap>
 #include <sys/time.h>
+#include "latencyhistogram.h"
 
 class QLocalServer;
+class QSocketNotifier;
+class SharedSessionRing;
+class MultiplexConnection;
 
 /**
  * Class contains data for single sensor session related data socket
  * connection.
+ *
+ * Frames are not written to the socket one by one. They are appended to
+ * an outgoing queue which is sent with a single non-blocking send() when
+ * flush() is called, normally once per event loop dispatch. If the client
+ * does not keep up, the rest of the queue is sent when the socket becomes
+ * writable again, and the daemon never waits for the client.
+ *
+ * The queue is bounded. What happens when it is full is decided by the
+ * session's DropPolicy.
  */
 class SessionData : public QObject
 {
@@ -48,6 +65,16 @@ class SessionData : public QObject
     Q_DISABLE_COPY(SessionData)
 
 public:
+    /**
+     * What to do with frames when the outgoing queue is full.
+     */
+    enum DropPolicy {
+        DropOldest, /**< discard oldest queued frames to make room */
+        DropNewest, /**< discard the frame being queued */
+        Decimate,   /**< queue only every second frame when congested */
+        Disconnect  /**< discard new frames, disconnect if stalled too long */
+    };
+
     /**
      * Constructor.
      *
@@ -67,10 +94,63 @@ public:
      *
      * @param source Source from where to write.
      * @param size How many bytes to write from source.
+     * @param staged CLOCK_MONOTONIC time the sample was staged, 0 if not
+     *               measured.
      * @return was data succesfully written.
      */
-    bool write(const void* source, int size);
+    bool write(const void* source, int size, quint64 staged = 0);
+
+    /**
+     * Send queued frames to the socket without blocking.
+     *
+     * @return \c false if the socket failed.
+     */
+    bool flush();
+
+    /**
+     * Are there queued frames not yet sent to the socket.
+     *
+     * @return is outgoing queue non-empty.
+     */
+    bool hasPendingOutput() const;
 
+    /**
+     * Set limits for the outgoing queue.
+     *
+     * @param policy Policy applied when the queue is full.
+     * @param limit Maximum number of queued bytes.
+     * @param stallTimeout_ms How long the client may not read before it
+     *                        is disconnected. Used with Disconnect policy.
+     */
+    void setQueuePolicy(DropPolicy policy, int limit, int stallTimeout_ms);
+
+    /**
+     * Set how often the time from queueing to sending is measured. Time
+     * spent before queueing is measured for samples stamped by the
+     * staging area.
+     *
+     * @param interval Measure every this many frames, 0 disables.
+     */
+    void setLatencySampleInterval(unsigned int interval);
+
+    /**
+     * Get queue statistics.
+     *
+     * @return map with queuedFrames, queuedBytes, droppedFrames and
+     *         dropPolicy entries, and queueLatency and sendLatency
+     *         summaries of time from staging until written to the
+     *         session and from queueing until sent to the client.
+     */
+    QVariantMap statistics() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when client has not read data for longer than allowed.
+     * Emitted through queued connection only once per session.
+     */
+    void stalled();
+
+public:
     /**
      * Get used local socket pointer.
      *
@@ -146,6 +226,32 @@ public:
      */
     bool getDownsampling() const;
 
+    /**
+     * Deliver samples through shared memory ring instead of the socket.
+     * Socket will only carry wakeup notifications after this.
+     *
+     * @param ring Shared ring. SessionData will take the ownership of it.
+     */
+    void setSharedRing(SharedSessionRing* ring);
+
+    /**
+     * Deliver frames through a connection shared with other sessions.
+     * Frames are tagged with \a channel and handed over to the connection
+     * on flush(). Queue limits and drop policy keep applying to frames
+     * the connection has not accepted yet.
+     *
+     * @param connection Shared connection or \c NULL to detach.
+     * @param channel Channel ID written with every frame.
+     */
+    void setMultiplexConnection(MultiplexConnection* connection, int channel);
+
+    /**
+     * Get shared connection the session is attached to.
+     *
+     * @return connection or NULL if session has its own socket.
+     */
+    MultiplexConnection* multiplexConnection() const;
+
 private:
     /**
      * How many milliseconds since last time data was written to socket.
@@ -156,13 +262,70 @@ private:
     long sinceLastWrite() const;
 
     /**
-     * Write data directly to the socket.
+     * Append frame to the outgoing queue.
      *
-     * @param source Source from where to write.
-     * @param size How many bytes to write.
+     * @param source Location of the data elements.
+     * @param size Size of a single data element.
+     * @param count How many data elements are written.
+     * @return was frame queued.
+     */
+    bool queueFrame(const void* source, int size, unsigned int count);
+
+    /**
+     * Move partially filled buffer into the outgoing queue.
+     */
+    void queueBuffered();
+
+    /**
+     * Size of the header written in front of every frame.
+     *
+     * @return header size in bytes.
+     */
+    int frameHeaderSize() const;
+
+    /**
+     * Hand queued frames over to the shared connection. Frames are kept
+     * queued if the connection does not accept them.
+     */
+    void flushToMultiplex();
+
+    /**
+     * Append frame to the queue without checking limits.
+     *
+     * @param source Location of the data elements.
+     * @param bytes Size of all data elements.
      * @param count How many data elements are written.
      */
-    bool write(void* source, int size, unsigned int count);
+    void appendFrame(const void* source, int bytes, unsigned int count);
+
+    /**
+     * Discard unsent frames from the beginning of the queue until there
+     * is given amount of room left.
+     *
+     * @param bytes Required room.
+     * @return was enough room made.
+     */
+    bool dropOldest(int bytes);
+
+    /**
+     * Record send latency of the traced sample if it has been sent.
+     */
+    void recordSent();
+
+    /**
+     * Empty outgoing queue.
+     */
+    void resetQueue();
+
+    /**
+     * Remove already sent bytes from the beginning of the queue.
+     */
+    void compactQueue();
+
+    /**
+     * Report stalled client if it has not read for too long.
+     */
+    void checkStall();
 
     /**
      * Delayed write invocation.
@@ -171,6 +334,22 @@ private:
      */
     bool delayedWrite();
 
+    /**
+     * Publish sample into the shared ring.
+     *
+     * @param source Source from where to write.
+     * @param size How many bytes to write.
+     * @return was sample published.
+     */
+    bool writeToRing(const void* source, int size);
+
+    /**
+     * Notify client about new samples in the shared ring.
+     *
+     * @return was notification written to socket.
+     */
+    bool writeWakeup();
+
     QLocalSocket *m_socket;           /**< socket pointer. */
     int m_interval_us;                /**< interval in milliseconds. */
     char *m_buffer;                   /**< pointer to buffer allocation. */
@@ -181,6 +360,27 @@ private:
     unsigned int m_bufferSize;        /**< buffer size */
     unsigned int m_bufferInterval_us; /**< buffer interval in milliseconds */
     bool m_downsampling;              /**< sample dropping */
+    SharedSessionRing *m_ring;        /**< shared memory ring, if used */
+    bool m_wakeupPending;             /**< client waits for ring notification */
+    QByteArray m_outgoing;            /**< frames waiting to be sent */
+    int m_outgoingOffset;             /**< bytes of m_outgoing already sent */
+    QSocketNotifier *m_writeNotifier; /**< notifier for writable socket */
+    QVector<int> m_frameOffsets;      /**< start offsets of queued frames */
+    int m_firstFrame;                 /**< first entry of m_frameOffsets still queued */
+    DropPolicy m_dropPolicy;          /**< policy for full queue */
+    int m_queueLimit;                 /**< maximum queued bytes */
+    int m_stallTimeout_ms;            /**< allowed stall before disconnect */
+    struct timeval m_lastProgress;    /**< when client last read or queue was empty */
+    bool m_decimateSkip;              /**< skip next frame when decimating */
+    bool m_stallReported;             /**< stalled() has been emitted */
+    unsigned int m_droppedFrames;     /**< frames dropped because client lags */
+    unsigned int m_dropBurst;         /**< frames dropped since last successful queueing */
+    MultiplexConnection *m_multiplex; /**< shared connection, if used */
+    int m_channel;                    /**< channel ID on shared connection */
+    LatencyHistogram m_queueLatency;  /**< staging to session write */
+    LatencyHistogram m_sendLatency;   /**< session queue to client */
+    quint64 m_tracedQueued;           /**< time traced frame was queued */
+    int m_tracedEnd;                  /**< queue offset after traced sample, -1 if none */
 
 private slots:
 
@@ -188,6 +388,101 @@ private slots:
      * Callback for delayed write timer.
      */
     void timerTimeout();
+
+    /**
+     * Callback for socket becoming writable again.
+     */
+    void socketWritable();
+};
+
+/**
+ * Data connection shared by several sessions of one client. Sessions
+ * hand over complete frames, tagged with their channel ID, and the
+ * connection sends them with a single non-blocking send() per flush.
+ * The connection accepts frames only while its own backlog is below the
+ * queue limit, so drop policies of the sessions decide what happens
+ * when the client does not keep up.
+ */
+class MultiplexConnection : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(MultiplexConnection)
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param socket Established socket connection. MultiplexConnection
+     *               will take the ownership of it.
+     * @param queueLimit Backlog after which frames are not accepted.
+     * @param parent Parent object.
+     */
+    MultiplexConnection(QLocalSocket* socket, int queueLimit, QObject* parent = 0);
+
+    /**
+     * Destructor.
+     */
+    virtual ~MultiplexConnection();
+
+    /**
+     * Append complete frames to the outgoing queue. They are sent by the
+     * next flush(), or once the socket is writable if no flush follows.
+     *
+     * @param data Location of the frames.
+     * @param size Size of the frames in bytes.
+     * @return were frames accepted. Frames are always accepted when
+     *         the queue is empty.
+     */
+    bool append(const char* data, int size);
+
+    /**
+     * Send queued frames to the socket without blocking.
+     *
+     * @return \c false if the socket failed.
+     */
+    bool flush();
+
+    /**
+     * Are there queued frames not yet sent to the socket.
+     *
+     * @return is outgoing queue non-empty.
+     */
+    bool hasPendingOutput() const;
+
+    /**
+     * Get used local socket pointer.
+     *
+     * @return local socket.
+     */
+    QLocalSocket* getSocket() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when the outgoing queue has been sent completely after
+     * frames were refused.
+     */
+    void drained();
+
+private slots:
+    /**
+     * Callback for socket becoming writable again.
+     */
+    void socketWritable();
+
+private:
+    /**
+     * Get notified when the socket becomes writable.
+     *
+     * @param enable is there output waiting for the socket.
+     */
+    void watchWritable(bool enable);
+
+    QLocalSocket *m_socket;           /**< socket pointer. */
+    QByteArray m_outgoing;            /**< frames waiting to be sent */
+    int m_outgoingOffset;             /**< bytes of m_outgoing already sent */
+    int m_queueLimit;                 /**< backlog after which frames are refused */
+    bool m_refused;                   /**< frames were refused since last drain */
+    QSocketNotifier *m_writeNotifier; /**< notifier for writable socket */
 };
 
 /**
@@ -225,8 +520,16 @@ public:
      * @param id Session ID.
      * @param source Location from where to write.
      * @param size How many bytes to write.
+     * @param staged CLOCK_MONOTONIC time the sample was staged, 0 if not
+     *               measured.
      */
-    bool write(int id, const void* source, int size);
+    bool write(int id, const void* source, int size, quint64 staged = 0);
+
+    /**
+     * Send data queued by write() calls to the sockets. Each session with
+     * pending data is written with one system call.
+     */
+    void flush();
 
     /**
      * Close related socket connection for session.
@@ -346,6 +649,32 @@ public:
      */
     void setDownsampling(int sessionId, bool value);
 
+    /**
+     * Get outgoing queue statistics for given session. For more details
+     * see #SessionData::statistics().
+     *
+     * @param sessionId Session ID.
+     * @return statistics or empty map for unknown session.
+     */
+    QVariantMap sessionStatistics(int sessionId) const;
+
+    /**
+     * Get sessions with established socket connection.
+     *
+     * @return session IDs.
+     */
+    QList<int> sessions() const;
+
+    /**
+     * Switch given session to shared memory transport. The ring is attached
+     * to the session when its socket connection gets established.
+     *
+     * @param sessionId Session ID.
+     * @return memfd of the ring or -1 on failure. The descriptor stays
+     *         owned by the socket handler.
+     */
+    int openSharedRing(int sessionId);
+
 Q_SIGNALS:
     /**
      * Signal is emitted for new client connection after it sent the
@@ -386,10 +715,51 @@ private slots:
      */
     void socketError(QLocalSocket::LocalSocketError socketError);
 
+    /**
+     * Callback for new attach requests in multiplexed connection.
+     */
+    void multiplexReadable();
+
+    /**
+     * Callback for session whose client stopped reading.
+     */
+    void sessionStalled();
+
 private:
+    /**
+     * Create data for newly connected session.
+     *
+     * @param sessionId Session ID.
+     * @param socket Socket of the session or NULL for multiplexed session.
+     * @return created session.
+     */
+    SessionData* createSession(int sessionId, QLocalSocket* socket);
+
+    /**
+     * Attach sessions requested by the client to multiplexed connection.
+     *
+     * @param connection Multiplexed connection.
+     */
+    void readAttachRequests(MultiplexConnection* connection);
+
+    /**
+     * Handle lost multiplexed connection.
+     *
+     * @param socket Socket of the connection.
+     * @return was socket a multiplexed connection.
+     */
+    bool multiplexDisconnected(QLocalSocket* socket);
+
+    SessionData::DropPolicy  m_dropPolicy;      /**< policy for new sessions */
+    int                      m_queueLimit;      /**< queue limit for new sessions */
+    int                      m_stallTimeout_ms; /**< stall timeout for new sessions */
+    int                      m_latencySampleInterval; /**< latency sampling for new sessions */
 
     QLocalServer*            m_server; /**< listening server socket. */
     QMap<int, SessionData*>  m_idMap;  /**< map of client sessions. */
+    QMap<int, SharedSessionRing*> m_pendingRings; /**< rings for sessions not yet connected. */
+    QSet<SessionData*>       m_dirty;  /**< sessions with queued frames. */
+    QMap<QLocalSocket*, MultiplexConnection*> m_multiplexed; /**< multiplexed connections. */
 };
 
 #endif // SOCKETHANDLER_H
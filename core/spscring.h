@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (c) 2026 Jolla Mobile Ltd
+**
+**
+** $QT_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <QtGlobal>
+#include <algorithm>
+#include <atomic>
+
+/**
+ * Lock-free single producer, single consumer ring.
+ *
+ * Used for handing samples from a reader thread over to the main thread
+ * without locks or system calls per sample. Exactly one thread may act
+ * as producer and one as consumer at any given time.
+ *
+ * Both sides work on contiguous spans: the producer reserves slots,
+ * fills them in place and commits them; the consumer peeks at committed
+ * slots, processes them in place and releases them. Index updates use
+ * sequentially consistent ordering so that commit() can reliably tell
+ * whether the consumer may have gone idle and needs to be woken up.
+ *
+ * @tparam TYPE element type, must be default constructible and assignable.
+ */
+template <class TYPE>
+class SpscRing
+{
+    Q_DISABLE_COPY(SpscRing)
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param size number of elements, rounded up to a power of two.
+     */
+    explicit SpscRing(unsigned size)
+        : m_size(roundUpToPowerOfTwo(size))
+        , m_mask(m_size - 1)
+        , m_data(new TYPE[m_size])
+        , m_head(0)
+        , m_tail(0)
+    {
+    }
+
+    /**
+     * Destructor.
+     */
+    ~SpscRing()
+    {
+        delete[] m_data;
+    }
+
+    /**
+     * Capacity of the ring.
+     */
+    unsigned size() const { return m_size; }
+
+    /**
+     * Producer: get contiguous free slots. Fewer slots than requested are
+     * granted when the ring is nearly full or the span would wrap.
+     *
+     * @param n number of slots wanted.
+     * @param granted set to number of slots available.
+     * @return first free slot.
+     */
+    TYPE *reserve(unsigned n, unsigned &granted)
+    {
+        unsigned head = m_head.load(std::memory_order_relaxed);
+        unsigned tail = m_tail.load(std::memory_order_acquire);
+        unsigned start = head & m_mask;
+        granted = std::min(std::min(n, m_size - (head - tail)), m_size - start);
+        return &m_data[start];
+    }
+
+    /**
+     * Producer: publish slots filled after reserve().
+     *
+     * @param n number of slots to publish.
+     * @return \c true if the ring was empty before, ie. the consumer may
+     *         be idle and should be woken up.
+     */
+    bool commit(unsigned n)
+    {
+        unsigned head = m_head.load(std::memory_order_relaxed);
+        m_head.store(head + n, std::memory_order_seq_cst);
+        return m_tail.load(std::memory_order_seq_cst) == head;
+    }
+
+    /**
+     * Producer: copy elements into the ring.
+     *
+     * @param values elements to copy.
+     * @param n number of elements.
+     * @param wakeup set to \c true if the consumer should be woken up.
+     * @return number of elements copied, less than n if the ring is full.
+     */
+    unsigned push(const TYPE *values, unsigned n, bool &wakeup)
+    {
+        unsigned pushed = 0;
+        wakeup = false;
+        while (pushed < n) {
+            unsigned granted;
+            TYPE *slot = reserve(n - pushed, granted);
+            if (!granted)
+                break;
+            std::copy(values + pushed, values + pushed + granted, slot);
+            wakeup |= commit(granted);
+            pushed += granted;
+        }
+        return pushed;
+    }
+
+    /**
+     * Consumer: get contiguous published elements. The elements stay
+     * valid until release().
+     *
+     * @param available set to number of elements in the span.
+     * @return first element.
+     */
+    const TYPE *peek(unsigned &available) const
+    {
+        unsigned tail = m_tail.load(std::memory_order_relaxed);
+        unsigned head = m_head.load(std::memory_order_seq_cst);
+        unsigned start = tail & m_mask;
+        available = std::min(head - tail, m_size - start);
+        return &m_data[start];
+    }
+
+    /**
+     * Consumer: return processed elements to the producer.
+     *
+     * @param n number of elements.
+     */
+    void release(unsigned n)
+    {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + n, std::memory_order_seq_cst);
+    }
+
+private:
+    static unsigned roundUpToPowerOfTwo(unsigned value)
+    {
+        unsigned size = 1;
+        while (size < value)
+            size <<= 1;
+        return size;
+    }
+
+    const unsigned m_size;  /**< capacity, power of two */
+    const unsigned m_mask;  /**< index mask */
+    TYPE          *m_data;  /**< storage */
+
+    alignas(64) std::atomic<unsigned> m_head; /**< written by producer */
+    alignas(64) std::atomic<unsigned> m_tail; /**< written by consumer */
+};
+
+#endif // SPSCRING_H
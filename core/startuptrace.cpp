@@ -0,0 +1,166 @@
+/**
+   @file startuptrace.cpp
+   @brief Trace of sensord startup
+
+   <p>
+   Copyright (c) 2026 Jolla Mobile Ltd
+
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "startuptrace.h"
+#include "logging.h"
+#include "datatypes/utils.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace {
+
+/** Largest number of recorded spans. */
+const int maxEvents = 2048;
+
+/**
+ * Single recorded span. Marks have no duration.
+ */
+struct Event
+{
+    const char *category; /**< kind of the span */
+    QString name;         /**< name of the span */
+    quint64 start;        /**< start time in microseconds */
+    quint64 duration;     /**< length in microseconds, -1 for marks */
+    int thread;           /**< recording thread */
+};
+
+QMutex traceMutex;
+QVector<Event> traceEvents;
+int droppedEvents = 0;
+
+void append(const char *category, const QString &name, quint64 start, quint64 duration)
+{
+    int thread = syscall(SYS_gettid);
+    QMutexLocker locker(&traceMutex);
+    if (traceEvents.size() >= maxEvents) {
+        ++droppedEvents;
+        return;
+    }
+    if (traceEvents.isEmpty())
+        traceEvents.reserve(256);
+    Event event = { category, name, start, duration, thread };
+    traceEvents.append(event);
+}
+
+bool startsBefore(const Event &a, const Event &b)
+{
+    return a.start < b.start;
+}
+
+}
+
+StartupTrace::Scope::Scope(const char *category, const QString &name)
+    : m_category(category)
+    , m_name(name)
+    , m_start(Utils::getTimeStamp())
+{
+}
+
+StartupTrace::Scope::~Scope()
+{
+    record(m_category, m_name, m_start, Utils::getTimeStamp());
+}
+
+void StartupTrace::mark(const char *category, const QString &name)
+{
+    append(category, name, Utils::getTimeStamp(), quint64(-1));
+}
+
+void StartupTrace::record(const char *category, const QString &name, quint64 start, quint64 end)
+{
+    append(category, name, start, end >= start ? end - start : 0);
+}
+
+QStringList StartupTrace::printStatus()
+{
+    QMutexLocker locker(&traceMutex);
+    QStringList output;
+    if (traceEvents.isEmpty())
+        return output;
+
+    /* Spans are recorded when they end, show them in start order */
+    QVector<Event> events(traceEvents);
+    std::stable_sort(events.begin(), events.end(), startsBefore);
+    const quint64 origin = events.first().start;
+    output << QString("Startup trace, monotonic origin %1 us:").arg(origin);
+    foreach (const Event &event, events) {
+        QString line = QString("  +%1 ms %2 %3")
+            .arg((event.start - origin) / 1000.0, 0, 'f', 1)
+            .arg(event.category)
+            .arg(event.name);
+        if (event.duration != quint64(-1))
+            line += QString(": %1 ms").arg(event.duration / 1000.0, 0, 'f', 1);
+        output << line;
+    }
+    if (droppedEvents)
+        output << QString("  %1 later events not recorded").arg(droppedEvents);
+    return output;
+}
+
+bool StartupTrace::writeChromeTrace(const QString &path)
+{
+    QJsonArray array;
+    {
+        QMutexLocker locker(&traceMutex);
+        const qint64 pid = getpid();
+        foreach (const Event &event, traceEvents) {
+            QJsonObject object;
+            object.insert("name", event.name);
+            object.insert("cat", QString::fromLatin1(event.category));
+            object.insert("ts", qint64(event.start));
+            object.insert("pid", pid);
+            object.insert("tid", event.thread);
+            if (event.duration == quint64(-1)) {
+                object.insert("ph", QStringLiteral("i"));
+                object.insert("s", QStringLiteral("p"));
+            } else {
+                object.insert("ph", QStringLiteral("X"));
+                object.insert("dur", qint64(event.duration));
+            }
+            array.append(object);
+        }
+    }
+
+    QJsonObject trace;
+    trace.insert("traceEvents", array);
+    trace.insert("displayTimeUnit", QStringLiteral("ms"));
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) < 0
+        || !file.commit()) {
+        qCWarning(lcSensorFw) << "Unable to write startup trace" << path << ":" << file.errorString();
+        return false;
+    }
+    qCInfo(lcSensorFw) << "Startup trace written to" << path;
+    return true;
+}
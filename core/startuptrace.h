@@ -0,0 +1,105 @@
+/**
+   @file startuptrace.h
+   @brief Trace of sensord startup
+
+   <p>
+   Copyright (c) 2026 Jolla Mobile Ltd
+
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef STARTUP_TRACE_H
+#define STARTUP_TRACE_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * Trace of where the time goes while sensord starts.
+ *
+ * Startup phases, plugin loads and backend calls are recorded as spans
+ * of monotonic time. Recording takes two clock reads and a locked append,
+ * and stops once a fixed number of spans has been recorded, so the trace
+ * can stay enabled for the whole lifetime of the daemon.
+ *
+ * Spans can be recorded from any thread.
+ */
+class StartupTrace
+{
+public:
+    /**
+     * Records the time from construction to destruction as a span.
+     */
+    class Scope
+    {
+    public:
+        /**
+         * Constructor. Starts the span.
+         *
+         * @param category Kind of the span, e.g. "plugin".
+         * @param name Name of the span.
+         */
+        Scope(const char *category, const QString &name);
+
+        /**
+         * Destructor. Ends and records the span.
+         */
+        ~Scope();
+
+    private:
+        Q_DISABLE_COPY(Scope)
+
+        const char *m_category; /**< kind of the span */
+        QString m_name;         /**< name of the span */
+        quint64 m_start;        /**< start time in microseconds */
+    };
+
+    /**
+     * Record a point in time, e.g. reaching a milestone.
+     *
+     * @param category Kind of the event.
+     * @param name Name of the event.
+     */
+    static void mark(const char *category, const QString &name);
+
+    /**
+     * Record a span.
+     *
+     * @param category Kind of the span.
+     * @param name Name of the span.
+     * @param start Start time in microseconds.
+     * @param end End time in microseconds.
+     */
+    static void record(const char *category, const QString &name, quint64 start, quint64 end);
+
+    /**
+     * Recorded spans in human readable form, relative to the first one.
+     *
+     * @return list of lines.
+     */
+    static QStringList printStatus();
+
+    /**
+     * Write recorded spans as Chrome trace event JSON, which can be
+     * opened e.g. in Perfetto or chrome://tracing.
+     *
+     * @param path File to write to.
+     * @return was the file written.
+     */
+    static bool writeChromeTrace(const QString &path);
+};
+
+#endif // STARTUP_TRACE_H
@@ -32,6 +32,8 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <time.h>
 #include <unistd.h>
 #include <QFile>
 #include "logging.h"
@@ -305,10 +307,10 @@ void SysfsAdaptor::stopReaderThread()
         ssize_t bytesWritten = write(m_pipeDescriptors[1], &dummy, 8);
         if (!bytesWritten)
             qWarning() << id() << "Could not write pipe descriptors";
+        m_reader.wait();
+    } else {
+        SysfsIntervalLoop::instance().remove(this);
     }
-    else
-        m_reader.stopReader();
-    m_reader.wait();
 }
 
 bool SysfsAdaptor::startReaderThread()
@@ -318,11 +320,30 @@ bool SysfsAdaptor::startReaderThread()
         return false;
     }
 
-    m_reader.startReader();
+    if (m_mode == SelectMode) {
+        m_reader.startReader();
+    } else if (!SysfsIntervalLoop::instance().add(this, m_interval_us)) {
+        closeAllFds();
+        return false;
+    }
 
     return true;
 }
 
+void SysfsAdaptor::readIntervalSamples()
+{
+    for (int i = 0; i < m_sysfsDescriptors.size(); ++i) {
+        processSample(m_pathIds.at(i), m_sysfsDescriptors.at(i));
+
+        // Adaptors using pread() turn seeking off
+        if (m_doSeek) {
+            if (lseek(m_sysfsDescriptors.at(i), 0, SEEK_SET) == -1) {
+                qCWarning(lcSensorFw) << id() << "Failed to lseek fd: " << strerror(errno);
+            }
+        }
+    }
+}
+
 bool SysfsAdaptor::writeToFile(const QByteArray& path, const QByteArray& content)
 {
     qCDebug(lcSensorFw) << "Writing to '" << path << ": " << content;
@@ -385,6 +406,8 @@ bool SysfsAdaptor::setInterval(const int sessionId, const unsigned int interval_
     if (!checkIntervalUsage())
         return false;
     m_interval_us = interval_us;
+    if (m_mode == IntervalMode)
+        SysfsIntervalLoop::instance().setInterval(this, interval_us);
     return true;
 }
 
@@ -393,14 +416,19 @@ SysfsAdaptor::PollMode SysfsAdaptor::mode() const
     return m_mode;
 }
 
-SysfsAdaptorReader::SysfsAdaptorReader(SysfsAdaptor *parent)
-    : m_running(false), m_parent(parent)
+void SysfsAdaptor::setMode(PollMode mode)
 {
+    m_mode = mode;
 }
 
-void SysfsAdaptorReader::stopReader()
+void SysfsAdaptor::setSeek(bool seek)
+{
+    m_doSeek = seek;
+}
+
+SysfsAdaptorReader::SysfsAdaptorReader(SysfsAdaptor *parent)
+    : m_running(false), m_parent(parent)
 {
-    m_running = false;
 }
 
 void SysfsAdaptorReader::startReader()
@@ -448,23 +476,157 @@ void SysfsAdaptorReader::run()
                 if (errorInInput)
                     QThread::msleep(50);
             }
-        } else { //IntervalMode
+        }
+    }
+}
 
-            // Read through all fds.
-            for (int i = 0; i < m_parent->m_sysfsDescriptors.size(); ++i) {
-                m_parent->processSample(m_parent->m_pathIds.at(i), m_parent->m_sysfsDescriptors.at(i));
+SysfsIntervalLoop &SysfsIntervalLoop::instance()
+{
+    // Never deleted, the thread runs until the process exits
+    static SysfsIntervalLoop *loop = new SysfsIntervalLoop();
+    return *loop;
+}
 
-                if (m_parent->m_doSeek) {
-                    if (lseek(m_parent->m_sysfsDescriptors.at(i), 0, SEEK_SET) == -1) {
-                        qCWarning(lcSensorFw) << m_parent->id() << "Failed to lseek fd: " << strerror(errno);
-                        QThread::msleep(1000);
-                    }
-                }
+SysfsIntervalLoop::SysfsIntervalLoop()
+    : m_epollDescriptor(epoll_create1(EPOLL_CLOEXEC))
+    , m_nextToken(1)
+    , m_readingToken(0)
+{
+    if (m_epollDescriptor == -1) {
+        qCWarning(lcSensorFw) << "SysfsIntervalLoop epoll_create1(): " << strerror(errno);
+    }
+}
+
+bool SysfsIntervalLoop::add(SysfsAdaptor *adaptor, unsigned int interval_us)
+{
+    if (m_epollDescriptor == -1)
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+    if (m_tokens.contains(adaptor))
+        return true;
+
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd == -1) {
+        qCWarning(lcSensorFw) << adaptor->id() << "timerfd_create(): " << strerror(errno);
+        return false;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(epoll_event));
+    ev.events = EPOLLIN;
+    ev.data.u64 = m_nextToken;
+    if (!armTimer(fd, interval_us) || epoll_ctl(m_epollDescriptor, EPOLL_CTL_ADD, fd, &ev) == -1) {
+        qCWarning(lcSensorFw) << adaptor->id() << "Failed to set up interval timer: " << strerror(errno);
+        close(fd);
+        return false;
+    }
+
+    Entry entry;
+    entry.adaptor = adaptor;
+    entry.timerFd = fd;
+    m_entries.insert(m_nextToken, entry);
+    m_tokens.insert(adaptor, m_nextToken);
+    ++m_nextToken;
+
+    if (!isRunning())
+        start();
+    return true;
+}
+
+void SysfsIntervalLoop::setInterval(SysfsAdaptor *adaptor, unsigned int interval_us)
+{
+    QMutexLocker locker(&m_mutex);
+    QHash<SysfsAdaptor *, quint64>::const_iterator token = m_tokens.constFind(adaptor);
+    if (token != m_tokens.constEnd() && !armTimer(m_entries.value(*token).timerFd, interval_us)) {
+        qCWarning(lcSensorFw) << adaptor->id() << "timerfd_settime(): " << strerror(errno);
+    }
+}
+
+void SysfsIntervalLoop::remove(SysfsAdaptor *adaptor)
+{
+    QMutexLocker locker(&m_mutex);
+    quint64 token = m_tokens.take(adaptor);
+    if (!token)
+        return;
+
+    Entry entry = m_entries.take(token);
+    epoll_ctl(m_epollDescriptor, EPOLL_CTL_DEL, entry.timerFd, 0);
+    close(entry.timerFd);
+
+    // Wait for the adaptor to be read, if the loop is reading it
+    while (m_readingToken == token)
+        m_readDone.wait(&m_mutex);
+}
+
+bool SysfsIntervalLoop::armTimer(int fd, unsigned int interval_us)
+{
+    // Reading as fast as possible used to spin, settle for 1 kHz instead
+    if (interval_us == 0)
+        interval_us = 1000;
+
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_interval.tv_sec = interval_us / 1000000;
+    spec.it_interval.tv_nsec = (interval_us % 1000000) * 1000;
+
+    // First deadline is now, the following ones advance from it by the
+    // interval regardless of when the loop gets to reading
+    if (clock_gettime(CLOCK_MONOTONIC, &spec.it_value) == -1)
+        return false;
+    return timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, 0) == 0;
+}
+
+void SysfsIntervalLoop::run()
+{
+    struct epoll_event events[16];
+
+    forever {
+        int descriptors = epoll_wait(m_epollDescriptor, events, 16, -1);
+        if (descriptors == -1) {
+            if (errno != EINTR) {
+                qCWarning(lcSensorFw) << "SysfsIntervalLoop epoll_wait(): " << strerror(errno);
+                QThread::msleep(1000);
+            }
+            continue;
+        }
+
+        // Collect the due entries, and read them without holding the lock
+        // so that other adaptors can be changed meanwhile
+        quint64 due[16];
+        int dueCount = 0;
+        {
+            QMutexLocker locker(&m_mutex);
+            for (int i = 0; i < descriptors; ++i) {
+                // Entry may have been removed after epoll_wait returned
+                QHash<quint64, Entry>::const_iterator entry = m_entries.constFind(events[i].data.u64);
+                if (entry == m_entries.constEnd())
+                    continue;
+
+                // Missed deadlines are skipped rather than read in a burst
+                quint64 expirations;
+                if (read(entry->timerFd, &expirations, sizeof(expirations)) == sizeof(expirations))
+                    due[dueCount++] = entry.key();
             }
+        }
+
+        for (int i = 0; i < dueCount; ++i) {
+            SysfsAdaptor *adaptor;
+            {
+                QMutexLocker locker(&m_mutex);
+                // Entry may have been removed while others were read
+                QHash<quint64, Entry>::const_iterator entry = m_entries.constFind(due[i]);
+                if (entry == m_entries.constEnd())
+                    continue;
+                adaptor = entry->adaptor;
+                m_readingToken = due[i];
+            }
+
+            adaptor->readIntervalSamples();
 
-            // Sleep for interval
-            int interval_ms = (m_parent->m_interval_us + 999) / 1000;
-            QThread::msleep(interval_ms);
+            QMutexLocker locker(&m_mutex);
+            m_readingToken = 0;
+            m_readDone.wakeAll();
         }
     }
 }
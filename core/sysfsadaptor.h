@@ -35,7 +35,9 @@
 #include <QStringList>
 #include <QThread>
 #include <QMutex>
+#include <QWaitCondition>
 #include <QFile>
+#include <QHash>
 
 class SysfsAdaptor;
 
@@ -62,11 +64,6 @@ public:
      */
     void run();
 
-    /**
-     * Initiate reader stopping.
-     */
-    void stopReader();
-
     /**
      * Initiate reader starting.
      */
@@ -77,6 +74,91 @@ private:
     SysfsAdaptor *m_parent;  /**< parent object. */
 };
 
+/**
+ * Thread reading all SysfsAdaptors in IntervalMode. Every running
+ * adaptor has a periodic timerfd with absolute deadlines, so samples are
+ * taken at a steady cadence no matter how long reading takes, and one
+ * epoll loop serves all of them. Should not be invoked directly by
+ * anything except #SysfsAdaptor.
+ */
+class SysfsIntervalLoop : public QThread
+{
+    Q_DISABLE_COPY(SysfsIntervalLoop)
+
+public:
+    /**
+     * Get the loop shared by all adaptors. Started on first use and
+     * never stopped.
+     *
+     * @return loop instance.
+     */
+    static SysfsIntervalLoop &instance();
+
+    /**
+     * Start reading adaptor periodically.
+     *
+     * @param adaptor Adaptor with open fds.
+     * @param interval_us Reading interval.
+     * @return was the adaptor added.
+     */
+    bool add(SysfsAdaptor *adaptor, unsigned int interval_us);
+
+    /**
+     * Change reading interval of adaptor. Ignored if the adaptor is not
+     * added.
+     *
+     * @param adaptor Adaptor to change.
+     * @param interval_us Reading interval.
+     */
+    void setInterval(SysfsAdaptor *adaptor, unsigned int interval_us);
+
+    /**
+     * Stop reading adaptor. The adaptor is not read anymore once this
+     * returns.
+     *
+     * @param adaptor Adaptor to remove.
+     */
+    void remove(SysfsAdaptor *adaptor);
+
+protected:
+    /**
+     * Loop thread entry-function.
+     */
+    void run();
+
+private:
+    /**
+     * Constructor.
+     */
+    SysfsIntervalLoop();
+
+    /**
+     * Arm timer to expire right away and then every interval.
+     *
+     * @param fd timerfd to arm.
+     * @param interval_us Expiry interval.
+     * @return was the timer armed.
+     */
+    bool armTimer(int fd, unsigned int interval_us);
+
+    /**
+     * Adaptor read by the loop.
+     */
+    struct Entry
+    {
+        SysfsAdaptor *adaptor; /**< adaptor to read */
+        int timerFd;           /**< timer pacing reads */
+    };
+
+    QMutex m_mutex;                         /**< guards the entries */
+    QWaitCondition m_readDone;              /**< signalled when an adaptor has been read */
+    int m_epollDescriptor;                  /**< epoll of all timers */
+    quint64 m_nextToken;                    /**< epoll data of next added entry */
+    quint64 m_readingToken;                 /**< entry being read, 0 if none */
+    QHash<quint64, Entry> m_entries;        /**< entries by epoll data */
+    QHash<SysfsAdaptor *, quint64> m_tokens; /**< epoll data by adaptor */
+};
+
 /**
  * @brief Base class for adaptors accessing device drivers through sysfs.
  *
@@ -214,6 +296,22 @@ protected:
      */
     PollMode mode() const;
 
+    /**
+     * Change the mode used for getting input. Must be called before
+     * the adaptor is started.
+     *
+     * @param mode Mode to use for monitoring.
+     */
+    void setMode(PollMode mode);
+
+    /**
+     * Change whether lseek() is called to rewind the monitored fds after
+     * reading. Must be called before the adaptor is started.
+     *
+     * @param seek Whether to rewind.
+     */
+    void setSeek(bool seek);
+
 private:
     /**
      * Opens all file descriptors required by the adaptor.
@@ -246,6 +344,11 @@ private:
      */
     bool checkIntervalUsage() const;
 
+    /**
+     * Read all fds once. Called by #SysfsIntervalLoop in IntervalMode.
+     */
+    void readIntervalSamples();
+
     SysfsAdaptorReader  m_reader; /**< reader thread instance */
     PollMode            m_mode;   /**< used poll mode */
     int                 m_epollDescriptor;    /**< open epoll descriptors */
@@ -261,6 +364,7 @@ private:
     QMutex m_mutex;          /**< mutex protecting starting and stopping. */
 
     friend class SysfsAdaptorReader;
+    friend class SysfsIntervalLoop;
 };
 
 #endif
@@ -25,7 +25,8 @@ HEADERS += xyz.h \
     touchdata.h \
     proximity.h \
     lid.h \
-    liddata.h
+    liddata.h \
+    wireformat.h
 
 SOURCES += xyz.cpp \
     orientation.cpp \
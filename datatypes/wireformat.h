@@ -0,0 +1,82 @@
+/**
+   @file wireformat.h
+   @brief Sample types of the sensor data socket
+
+   <p>
+   Copyright (c) 2026 Jolla Mobile Ltd
+
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef SENSOR_WIRE_FORMAT_H
+#define SENSOR_WIRE_FORMAT_H
+
+#include <type_traits>
+
+#include <datatypes/genericdata.h>
+#include <datatypes/orientationdata.h>
+#include <datatypes/timedunsigned.h>
+#include <datatypes/tapdata.h>
+#include <datatypes/liddata.h>
+
+#include "sensorwire.h"
+
+/**
+ * Compile time description of a sample type on the data socket. Only
+ * types declared with SENSOR_WIRE_DECLARE() can be read and written.
+ */
+template <class T>
+struct SensorWireFormat
+{
+    static const bool declared = false;
+};
+
+/**
+ * Declare \a TYPE as a wire sample with identifier \a ID and \a PAYLOAD
+ * bytes after the timestamp. Adding members to the type without updating
+ * the declaration fails the build.
+ */
+#define SENSOR_WIRE_DECLARE(TYPE, ID, PAYLOAD) \
+    template <> \
+    struct SensorWireFormat<TYPE> \
+    { \
+        static const bool declared = true; \
+        static const SensorWireType type = ID; \
+        static const unsigned int size = SENSOR_WIRE_SAMPLE_SIZE(PAYLOAD); \
+    }; \
+    static_assert(std::is_trivially_copyable<TYPE>::value, #TYPE " must be trivially copyable to be sent as is"); \
+    static_assert(sizeof(TYPE) == SensorWireFormat<TYPE>::size, "Wire layout of " #TYPE " changed")
+
+SENSOR_WIRE_DECLARE(TimedXyzData, SensorWireTimedXyz, 3 * sizeof(float));
+SENSOR_WIRE_DECLARE(CalibratedMagneticFieldData, SensorWireCalibratedMagneticField, 7 * sizeof(int));
+SENSOR_WIRE_DECLARE(CompassData, SensorWireCompass, 4 * sizeof(int));
+SENSOR_WIRE_DECLARE(TimedUnsigned, SensorWireTimedUnsigned, sizeof(unsigned));
+SENSOR_WIRE_DECLARE(ProximityData, SensorWireProximity, sizeof(unsigned) + sizeof(bool));
+SENSOR_WIRE_DECLARE(TapData, SensorWireTap, 2 * sizeof(int));
+SENSOR_WIRE_DECLARE(LidData, SensorWireLid, 2 * sizeof(int));
+
+/**
+ * Decode samples of type \a T, see sensorWireDecodeSamples().
+ */
+template <class T>
+int sensorWireDecode(const char* data, int size, T* values, int capacity,
+                     unsigned int& frameRemaining, int& consumed)
+{
+    static_assert(SensorWireFormat<T>::declared, "Type is not declared as wire sample");
+    return sensorWireDecodeSamples(data, size, values, sizeof(T), capacity, frameRemaining, consumed);
+}
+
+#endif // SENSOR_WIRE_FORMAT_H
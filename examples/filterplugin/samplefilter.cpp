@@ -30,18 +30,23 @@ SampleFilter::SampleFilter() :
 {
 }
 
-void SampleFilter::filter(unsigned, const TimedUnsigned* data)
+void SampleFilter::filter(unsigned n, const TimedUnsigned* data)
 {
-    TimedUnsigned transformed;
-
-    // Usually you want to keep the timestamp of the original data, as
-    // one is likely to be interested in the time that the action
-    // happened. Apply common sense.
-    transformed.timestamp_ = data->timestamp_;
-
-    // Do something for the value.
-    transformed.value_ = data->value_ * data->value_;
-
-    // Propagate the altered sample to outputs
-    source_.propagate(1, &transformed);
+    // Samples may arrive in batches. Reserve room for the whole batch
+    // from the output buffer provided by Filter<>, so no allocation is
+    // needed per call.
+    TimedUnsigned* transformed = output_.reserve(n);
+
+    for (unsigned i = 0; i < n; ++i) {
+        // Usually you want to keep the timestamp of the original data, as
+        // one is likely to be interested in the time that the action
+        // happened. Apply common sense.
+        transformed[i].timestamp_ = data[i].timestamp_;
+
+        // Do something for the value.
+        transformed[i].value_ = data[i].value_ * data[i].value_;
+    }
+
+    // Propagate the altered samples to outputs in one go
+    source_.propagate(n, transformed);
 }
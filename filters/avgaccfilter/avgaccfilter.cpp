@@ -28,22 +28,26 @@ AvgAccFilter::AvgAccFilter() :
 {
 }
 
-void AvgAccFilter::interpret(unsigned, const TimedXyzData *data)
+void AvgAccFilter::interpret(unsigned n, const TimedXyzData *data)
 {
-    avgAccdata.x_ = data->x_ * filterFactor + averageX * (1.0f - filterFactor);
-    avgAccdata.y_ = data->y_ * filterFactor + averageY * (1.0f - filterFactor);
-    avgAccdata.z_ = data->z_ * filterFactor + averageZ * (1.0f - filterFactor);
+    TimedXyzData* filteredData = output_.reserve(n);
 
-    TimedXyzData filteredData(data->timestamp_,
-                              avgAccdata.x_,
-                              avgAccdata.y_,
-                              avgAccdata.z_);
+    for (unsigned i = 0; i < n; ++i) {
+        avgAccdata.x_ = data[i].x_ * filterFactor + averageX * (1.0f - filterFactor);
+        avgAccdata.y_ = data[i].y_ * filterFactor + averageY * (1.0f - filterFactor);
+        avgAccdata.z_ = data[i].z_ * filterFactor + averageZ * (1.0f - filterFactor);
 
-    source_.propagate(1, &filteredData);
+        filteredData[i] = TimedXyzData(data[i].timestamp_,
+                                       avgAccdata.x_,
+                                       avgAccdata.y_,
+                                       avgAccdata.z_);
 
-    averageX = avgAccdata.x_;
-    averageY = avgAccdata.y_;
-    averageZ = avgAccdata.z_;
+        averageX = avgAccdata.x_;
+        averageY = avgAccdata.y_;
+        averageZ = avgAccdata.z_;
+    }
+
+    source_.propagate(n, filteredData);
 }
 
 void AvgAccFilter::reset()
@@ -31,15 +31,24 @@ CoordinateAlignFilter::CoordinateAlignFilter()
 {
 }
 
-void CoordinateAlignFilter::filter(unsigned, const TimedXyzData* data)
+void CoordinateAlignFilter::filter(unsigned n, const TimedXyzData* data)
 {
-    TimedXyzData transformed;
+    const double m00 = matrix_.data_[0][0], m01 = matrix_.data_[0][1], m02 = matrix_.data_[0][2];
+    const double m10 = matrix_.data_[1][0], m11 = matrix_.data_[1][1], m12 = matrix_.data_[1][2];
+    const double m20 = matrix_.data_[2][0], m21 = matrix_.data_[2][1], m22 = matrix_.data_[2][2];
 
-    transformed.timestamp_ = data->timestamp_;
+    TimedXyzData* transformed = output_.reserve(n);
 
-    transformed.x_ = matrix_.get(0,0)*data->x_ + matrix_.get(0,1)*data->y_ + matrix_.get(0,2)*data->z_;
-    transformed.y_ = matrix_.get(1,0)*data->x_ + matrix_.get(1,1)*data->y_ + matrix_.get(1,2)*data->z_;
-    transformed.z_ = matrix_.get(2,0)*data->x_ + matrix_.get(2,1)*data->y_ + matrix_.get(2,2)*data->z_;
+    for (unsigned i = 0; i < n; ++i) {
+        const float x = data[i].x_;
+        const float y = data[i].y_;
+        const float z = data[i].z_;
 
-    source_.propagate(1, &transformed);
+        transformed[i].timestamp_ = data[i].timestamp_;
+        transformed[i].x_ = m00*x + m01*y + m02*z;
+        transformed[i].y_ = m10*x + m11*y + m12*z;
+        transformed[i].z_ = m20*x + m21*y + m22*z;
+    }
+
+    source_.propagate(n, transformed);
 }
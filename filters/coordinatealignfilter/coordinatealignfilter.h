@@ -75,6 +75,9 @@ Q_DECLARE_METATYPE(TMatrix);
  * Transformation is described by transformation matrix which is set through
  * \c TMatrix property. Matrix must be of size 3x3. Default TMatrix is
  * identity matrix.
+ *
+ * All samples of a batch are transformed in one pass and propagated
+ * together.
  */
 class CoordinateAlignFilter : public QObject, public Filter<TimedXyzData, CoordinateAlignFilter, TimedXyzData>
 {
@@ -45,22 +45,30 @@ DeclinationFilter::DeclinationFilter()
     loadSettings();
 }
 
-void DeclinationFilter::correct(unsigned, const CompassData* data)
+void DeclinationFilter::correct(unsigned n, const CompassData* data)
 {
-    CompassData newOrientation(*data);
-    if (newOrientation.timestamp_ - m_lastUpdate_us > m_updateInterval_us) {
-        loadSettings();
-        m_lastUpdate_us = newOrientation.timestamp_;
+    CompassData* corrected = output_.reserve(n);
+
+    for (unsigned i = 0; i < n; ++i) {
+        CompassData newOrientation(data[i]);
+        if (newOrientation.timestamp_ - m_lastUpdate_us > m_updateInterval_us) {
+            loadSettings();
+            m_lastUpdate_us = newOrientation.timestamp_;
+        }
+
+        newOrientation.correctedDegrees_ = newOrientation.degrees_;
+        int correction = m_declinationCorrection.loadAcquire();
+        if (correction != 0) {
+            newOrientation.correctedDegrees_ += correction;
+            newOrientation.correctedDegrees_ %= 360;
+        }
+        corrected[i] = newOrientation;
     }
 
-    newOrientation.correctedDegrees_ = newOrientation.degrees_;
-    if (m_declinationCorrection.loadAcquire() != 0) {
-        newOrientation.correctedDegrees_ += m_declinationCorrection.loadAcquire();
-        newOrientation.correctedDegrees_ %= 360;
-//        qCDebug(lcSensorFw) << "DeclinationFilter corrected degree " << newOrientation.degrees_ << " => " << newOrientation.correctedDegrees_ << ". Level: " << newOrientation.level_;
+    if (n) {
+        m_orientation = corrected[n - 1];
+        source_.propagate(n, corrected);
     }
-    m_orientation = newOrientation;
-    source_.propagate(1, &m_orientation);
 }
 
 void DeclinationFilter::loadSettings()
@@ -56,41 +56,29 @@ void DownsampleFilter::setTimeout(int ms)
     qCInfo(lcSensorFw) << "DownsampleFilter timeout = " << ms;
 }
 
-void DownsampleFilter::filter(unsigned, const TimedXyzData* data)
+void DownsampleFilter::filter(unsigned n, const TimedXyzData* data)
 {
-    buffer_.push_back(*data);
-
-    for (TimedXyzDownsampleBuffer::iterator it = buffer_.begin(); it != buffer_.end(); ++it) {
-        if (static_cast<unsigned int>(buffer_.size()) > bufferSize_
-                || (timeout_ && (data->timestamp_ - it->timestamp_ > static_cast<unsigned long>(timeout_)))) {
-            it = buffer_.erase(it);
-            if (it == buffer_.end())
-                break;
-        } else {
-            break;
-        }
+    TimedXyzData* downsampled = output_.reserve(n);
+    unsigned produced = 0;
+
+    for (unsigned i = 0; i < n; ++i) {
+        const TimedXyzData& sample = data[i];
+        buffer_.setCapacity(bufferSize_);
+        const double values[3] = { sample.x_, sample.y_, sample.z_ };
+        buffer_.push(sample.timestamp_, values);
+        if (timeout_ > 0 && sample.timestamp_ > static_cast<quint64>(timeout_))
+            buffer_.expireBefore(sample.timestamp_ - timeout_);
+
+        if (!buffer_.isFull())
+            continue;
+
+        downsampled[produced++] = TimedXyzData(sample.timestamp_,
+                                               buffer_.mean(0),
+                                               buffer_.mean(1),
+                                               buffer_.mean(2));
+        buffer_.clear();
     }
 
-    if (static_cast<unsigned int>(buffer_.size()) < bufferSize_)
-        return;
-
-    float x = 0;
-    float y = 0;
-    float z = 0;
-
-    foreach (const TimedXyzData& data, buffer_) {
-        x += data.x_;
-        y += data.y_;
-        z += data.z_;
-    }
-    int count = buffer_.count();
-    TimedXyzData downsampled(data->timestamp_,
-                             x / count,
-                             y / count,
-                             z / count);
-
-//    qCDebug(lcSensorFw) << "Downsampled: " << downsampled.x_ << ", " << downsampled.y_ << ", " << downsampled.z_;
-
-    source_.propagate(1, &downsampled);
-    buffer_.clear();
+    if (produced)
+        source_.propagate(produced, downsampled);
 }
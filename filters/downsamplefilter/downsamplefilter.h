@@ -26,10 +26,10 @@
 #ifndef DOWNSAMPLEFILTER_H
 #define DOWNSAMPLEFILTER_H
 
-#include <QList>
 #include <QObject>
 #include "datatypes/orientationdata.h"
 #include "filter.h"
+#include "slidingwindow.h"
 
 /**
  * @brief Downsample filter.
@@ -94,12 +94,9 @@ private:
      */
     void filter(unsigned, const TimedXyzData*);
 
-    /** Sample buffer type for TimedXyzData downsampling. */
-    typedef QList<TimedXyzData> TimedXyzDownsampleBuffer;
-
     unsigned int bufferSize_; /**< buffer size */
     long timeout_;   /**< timeout in milliseconds */
-    TimedXyzDownsampleBuffer buffer_; /**< downsample buffer */
+    SlidingWindow<3> buffer_; /**< downsample buffer */
 };
 
 #endif // DOWNSAMPLEFILTER_H
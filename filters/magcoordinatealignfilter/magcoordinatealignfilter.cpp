@@ -32,21 +32,30 @@ MagCoordinateAlignFilter::MagCoordinateAlignFilter()
 {
 }
 
-void MagCoordinateAlignFilter::filter(unsigned, const CalibratedMagneticFieldData* data)
+void MagCoordinateAlignFilter::filter(unsigned n, const CalibratedMagneticFieldData* data)
 {
-    CalibratedMagneticFieldData transformed;
+    const double m00 = matrix_.data_[0][0], m01 = matrix_.data_[0][1], m02 = matrix_.data_[0][2];
+    const double m10 = matrix_.data_[1][0], m11 = matrix_.data_[1][1], m12 = matrix_.data_[1][2];
+    const double m20 = matrix_.data_[2][0], m21 = matrix_.data_[2][1], m22 = matrix_.data_[2][2];
 
-    transformed.timestamp_ = data->timestamp_;
+    CalibratedMagneticFieldData* transformed = output_.reserve(n);
 
-    transformed.x_ = matrix_.get(0,0)*data->x_ + matrix_.get(0,1)*data->y_ + matrix_.get(0,2)*data->z_;
-    transformed.y_ = matrix_.get(1,0)*data->x_ + matrix_.get(1,1)*data->y_ + matrix_.get(1,2)*data->z_;
-    transformed.z_ = matrix_.get(2,0)*data->x_ + matrix_.get(2,1)*data->y_ + matrix_.get(2,2)*data->z_;
+    for (unsigned i = 0; i < n; ++i) {
+        const CalibratedMagneticFieldData& in = data[i];
+        CalibratedMagneticFieldData& out = transformed[i];
 
-    transformed.rx_ = matrix_.get(0,0)*data->rx_ + matrix_.get(0,1)*data->ry_ + matrix_.get(0,2)*data->rz_;
-    transformed.ry_ = matrix_.get(1,0)*data->rx_ + matrix_.get(1,1)*data->ry_ + matrix_.get(1,2)*data->rz_;
-    transformed.rz_ = matrix_.get(2,0)*data->rx_ + matrix_.get(2,1)*data->ry_ + matrix_.get(2,2)*data->rz_;
+        out.timestamp_ = in.timestamp_;
 
-    transformed.level_ = data->level_;
+        out.x_ = m00*in.x_ + m01*in.y_ + m02*in.z_;
+        out.y_ = m10*in.x_ + m11*in.y_ + m12*in.z_;
+        out.z_ = m20*in.x_ + m21*in.y_ + m22*in.z_;
 
-    source_.propagate(1, &transformed);
+        out.rx_ = m00*in.rx_ + m01*in.ry_ + m02*in.rz_;
+        out.ry_ = m10*in.rx_ + m11*in.ry_ + m12*in.rz_;
+        out.rz_ = m20*in.rx_ + m21*in.ry_ + m22*in.rz_;
+
+        out.level_ = in.level_;
+    }
+
+    source_.propagate(n, transformed);
 }
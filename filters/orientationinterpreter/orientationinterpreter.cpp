@@ -87,6 +87,7 @@ OrientationInterpreter::OrientationInterpreter()
                                                                 QVariant(DISCARD_TIME)).toUInt();
     maxBufferSize = SensorFrameworkConfig::configuration()->value("orientation/buffer_size",
                                                                   QVariant(AVG_BUFFER_MAX_SIZE)).toInt();
+    dataBuffer.setCapacity(qMax(1, maxBufferSize));
 
     // Open the handle for boosting cpu on changes that affect orientation
     if (cpuBoostFile.exists()) {
@@ -94,9 +95,17 @@ OrientationInterpreter::OrientationInterpreter()
     }
 }
 
-void OrientationInterpreter::accDataAvailable(unsigned, const AccelerationData* pdata)
+void OrientationInterpreter::accDataAvailable(unsigned n, const AccelerationData* pdata)
 {
-    data = *pdata;
+    // Pose changes are events, each sample is evaluated in order and
+    // only transitions are propagated.
+    for (unsigned i = 0; i < n; ++i)
+        processSample(pdata[i]);
+}
+
+void OrientationInterpreter::processSample(const AccelerationData& sample)
+{
+    data = sample;
 
     // Check overflow
     if (overFlowCheck()) {
@@ -104,30 +113,18 @@ void OrientationInterpreter::accDataAvailable(unsigned, const AccelerationData*
         return;
     }
 
-    // Append new value to buffer
-    dataBuffer.append(data);
+    // Append new value to buffer, dropping the oldest one if full
+    const double values[3] = { data.x_, data.y_, data.z_ };
+    dataBuffer.push(data.timestamp_, values);
 
     // Clear old values from buffer.
-    while (dataBuffer.count() > maxBufferSize
-           || (dataBuffer.count() > 1
-               && (data.timestamp_ - dataBuffer.first().timestamp_ > discardTime))) {
-        dataBuffer.removeFirst();
-    }
+    if (data.timestamp_ > discardTime)
+        dataBuffer.expireBefore(data.timestamp_ - discardTime, 1);
 
     // Calculate average
-    float x = 0;
-    float y = 0;
-    float z = 0;
-
-    foreach (const AccelerationData& sample, dataBuffer) {
-        x += sample.x_;
-        y += sample.y_;
-        z += sample.z_;
-    }
-
-    data.x_ = x / dataBuffer.count();
-    data.y_ = y / dataBuffer.count();
-    data.z_ = z / dataBuffer.count();
+    data.x_ = dataBuffer.mean(0);
+    data.y_ = dataBuffer.mean(1);
+    data.z_ = dataBuffer.mean(2);
 
     // calculate topedge
     processTopEdge();
@@ -32,6 +32,7 @@
 #include <QObject>
 #include <QFile>
 #include "filter.h"
+#include "slidingwindow.h"
 #include <datatypes/orientationdata.h>
 #include <datatypes/posedata.h>
 
@@ -55,6 +56,7 @@ private:
     Source<PoseData> orientationSource;
 
     void accDataAvailable(unsigned, const AccelerationData*);
+    void processSample(const AccelerationData& sample);
 
     bool overFlowCheck();
     void processTopEdge();
@@ -69,7 +71,7 @@ private:
     bool updatePreviousFace;
 
     AccelerationData data;
-    QList<AccelerationData> dataBuffer;
+    SlidingWindow<3> dataBuffer;
 
     int minLimitSquared;
     int maxLimitSquared;
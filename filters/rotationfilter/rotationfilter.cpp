@@ -37,7 +37,19 @@ RotationFilter::RotationFilter()
     addSource(&source_, "source");
 }
 
-void RotationFilter::interpret(unsigned, const TimedXyzData* data)
+void RotationFilter::interpret(unsigned n, const TimedXyzData* data)
+{
+    TimedXyzData* rotations = output_.reserve(n);
+
+    for (unsigned i = 0; i < n; ++i) {
+        rotate(&data[i]);
+        rotations[i] = rotation_;
+    }
+
+    source_.propagate(n, rotations);
+}
+
+void RotationFilter::rotate(const TimedXyzData* data)
 {
     const double RADIANS_TO_DEGREES = 180/M_PI;
 
@@ -63,8 +75,6 @@ void RotationFilter::interpret(unsigned, const TimedXyzData* data)
                 rotation_.y_ = -180 - rotation_.y_;
         }
     }
-
-    source_.propagate(1, &rotation_);
 }
 
 double RotationFilter::vectorLength(const TimedXyzData& data)
@@ -72,8 +82,14 @@ double RotationFilter::vectorLength(const TimedXyzData& data)
     return sqrt(data.x_ * data.x_ + data.y_ * data.y_ + data.z_ * data.z_);
 }
 
-void RotationFilter::updateZvalue(unsigned, const CompassData* data)
+void RotationFilter::updateZvalue(unsigned n, const CompassData* data)
 {
+    if (!n)
+        return;
+
+    // Only the newest heading affects the rotation
+    data += n - 1;
+
     rotation_.timestamp_ = data->timestamp_;
 
     /// Z-rotation
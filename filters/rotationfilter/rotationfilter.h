@@ -66,8 +66,10 @@ private:
     Sink<RotationFilter, TimedXyzData> accelerometerDataSink_;
     Sink<RotationFilter, CompassData> compassDataSink_;
     Source<TimedXyzData> source_;
+    FilterOutputBuffer<TimedXyzData> output_;
 
     void interpret(unsigned, const TimedXyzData*);
+    void rotate(const TimedXyzData* data);
     void updateZvalue(unsigned, const CompassData*);
 
     inline int dotProduct(TimedXyzData a, TimedXyzData b) const {
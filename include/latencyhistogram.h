@@ -0,0 +1,243 @@
+/**
+   @file latencyhistogram.h
+   @brief Histogram of sample delivery latencies
+
+   <p>
+   Copyright (c) 2026 Jolla Mobile Ltd
+
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <QtGlobal>
+#include <QVariantMap>
+#include <string.h>
+#include <time.h>
+
+/**
+ * Histogram of latencies in microseconds with bounded relative error.
+ *
+ * Values below 8 us have buckets of their own. Above that every power of
+ * two is split into 8 buckets, so a reported percentile is at most 12.5%
+ * above the real one. Values of 16 s or more share the last bucket; the
+ * maximum is always tracked exactly.
+ *
+ * Only every sampleInterval-th event is meant to be measured, which keeps
+ * the clock reads off the hot path: callers check sample() first.
+ *
+ * Stages inside one process are best measured between CLOCK_MONOTONIC
+ * stamps taken by the stages themselves. Sample timestamps set by adaptors
+ * follow the clock of their data source, see recordSinceSampleTime().
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param sampleInterval measure every this many events, 0 disables.
+     */
+    explicit LatencyHistogram(unsigned int sampleInterval = 16)
+        : m_sampleInterval(sampleInterval)
+        , m_sinceSample(0)
+    {
+        reset();
+    }
+
+    /**
+     * Set how often events are measured.
+     *
+     * @param sampleInterval measure every this many events, 0 disables.
+     */
+    void setSampleInterval(unsigned int sampleInterval)
+    {
+        m_sampleInterval = sampleInterval;
+        m_sinceSample = 0;
+    }
+
+    /**
+     * Should the current event be measured.
+     *
+     * @return \c true for every sampleInterval-th call.
+     */
+    bool sample()
+    {
+        if (!m_sampleInterval || ++m_sinceSample < m_sampleInterval)
+            return false;
+        m_sinceSample = 0;
+        return true;
+    }
+
+    /**
+     * Add latency to the histogram.
+     *
+     * @param latency_us latency in microseconds.
+     */
+    void record(quint64 latency_us)
+    {
+        ++m_counts[bucket(latency_us)];
+        ++m_count;
+        if (latency_us > m_max)
+            m_max = latency_us;
+    }
+
+    /**
+     * Add latency of a sample measured at \a timestamp. Timestamps ahead
+     * of \a now come from a different clock and are ignored.
+     *
+     * @param timestamp sample timestamp in microseconds.
+     * @param now current time in microseconds.
+     */
+    void recordSince(quint64 timestamp, quint64 now)
+    {
+        if (timestamp && now >= timestamp)
+            record(now - timestamp);
+    }
+
+    /**
+     * Add latency of a sample stamped by an adaptor at \a timestamp.
+     * Adaptors use the clock of their data source: CLOCK_MONOTONIC for
+     * most, CLOCK_BOOTTIME for Android HAL events and CLOCK_REALTIME for
+     * evdev events. These are compared in that order and the first one
+     * not behind the timestamp is used. CLOCK_BOOTTIME runs ahead of
+     * CLOCK_MONOTONIC by the time spent in suspend, so a BOOTTIME stamp
+     * is taken for MONOTONIC only while that time is shorter than the
+     * latency, which is then underestimated by it.
+     *
+     * @param timestamp sample timestamp in microseconds.
+     */
+    void recordSinceSampleTime(quint64 timestamp)
+    {
+        static const clockid_t clocks[] = { CLOCK_MONOTONIC, CLOCK_BOOTTIME, CLOCK_REALTIME };
+        if (!timestamp)
+            return;
+        for (unsigned int i = 0; i < sizeof(clocks) / sizeof(clocks[0]); ++i) {
+            quint64 now = clockTime(clocks[i]);
+            if (now >= timestamp) {
+                record(now - timestamp);
+                return;
+            }
+        }
+    }
+
+    /**
+     * Current time of a clock.
+     *
+     * @param clock clock to read.
+     * @return time in microseconds, 0 if the clock can not be read.
+     */
+    static quint64 clockTime(clockid_t clock)
+    {
+        struct timespec now;
+        if (clock_gettime(clock, &now) != 0)
+            return 0;
+        return quint64(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+    }
+
+    /**
+     * Number of recorded latencies.
+     */
+    quint64 count() const { return m_count; }
+
+    /**
+     * Largest recorded latency.
+     */
+    quint64 max() const { return m_max; }
+
+    /**
+     * Latency below or at which given percentage of recorded latencies
+     * fall.
+     *
+     * @param percent percentage, 0 - 100.
+     * @return upper bound of the latency, 0 if nothing is recorded.
+     */
+    quint64 percentile(unsigned int percent) const
+    {
+        if (!m_count)
+            return 0;
+        quint64 target = qMax<quint64>(1, (m_count * qMin(percent, 100u) + 99) / 100);
+        quint64 seen = 0;
+        for (int i = 0; i < BucketCount; ++i) {
+            seen += m_counts[i];
+            if (seen >= target)
+                return i == BucketCount - 1 ? m_max : qMin(bucketLimit(i), m_max);
+        }
+        return m_max;
+    }
+
+    /**
+     * Forget recorded latencies.
+     */
+    void reset()
+    {
+        memset(m_counts, 0, sizeof(m_counts));
+        m_count = 0;
+        m_max = 0;
+    }
+
+    /**
+     * Summary of recorded latencies.
+     *
+     * @return map with samples, p50_us, p99_us and max_us entries.
+     */
+    QVariantMap summary() const
+    {
+        QVariantMap map;
+        map.insert("samples", m_count);
+        map.insert("p50_us", percentile(50));
+        map.insert("p99_us", percentile(99));
+        map.insert("max_us", m_max);
+        return map;
+    }
+
+private:
+    enum {
+        SubBucketBits = 3,
+        SubBuckets = 1 << SubBucketBits,
+        MaxExponent = 24,
+        BucketCount = (MaxExponent - SubBucketBits + 1) * SubBuckets
+    };
+
+    static int bucket(quint64 value)
+    {
+        if (value < SubBuckets)
+            return value;
+        int exponent = 63 - __builtin_clzll(value);
+        if (exponent >= MaxExponent)
+            return BucketCount - 1;
+        return (exponent - SubBucketBits + 1) * SubBuckets
+            + ((value >> (exponent - SubBucketBits)) & (SubBuckets - 1));
+    }
+
+    static quint64 bucketLimit(int index)
+    {
+        if (index < SubBuckets)
+            return index;
+        int shift = index / SubBuckets - 1;
+        quint64 lower = quint64(SubBuckets + index % SubBuckets) << shift;
+        return lower + (quint64(1) << shift) - 1;
+    }
+
+    quint32 m_counts[BucketCount]; /**< recorded latencies per bucket */
+    quint64 m_count;               /**< number of recorded latencies */
+    quint64 m_max;                 /**< largest recorded latency */
+    unsigned int m_sampleInterval; /**< measure every this many events */
+    unsigned int m_sinceSample;    /**< events since last measurement */
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,170 @@
+/**
+   @file sensorwire.h
+   @brief Framing of the sensor data socket
+
+   <p>
+   Copyright (c) 2026 Jolla Mobile Ltd
+
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef SENSOR_WIRE_H
+#define SENSOR_WIRE_H
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Version of the data socket layout. sensord announces it with the first
+ * byte written to a new data connection. Version 1 is announced with
+ * '\\n', which is what sensord sent before the layout was versioned.
+ *
+ * The layout is a sequence of frames, each holding a native endian
+ * unsigned int sample count followed by that many samples. Samples are
+ * the data classes themselves copied as is, see datatypes/wireformat.h.
+ */
+static const unsigned int SENSOR_WIRE_VERSION = 1;
+
+/**
+ * First byte written by sensord to a new data connection.
+ */
+static const char SENSOR_WIRE_TAG = '\n';
+
+/**
+ * Largest sample count accepted in a single frame. Anything larger is
+ * treated as a corrupted stream.
+ */
+static const unsigned int SENSOR_WIRE_MAX_FRAME_SAMPLES = 1000;
+
+/**
+ * Session ID written by a client opening a multiplexed data connection.
+ * After it the client writes the IDs of the sessions to attach to the
+ * connection, at any time and any number of them. sensord then sends
+ * frames of all those sessions over this one connection, each preceded
+ * by a SensorWireChannelHeader instead of the plain sample count.
+ */
+static const int SENSOR_WIRE_MULTIPLEX = -2;
+
+/**
+ * Header of a frame on a multiplexed data connection. Frames of a single
+ * channel arrive in order, frames of different channels are interleaved
+ * in no particular order.
+ */
+struct SensorWireChannelHeader
+{
+    int32_t channel;     /**< session the frame belongs to */
+    uint32_t sampleSize; /**< size of a single sample */
+    uint32_t count;      /**< number of samples following the header */
+};
+
+/**
+ * Identifiers of the sample types carried by the data socket. Values
+ * are part of the wire format and must not be changed.
+ */
+enum SensorWireType
+{
+    SensorWireInvalid = 0,
+    SensorWireTimedXyz = 1,               /**< TimedXyzData */
+    SensorWireCalibratedMagneticField = 2, /**< CalibratedMagneticFieldData */
+    SensorWireCompass = 3,                /**< CompassData */
+    SensorWireTimedUnsigned = 4,          /**< TimedUnsigned */
+    SensorWireProximity = 5,              /**< ProximityData */
+    SensorWireTap = 6,                    /**< TapData */
+    SensorWireLid = 7                     /**< LidData */
+};
+
+/**
+ * Helper for the alignment of the timestamp inside samples, which is
+ * not what alignof(uint64_t) reports on all ABIs.
+ */
+struct SensorWireTimestampAlignment
+{
+    char c;
+    uint64_t timestamp;
+};
+
+/**
+ * Size of a sample with \a payload bytes following the timestamp.
+ */
+#define SENSOR_WIRE_SAMPLE_SIZE(payload) \
+    ((sizeof(SensorWireTimestampAlignment) + (payload) - 1) / (sizeof(SensorWireTimestampAlignment) - sizeof(uint64_t)) \
+     * (sizeof(SensorWireTimestampAlignment) - sizeof(uint64_t)))
+
+/**
+ * Timestamp of a sample. Every sample type starts with its timestamp.
+ *
+ * @param sample location of the sample.
+ * @param sampleSize size of the sample.
+ * @return timestamp, or zero if the sample is too small to carry one.
+ */
+inline uint64_t sensorWireTimestamp(const char* sample, uint32_t sampleSize)
+{
+    uint64_t timestamp = 0;
+    if (sampleSize >= sizeof(uint64_t))
+        memcpy(&timestamp, sample, sizeof(uint64_t));
+    return timestamp;
+}
+
+/**
+ * Decode samples from data socket bytes straight into a caller provided
+ * array. Frames may be split between calls both at frame boundaries and
+ * inside a frame; \a frameRemaining carries the state in between and
+ * must start at zero for a fresh connection.
+ *
+ * @param data received bytes.
+ * @param size number of bytes in \a data.
+ * @param values location to store samples to.
+ * @param sampleSize size of a single sample.
+ * @param capacity number of samples fitting into \a values.
+ * @param frameRemaining samples of the current frame not decoded yet.
+ * @param consumed set to number of bytes used from \a data.
+ * @return number of samples stored, or -1 if the stream is corrupted.
+ */
+inline int sensorWireDecodeSamples(const char* data, int size, void* values, uint32_t sampleSize,
+                                   int capacity, unsigned int& frameRemaining, int& consumed)
+{
+    char* out = static_cast<char*>(values);
+    int count = 0;
+    consumed = 0;
+    while (count < capacity) {
+        if (frameRemaining == 0) {
+            if (size - consumed < (int)sizeof(unsigned int))
+                break;
+            unsigned int frameSize;
+            memcpy(&frameSize, data + consumed, sizeof(unsigned int));
+            if (frameSize > SENSOR_WIRE_MAX_FRAME_SAMPLES)
+                return -1;
+            consumed += sizeof(unsigned int);
+            frameRemaining = frameSize;
+            continue;
+        }
+
+        int n = (size - consumed) / (int)sampleSize;
+        if (n > capacity - count)
+            n = capacity - count;
+        if (n > (int)frameRemaining)
+            n = frameRemaining;
+        if (n == 0)
+            break;
+        memcpy(out + count * sampleSize, data + consumed, n * sampleSize);
+        consumed += n * sampleSize;
+        frameRemaining -= n;
+        count += n;
+    }
+    return count;
+}
+
+#endif // SENSOR_WIRE_H
@@ -0,0 +1,280 @@
+/**
+   @file sessionring.h
+   @brief Shared memory sample ring for sensor sessions
+
+   <p>
+   Copyright (c) 2026 Jolla Mobile Ltd
+
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef SESSION_RING_H
+#define SESSION_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Magic value in the beginning of a session ring mapping ("SFWR").
+ */
+static const uint32_t SESSION_RING_MAGIC = 0x53465752;
+
+/**
+ * Version of the session ring layout.
+ */
+static const uint32_t SESSION_RING_VERSION = 1;
+
+/**
+ * Largest sample size which fits into a ring slot.
+ */
+static const uint32_t SESSION_RING_SLOT_PAYLOAD = 64;
+
+/**
+ * Default number of slots in a ring. Must be a power of two.
+ */
+static const uint32_t SESSION_RING_DEFAULT_SLOTS = 256;
+
+/**
+ * Header in the beginning of the shared mapping.
+ *
+ * The ring has a single producer (sensord) and any number of consumers.
+ * Consumers never block the producer: slow consumers notice overwritten
+ * slots from the slot sequence numbers and skip ahead.
+ */
+struct SessionRingHeader
+{
+    uint32_t magic;           /**< SESSION_RING_MAGIC */
+    uint32_t version;         /**< SESSION_RING_VERSION */
+    uint32_t slotCount;       /**< number of slots, power of two */
+    uint32_t slotPayload;     /**< payload bytes in each slot */
+    uint32_t wakeupRequested; /**< set by consumer which wants a socket notification */
+    uint32_t reserved;        /**< padding */
+    uint64_t writeIndex;      /**< number of samples published */
+};
+
+/**
+ * Header of a single slot. Payload follows immediately.
+ */
+struct SessionRingSlot
+{
+    uint64_t sequence; /**< 2 * index + 1 while writing, 2 * index + 2 when published */
+    uint32_t size;     /**< payload size in bytes */
+    uint32_t reserved; /**< padding */
+};
+
+/**
+ * Size of a ring mapping with given number of slots.
+ *
+ * @param slotCount number of slots.
+ * @return mapping size in bytes.
+ */
+inline size_t sessionRingMappingSize(uint32_t slotCount)
+{
+    return sizeof(SessionRingHeader) + (size_t)slotCount * (sizeof(SessionRingSlot) + SESSION_RING_SLOT_PAYLOAD);
+}
+
+/**
+ * Locate slot for given sample index.
+ *
+ * Both ends of the ring can write the header, so the slot count must be
+ * the one the caller validated and stored locally, never a fresh read of
+ * SessionRingHeader::slotCount.
+ *
+ * @param header ring header.
+ * @param slotCount number of slots, power of two.
+ * @param index sample index.
+ * @return slot for the index.
+ */
+inline SessionRingSlot* sessionRingSlot(SessionRingHeader* header, uint32_t slotCount, uint64_t index)
+{
+    char* base = reinterpret_cast<char*>(header + 1);
+    size_t stride = sizeof(SessionRingSlot) + SESSION_RING_SLOT_PAYLOAD;
+    return reinterpret_cast<SessionRingSlot*>(base + (index & (slotCount - 1)) * stride);
+}
+
+/**
+ * Producer side of the session ring.
+ *
+ * Consumers map the ring writable, so the writer keeps the ring layout
+ * and write position to itself and only ever publishes them.
+ */
+class SessionRingWriter
+{
+public:
+    /**
+     * Constructor.
+     */
+    SessionRingWriter() : header_(0), slotCount_(0), writeIndex_(0) {}
+
+    /**
+     * Initialize ring layout into given mapping.
+     *
+     * @param mapping shared memory of sessionRingMappingSize(slotCount) bytes.
+     * @param slotCount number of slots, power of two.
+     */
+    void initialize(void* mapping, uint32_t slotCount)
+    {
+        header_ = static_cast<SessionRingHeader*>(mapping);
+        slotCount_ = slotCount;
+        writeIndex_ = 0;
+        memset(mapping, 0, sessionRingMappingSize(slotCount));
+        header_->magic = SESSION_RING_MAGIC;
+        header_->version = SESSION_RING_VERSION;
+        header_->slotCount = slotCount;
+        header_->slotPayload = SESSION_RING_SLOT_PAYLOAD;
+        header_->wakeupRequested = 1;
+    }
+
+    /**
+     * Publish a sample.
+     *
+     * @param source sample data.
+     * @param size sample size, at most SESSION_RING_SLOT_PAYLOAD.
+     * @return \c true if a consumer asked to be notified about new data.
+     */
+    bool write(const void* source, uint32_t size)
+    {
+        uint64_t index = writeIndex_++;
+        SessionRingSlot* slot = sessionRingSlot(header_, slotCount_, index);
+
+        __atomic_store_n(&slot->sequence, 2 * index + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        slot->size = size;
+        memcpy(slot + 1, source, size);
+        __atomic_store_n(&slot->sequence, 2 * index + 2, __ATOMIC_RELEASE);
+        __atomic_store_n(&header_->writeIndex, writeIndex_, __ATOMIC_SEQ_CST);
+
+        return __atomic_exchange_n(&header_->wakeupRequested, 0, __ATOMIC_SEQ_CST) != 0;
+    }
+
+private:
+    SessionRingHeader* header_;     /**< mapped ring */
+    uint32_t           slotCount_;  /**< number of slots */
+    uint64_t           writeIndex_; /**< number of samples published */
+};
+
+/**
+ * Consumer side of the session ring.
+ */
+class SessionRingReader
+{
+public:
+    /**
+     * Constructor.
+     */
+    SessionRingReader() : header_(0), slotCount_(0), readIndex_(0), lost_(0) {}
+
+    /**
+     * Attach to a mapped ring. Reading starts from the newest sample.
+     *
+     * @param mapping mapped ring.
+     * @param size size of the mapping.
+     * @return is the mapping a compatible ring.
+     */
+    bool attach(void* mapping, size_t size)
+    {
+        SessionRingHeader* header = static_cast<SessionRingHeader*>(mapping);
+        if (size < sizeof(SessionRingHeader))
+            return false;
+        uint32_t slotCount = header->slotCount;
+        if (header->magic != SESSION_RING_MAGIC
+                || header->version != SESSION_RING_VERSION
+                || header->slotPayload != SESSION_RING_SLOT_PAYLOAD
+                || !slotCount
+                || (slotCount & (slotCount - 1))
+                || size < sessionRingMappingSize(slotCount)) {
+            return false;
+        }
+        header_ = header;
+        slotCount_ = slotCount;
+        readIndex_ = __atomic_load_n(&header_->writeIndex, __ATOMIC_ACQUIRE);
+        return true;
+    }
+
+    /**
+     * Is reader attached to a ring.
+     */
+    bool isAttached() const { return header_ != 0; }
+
+    /**
+     * Read samples of given size from the ring.
+     *
+     * @param values location to copy samples to.
+     * @param sampleSize size of a single sample.
+     * @param maxCount maximum number of samples to read.
+     * @return number of samples read.
+     */
+    unsigned read(void* values, uint32_t sampleSize, unsigned maxCount)
+    {
+        char* out = static_cast<char*>(values);
+        unsigned count = 0;
+        uint64_t writeIndex = __atomic_load_n(&header_->writeIndex, __ATOMIC_ACQUIRE);
+
+        if (sampleSize > SESSION_RING_SLOT_PAYLOAD)
+            return 0;
+
+        if (writeIndex - readIndex_ > slotCount_) {
+            lost_ += writeIndex - readIndex_ - slotCount_;
+            readIndex_ = writeIndex - slotCount_;
+        }
+
+        while (count < maxCount && readIndex_ != writeIndex) {
+            SessionRingSlot* slot = sessionRingSlot(header_, slotCount_, readIndex_);
+            uint64_t expected = 2 * readIndex_ + 2;
+            uint64_t before = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+            if (before == expected && slot->size == sampleSize) {
+                memcpy(out, slot + 1, sampleSize);
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == expected) {
+                    out += sampleSize;
+                    ++count;
+                } else {
+                    ++lost_;
+                }
+            } else {
+                ++lost_;
+            }
+            ++readIndex_;
+        }
+        return count;
+    }
+
+    /**
+     * Ask producer to send a socket notification for the next sample.
+     *
+     * @return \c true if there already is unread data, in which case
+     *         the caller should read again instead of waiting.
+     */
+    bool requestWakeup()
+    {
+        __atomic_store_n(&header_->wakeupRequested, 1, __ATOMIC_SEQ_CST);
+        return __atomic_load_n(&header_->writeIndex, __ATOMIC_SEQ_CST) != readIndex_;
+    }
+
+    /**
+     * Number of samples lost because they were overwritten before read.
+     */
+    uint64_t lost() const { return lost_; }
+
+private:
+    SessionRingHeader* header_;   /**< mapped ring */
+    uint32_t           slotCount_; /**< number of slots, checked on attach */
+    uint64_t           readIndex_; /**< next sample to read */
+    uint64_t           lost_;      /**< lost sample counter */
+};
+
+#endif // SESSION_RING_H
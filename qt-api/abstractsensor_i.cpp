@@ -50,6 +50,11 @@ struct AbstractSensorChannelInterface::AbstractSensorChannelInterfaceImpl : publ
     bool m_running;
     bool m_standbyOverride;
     bool m_downsampling;
+    void* m_batchBuffer;
+    int m_batchCapacity;
+    BatchDecoder m_batchDecoder;
+    SensorBatchCallback m_batchCallback;
+    void* m_batchUserData;
 };
 
 AbstractSensorChannelInterface::AbstractSensorChannelInterfaceImpl::AbstractSensorChannelInterfaceImpl(
@@ -65,13 +70,21 @@ AbstractSensorChannelInterface::AbstractSensorChannelInterfaceImpl::AbstractSens
     , m_running(false)
     , m_standbyOverride(false)
     , m_downsampling(true)
+    , m_batchBuffer(nullptr)
+    , m_batchCapacity(0)
+    , m_batchDecoder(nullptr)
+    , m_batchCallback(nullptr)
+    , m_batchUserData(nullptr)
 {
 }
 
 AbstractSensorChannelInterface::AbstractSensorChannelInterface(const QString& path, const char* interfaceName, int sessionId)
     : pimpl_(new AbstractSensorChannelInterfaceImpl(this, sessionId, path, interfaceName))
 {
-    if (!pimpl_->m_socketReader.initiateConnection(sessionId)) {
+    bool connected = SensorManagerInterface::instance().multiplexedTransport()
+        ? pimpl_->m_socketReader.initiateMultiplexedConnection(sessionId)
+        : pimpl_->m_socketReader.initiateConnection(sessionId);
+    if (!connected) {
         setError(SClientSocketError, "Socket connection failed.");
     }
 #ifdef SENSORFW_MCE_WATCHER
@@ -133,11 +146,9 @@ QDBusReply<void> AbstractSensorChannelInterface::start(int sessionId)
     pimpl_->m_running = true;
 
     // Discard any old data already in the socket
-    if (pimpl_->m_socketReader.socket()->bytesAvailable() > 0) {
-        pimpl_->m_socketReader.socket()->readAll();
-    }
+    pimpl_->m_socketReader.flushReceiveBuffer();
 
-    connect(pimpl_->m_socketReader.socket(), SIGNAL(readyRead()), this, SLOT(dataReceived()));
+    connect(&pimpl_->m_socketReader, SIGNAL(readyRead()), this, SLOT(dataReceived()));
 
     QList<QVariant> argumentList;
     argumentList << QVariant::fromValue(sessionId);
@@ -175,7 +186,7 @@ QDBusReply<void> AbstractSensorChannelInterface::stop(int sessionId)
     }
     pimpl_->m_running = false ;
 
-    disconnect(pimpl_->m_socketReader.socket(), SIGNAL(readyRead()), this, SLOT(dataReceived()));
+    disconnect(&pimpl_->m_socketReader, SIGNAL(readyRead()), this, SLOT(dataReceived()));
 
     QList<QVariant> argumentList;
     argumentList << QVariant::fromValue(sessionId);
@@ -367,6 +378,25 @@ bool AbstractSensorChannelInterface::hwBuffering()
     return getAccessor<bool>("hwBuffering");
 }
 
+bool AbstractSensorChannelInterface::useSharedMemoryTransport()
+{
+    clearError();
+    if (pimpl_->m_socketReader.hasSharedRing())
+        return true;
+
+    QDBusReply<QDBusUnixFileDescriptor> reply(call(QDBus::Block, QLatin1String("openSharedRing"),
+                                                   QVariant::fromValue(pimpl_->m_sessionId)));
+    if (!reply.isValid() || !reply.value().isValid()) {
+        qDebug() << "Shared memory transport not available, using socket";
+        return false;
+    }
+    if (!pimpl_->m_socketReader.attachSharedRing(reply.value().fileDescriptor())) {
+        setError(SClientSocketError, "Failed to map shared memory ring.");
+        return false;
+    }
+    return true;
+}
+
 int AbstractSensorChannelInterface::sessionId() const
 {
     return pimpl_->m_sessionId;
@@ -489,10 +519,61 @@ void AbstractSensorChannelInterface::clearError()
 
 void AbstractSensorChannelInterface::dataReceived()
 {
+    if (pimpl_->m_batchBuffer) {
+        batchDataReceived();
+        return;
+    }
+
     do {
         if (!dataReceivedImpl())
             return;
-    } while (pimpl_->m_socketReader.socket()->bytesAvailable());
+    } while (pimpl_->m_socketReader.hasPendingData());
+}
+
+void AbstractSensorChannelInterface::batchDataReceived()
+{
+    // A full buffer may leave data pending without a new notification
+    int capacity;
+    int count;
+    do {
+        quint64 firstTimestamp = 0;
+        quint64 lastTimestamp = 0;
+        capacity = pimpl_->m_batchCapacity;
+        count = pimpl_->m_batchDecoder(pimpl_->m_socketReader, pimpl_->m_batchBuffer, capacity,
+                                       firstTimestamp, lastTimestamp);
+        if (count > 0)
+            pimpl_->m_batchCallback(pimpl_->m_batchBuffer, count, firstTimestamp, lastTimestamp,
+                                    pimpl_->m_batchUserData);
+    } while (count == capacity && pimpl_->m_batchBuffer);
+}
+
+bool AbstractSensorChannelInterface::setBatchBuffer(void* buffer, int capacity, BatchDecoder decoder,
+                                                    SensorBatchCallback callback, void* userData)
+{
+    if (!buffer || capacity <= 0 || !callback) {
+        qWarning() << "Invalid batch buffer";
+        return false;
+    }
+    pimpl_->m_batchBuffer = buffer;
+    pimpl_->m_batchCapacity = capacity;
+    pimpl_->m_batchDecoder = decoder;
+    pimpl_->m_batchCallback = callback;
+    pimpl_->m_batchUserData = userData;
+    return true;
+}
+
+void AbstractSensorChannelInterface::clearBatchBuffer()
+{
+    pimpl_->m_batchBuffer = nullptr;
+    pimpl_->m_batchCapacity = 0;
+    pimpl_->m_batchDecoder = nullptr;
+    pimpl_->m_batchCallback = nullptr;
+    pimpl_->m_batchUserData = nullptr;
+}
+
+QVariantMap AbstractSensorChannelInterface::receiveStatistics() const
+{
+    return pimpl_->m_socketReader.statistics();
 }
 
 bool AbstractSensorChannelInterface::read(void* buffer, int size)
@@ -39,6 +39,20 @@
 #include "socketreader.h"
 #include "datatypes/datarange.h"
 
+/**
+ * Callback receiving samples delivered into a buffer registered with
+ * AbstractSensorChannelInterface::setBatchBuffer().
+ *
+ * @param samples the registered buffer, holding \a count samples.
+ * @param count number of samples in the batch.
+ * @param firstTimestamp timestamp of the first sample.
+ * @param lastTimestamp timestamp of the last sample.
+ * @param userData pointer given at registration.
+ */
+typedef void (*SensorBatchCallback)(const void* samples, int count,
+                                    quint64 firstTimestamp, quint64 lastTimestamp,
+                                    void* userData);
+
 /**
  * Base-class for client facades of different sensor types.
  */
@@ -296,6 +310,50 @@ public:
      */
     bool hwBuffering();
 
+    /**
+     * Request samples to be delivered through a shared memory ring
+     * instead of copying them through the data socket. Should be called
+     * before #start(). If sensord does not support it, the socket
+     * transport stays in use.
+     *
+     * @return was shared memory transport taken into use.
+     */
+    bool useSharedMemoryTransport();
+
+    /**
+     * Deliver samples in batches into given buffer instead of emitting
+     * signals. Samples available in the data socket are decoded straight
+     * into the buffer and \a callback is invoked once per buffer-full,
+     * so no signal is emitted and nothing is allocated per sample.
+     *
+     * \a T must be the sample type streamed by the sensor, for example
+     * AccelerationData for accelerometer or CompassData for compass. The
+     * buffer must stay valid until clearBatchBuffer() is called or the
+     * interface is destroyed.
+     *
+     * @param buffer array receiving the samples.
+     * @param capacity number of samples fitting into \a buffer.
+     * @param callback function to call with each batch.
+     * @param userData pointer passed to \a callback.
+     * @return was the buffer taken into use.
+     */
+    template<typename T>
+    bool setBatchBuffer(T* buffer, int capacity, SensorBatchCallback callback, void* userData = 0);
+
+    /**
+     * Stop batch delivery set up with setBatchBuffer(). Samples are
+     * emitted as signals again.
+     */
+    void clearBatchBuffer();
+
+    /**
+     * Get statistics of data received from sensord. For details see
+     * SocketReader::statistics().
+     *
+     * @return receive statistics.
+     */
+    QVariantMap receiveStatistics() const;
+
     /**
      * Does the current instance have valid connection established
      * to sensor daemon.
@@ -323,6 +381,30 @@ private:
      */
     SocketReader& getSocketReader() const;
 
+    /**
+     * Decoder of batches of given sample type.
+     */
+    typedef int (*BatchDecoder)(SocketReader& reader, void* values, int capacity,
+                                quint64& firstTimestamp, quint64& lastTimestamp);
+
+    /**
+     * Decode samples of type \a T from the data socket.
+     */
+    template<typename T>
+    static int decodeBatch(SocketReader& reader, void* values, int capacity,
+                           quint64& firstTimestamp, quint64& lastTimestamp);
+
+    /**
+     * Register batch buffer with type specific decoder.
+     */
+    bool setBatchBuffer(void* buffer, int capacity, BatchDecoder decoder,
+                        SensorBatchCallback callback, void* userData);
+
+    /**
+     * Deliver all available samples to the batch buffer.
+     */
+    void batchDataReceived();
+
 private Q_SLOTS: // METHODS
 
     void displayStateChanged(bool displayState);
@@ -430,6 +512,17 @@ protected:
     template<typename T>
     bool read(QVector<T>& values);
 
+    /**
+     * Read data from socket into caller provided array.
+     *
+     * @tparam Type to which to convert raw data.
+     * @param values Array for data.
+     * @param capacity Number of objects fitting into the array.
+     * @return number of objects read, -1 on error.
+     */
+    template<typename T>
+    int readSamples(T* values, int capacity);
+
     /**
      * Callback for subclasses in which they must read their expected data
      * from socket.
@@ -511,6 +604,32 @@ bool AbstractSensorChannelInterface::read(QVector<T>& values)
     return getSocketReader().read(values);
 }
 
+template<typename T>
+int AbstractSensorChannelInterface::readSamples(T* values, int capacity)
+{
+    return getSocketReader().readSamples<T>(values, capacity);
+}
+
+template<typename T>
+bool AbstractSensorChannelInterface::setBatchBuffer(T* buffer, int capacity, SensorBatchCallback callback, void* userData)
+{
+    static_assert(SensorWireFormat<T>::declared, "Type is not streamed by sensors");
+    return setBatchBuffer(buffer, capacity, &AbstractSensorChannelInterface::decodeBatch<T>, callback, userData);
+}
+
+template<typename T>
+int AbstractSensorChannelInterface::decodeBatch(SocketReader& reader, void* values, int capacity,
+                                                quint64& firstTimestamp, quint64& lastTimestamp)
+{
+    T* samples = static_cast<T*>(values);
+    int count = reader.readSamples<T>(samples, capacity);
+    if (count > 0) {
+        firstTimestamp = samples[0].timestamp_;
+        lastTimestamp = samples[count - 1].timestamp_;
+    }
+    return count;
+}
+
 template<typename T>
 T AbstractSensorChannelInterface::getAccessor(const char* name)
 {
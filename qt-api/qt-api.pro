@@ -9,6 +9,7 @@ SOURCES += sensormanagerinterface.cpp \
     sensormanager_i.cpp \
     abstractsensor_i.cpp \
     socketreader.cpp \
+    socketmultiplexer.cpp \
     compasssensor_i.cpp \
     orientationsensor_i.cpp \
     accelerometersensor_i.cpp \
@@ -28,6 +29,7 @@ HEADERS += sensormanagerinterface.h \
     sensormanager_i.h \
     abstractsensor_i.h \
     socketreader.h \
+    socketmultiplexer.h \
     compasssensor_i.h \
     orientationsensor_i.h \
     accelerometersensor_i.h \
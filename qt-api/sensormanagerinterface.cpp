@@ -34,6 +34,7 @@ QMutex SensorManagerInterface::mutex_;
 
 SensorManagerInterface::SensorManagerInterface()
   : LocalSensorManagerInterface( SERVICE_NAME, OBJECT_PATH, QDBusConnection::systemBus() )
+  , multiplexedTransport_(false)
 {
 }
 
@@ -88,3 +89,13 @@ bool SensorManagerInterface::releaseInterface(const QString& id, int sessionId)
     }
     return reply.value();
 }
+
+void SensorManagerInterface::setMultiplexedTransport(bool enable)
+{
+    multiplexedTransport_ = enable;
+}
+
+bool SensorManagerInterface::multiplexedTransport() const
+{
+    return multiplexedTransport_;
+}
@@ -55,11 +55,19 @@ public:
 
     bool registeredAndCorrectClassName(const QString& id, const QString& className ) const;
 
+    /**
+     * Make sensors created after this call share a single data connection.
+     * Their samples are delivered in timestamp order across sensors.
+     */
+    void setMultiplexedTransport(bool enable);
+    bool multiplexedTransport() const;
+
 protected:
     SensorManagerInterface();
     virtual ~SensorManagerInterface() {}
 
     QMap<QString, SensorInterfaceEntry> sensorInterfaceMap_;
+    bool multiplexedTransport_;
 
     static SensorManagerInterface* ifc_;
     static QMutex mutex_;
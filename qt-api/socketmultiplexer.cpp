@@ -0,0 +1,247 @@
+/**
+   @file socketmultiplexer.cpp
+   @brief Shared data connection for several sensor interfaces
+
+   <p>
+   Copyright (c) 2026 Jolla Mobile Ltd
+
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "socketmultiplexer.h"
+#include "socketreader.h"
+
+#include <QDebug>
+#include <QList>
+#include <limits>
+
+namespace {
+/** Largest sample size accepted from the stream. */
+const unsigned int maxSampleSize = 1024;
+}
+
+SocketMultiplexer* SocketMultiplexer::instance_ = nullptr;
+
+SocketMultiplexer& SocketMultiplexer::instance()
+{
+    if (!instance_)
+        instance_ = new SocketMultiplexer();
+    return *instance_;
+}
+
+SocketMultiplexer::SocketMultiplexer()
+    : QObject()
+    , socket_(nullptr)
+    , tagRead_(false)
+{
+    received_.reserve(4096);
+}
+
+bool SocketMultiplexer::attach(int sessionId, SocketReader* reader)
+{
+    if (channels_.contains(sessionId)) {
+        qDebug() << "[SOCKETMULTIPLEXER]: Session" << sessionId << "is already attached";
+        return false;
+    }
+    if (!socket_ && !connectToServer())
+        return false;
+
+    if (socket_->write((const char*)&sessionId, sizeof(sessionId)) != sizeof(sessionId)) {
+        qDebug() << "[SOCKETMULTIPLEXER]: SessionId write failed: " << socket_->errorString();
+        return false;
+    }
+    socket_->flush();
+
+    Channel channel;
+    channel.reader = reader;
+    channels_.insert(sessionId, channel);
+    return true;
+}
+
+void SocketMultiplexer::detach(int sessionId)
+{
+    channels_.remove(sessionId);
+    if (channels_.isEmpty())
+        disconnectFromServer();
+}
+
+bool SocketMultiplexer::isConnected() const
+{
+    return socket_ && socket_->isValid() && socket_->state() == QLocalSocket::ConnectedState;
+}
+
+bool SocketMultiplexer::connectToServer()
+{
+    socket_ = new QLocalSocket(this);
+    socket_->connectToServer(QString::fromLocal8Bit(SocketReader::serverName()), QIODevice::ReadWrite);
+    if (socket_->state() != QLocalSocket::ConnectedState) {
+        qDebug() << socket_->errorString();
+        disconnectFromServer();
+        return false;
+    }
+
+    int multiplex = SENSOR_WIRE_MULTIPLEX;
+    socket_->write((const char*)&multiplex, sizeof(multiplex));
+    socket_->flush();
+    tagRead_ = false;
+
+    connect(socket_, SIGNAL(readyRead()), this, SLOT(dataReceived()));
+    return true;
+}
+
+void SocketMultiplexer::disconnectFromServer()
+{
+    if (!socket_)
+        return;
+
+    // May be called from a reader while the socket is being read
+    socket_->disconnect(this);
+    socket_->abort();
+    socket_->deleteLater();
+    socket_ = nullptr;
+    received_.resize(0);
+}
+
+void SocketMultiplexer::dataReceived()
+{
+    if (!socket_)
+        return;
+
+    qint64 available = socket_->bytesAvailable();
+    if (available > 0) {
+        int size = received_.size();
+        received_.resize(size + available);
+        qint64 bytes = socket_->read(received_.data() + size, available);
+        received_.resize(size + (bytes > 0 ? bytes : 0));
+    }
+
+    if (!tagRead_) {
+        if (received_.isEmpty())
+            return;
+        char tag = received_.at(0);
+        received_.remove(0, 1);
+        if (tag != SENSOR_WIRE_TAG) {
+            qWarning() << "[SOCKETMULTIPLEXER]: Unsupported data socket version tag" << (int)tag
+                       << ", expected version" << SENSOR_WIRE_VERSION;
+            disconnectFromServer();
+            return;
+        }
+        tagRead_ = true;
+    }
+
+    if (!splitFrames()) {
+        qWarning() << "[SOCKETMULTIPLEXER]: Corrupted data in socket. Flushing it to empty";
+        received_.resize(0);
+        socket_->readAll();
+    }
+    deliver();
+}
+
+bool SocketMultiplexer::splitFrames()
+{
+    const int headerSize = sizeof(SensorWireChannelHeader);
+    int offset = 0;
+    bool valid = true;
+
+    while (received_.size() - offset >= headerSize) {
+        SensorWireChannelHeader header;
+        memcpy(&header, received_.constData() + offset, headerSize);
+        if (header.count > SENSOR_WIRE_MAX_FRAME_SAMPLES || header.sampleSize > maxSampleSize
+            || (header.count && !header.sampleSize)) {
+            valid = false;
+            break;
+        }
+
+        int bytes = header.count * header.sampleSize;
+        if (received_.size() - offset - headerSize < bytes)
+            break;
+
+        QMap<int, Channel>::iterator it = channels_.find(header.channel);
+        if (it != channels_.end()) {
+            if (!header.count) {
+                it->wakeup = true;
+            } else {
+                if (it->sampleSize != header.sampleSize && it->offset < it->samples.size()) {
+                    qWarning() << "[SOCKETMULTIPLEXER]: Sample size of session" << header.channel
+                               << "changed, dropping undelivered samples";
+                    it->samples.resize(0);
+                    it->offset = 0;
+                }
+                it->sampleSize = header.sampleSize;
+                it->samples.append(received_.constData() + offset + headerSize, bytes);
+            }
+        }
+        offset += headerSize + bytes;
+    }
+
+    received_.remove(0, offset);
+    return valid;
+}
+
+void SocketMultiplexer::deliver()
+{
+    // Readers may detach sessions while handling data, so channels are
+    // looked up again after every delivery.
+    QList<int> sessions = channels_.keys();
+    foreach (int sessionId, sessions) {
+        QMap<int, Channel>::iterator it = channels_.find(sessionId);
+        if (it != channels_.end() && it->wakeup) {
+            it->wakeup = false;
+            it->reader->feed(nullptr, 0, 0);
+        }
+    }
+
+    forever {
+        // Find the channel with the oldest sample, and how far it may
+        // proceed before another channel has older samples.
+        int next = -1;
+        quint64 oldest = 0;
+        quint64 limit = std::numeric_limits<quint64>::max();
+        for (QMap<int, Channel>::const_iterator it = channels_.constBegin(); it != channels_.constEnd(); ++it) {
+            if (it->offset >= it->samples.size())
+                continue;
+            quint64 timestamp = sensorWireTimestamp(it->samples.constData() + it->offset, it->sampleSize);
+            if (next < 0 || timestamp < oldest) {
+                if (next >= 0)
+                    limit = qMin(limit, oldest);
+                next = it.key();
+                oldest = timestamp;
+            } else {
+                limit = qMin(limit, timestamp);
+            }
+        }
+        if (next < 0)
+            break;
+
+        Channel& channel = channels_[next];
+        const char* data = channel.samples.constData() + channel.offset;
+        unsigned int available = (channel.samples.size() - channel.offset) / channel.sampleSize;
+        unsigned int count = 1;
+        while (count < available && count < SENSOR_WIRE_MAX_FRAME_SAMPLES
+               && sensorWireTimestamp(data + count * channel.sampleSize, channel.sampleSize) <= limit)
+            ++count;
+        channel.offset += count * channel.sampleSize;
+
+        // Samples are copied by the reader before it emits anything
+        channel.reader->feed(data, channel.sampleSize, count);
+
+        QMap<int, Channel>::iterator it = channels_.find(next);
+        if (it != channels_.end() && it->offset >= it->samples.size()) {
+            it->samples.resize(0);
+            it->offset = 0;
+        }
+    }
+}
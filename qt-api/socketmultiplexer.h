@@ -0,0 +1,140 @@
+/**
+   @file socketmultiplexer.h
+   @brief Shared data connection for several sensor interfaces
+
+   <p>
+   Copyright (c) 2026 Jolla Mobile Ltd
+
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef SOCKETMULTIPLEXER_H
+#define SOCKETMULTIPLEXER_H
+
+#include <QObject>
+#include <QLocalSocket>
+#include <QByteArray>
+#include <QMap>
+
+class SocketReader;
+
+/**
+ * @brief Single data connection shared by all multiplexed sessions
+ *
+ * sensord sends frames of every attached session over one connection,
+ * tagged with the session ID. Each time the connection becomes readable
+ * all received frames are split to their sessions and delivered to the
+ * SocketReaders in timestamp order across sessions, so a client using
+ * several sensors gets a single wakeup per batch and sees samples of
+ * different sensors in the order they were measured.
+ */
+class SocketMultiplexer : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(SocketMultiplexer)
+
+public:
+    /**
+     * Get the multiplexer of the process.
+     *
+     * @return multiplexer instance.
+     */
+    static SocketMultiplexer& instance();
+
+    /**
+     * Attach session to the shared connection. The connection is opened
+     * when the first session is attached.
+     *
+     * @param sessionId ID of the session.
+     * @param reader reader receiving samples of the session.
+     * @return was the session attached.
+     */
+    bool attach(int sessionId, SocketReader* reader);
+
+    /**
+     * Stop delivering samples of the session. The connection is closed
+     * when the last session is detached.
+     *
+     * @param sessionId ID of the session.
+     */
+    void detach(int sessionId);
+
+    /**
+     * Returns whether the shared connection is open.
+     *
+     * @return is socket connected.
+     */
+    bool isConnected() const;
+
+private Q_SLOTS:
+    /**
+     * Callback for pending data in the shared connection.
+     */
+    void dataReceived();
+
+private:
+    /**
+     * Constructor.
+     */
+    SocketMultiplexer();
+
+    /**
+     * Open the shared connection.
+     *
+     * @return was the connection established.
+     */
+    bool connectToServer();
+
+    /**
+     * Close the shared connection.
+     */
+    void disconnectFromServer();
+
+    /**
+     * Move complete frames from the receive buffer to their channels.
+     *
+     * @return \c false if the stream was corrupted.
+     */
+    bool splitFrames();
+
+    /**
+     * Deliver samples of all channels in timestamp order.
+     */
+    void deliver();
+
+    /**
+     * Samples of a single session waiting for delivery.
+     */
+    struct Channel
+    {
+        Channel() : reader(nullptr), sampleSize(0), offset(0), wakeup(false) {}
+
+        SocketReader* reader;    /**< reader of the session */
+        unsigned int sampleSize; /**< size of samples in \c samples */
+        QByteArray samples;      /**< received samples */
+        int offset;              /**< start of undelivered samples */
+        bool wakeup;             /**< wakeup for shared ring received */
+    };
+
+    static SocketMultiplexer* instance_; /**< multiplexer of the process */
+
+    QLocalSocket* socket_;       /**< shared data connection to sensord */
+    bool tagRead_;               /**< is initial magic byte read from the socket */
+    QByteArray received_;        /**< bytes received but not yet split */
+    QMap<int, Channel> channels_; /**< attached sessions */
+};
+
+#endif // SOCKETMULTIPLEXER_H
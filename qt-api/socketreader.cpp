@@ -25,39 +25,60 @@
  */
 
 #include "socketreader.h"
+#include "socketmultiplexer.h"
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 const char* SocketReader::channelIDString = "_SENSORCHANNEL_";
 
 SocketReader::SocketReader(QObject* parent)
     : QObject(parent)
     , socket_(nullptr)
+    , multiplexed_(false)
+    , sessionId_(-1)
     , tagRead_(false)
+    , ringMapping_(nullptr)
+    , ringSize_(0)
+    , receivedOffset_(0)
+    , frameRemaining_(0)
+    , partial_(false)
+    , partialFrames_(0)
+    , maxPartialWait_us_(0)
 {
+    // Reserved capacity is kept when the buffer is emptied
+    received_.reserve(4096);
 }
 
 SocketReader::~SocketReader()
 {
-    if (socket_) {
+    if (socket_ || multiplexed_) {
         dropConnection();
     }
 }
 
-bool SocketReader::initiateConnection(int sessionId)
+QByteArray SocketReader::serverName()
 {
-    if (socket_ != nullptr) {
-        qDebug() << "attempting to initiate connection on connected socket";
-        return false;
-    }
-
-    socket_ = new QLocalSocket(this);
     const char* SOCKET_NAME = "/run/sensord.sock";
     QByteArray env = qgetenv("SENSORFW_SOCKET_PATH");
     if (!env.isEmpty()) {
         env += SOCKET_NAME;
-        SOCKET_NAME = env;
+        return env;
+    }
+    return SOCKET_NAME;
+}
+
+bool SocketReader::initiateConnection(int sessionId)
+{
+    if (socket_ != nullptr || multiplexed_) {
+        qDebug() << "attempting to initiate connection on connected socket";
+        return false;
     }
 
-    socket_->connectToServer(SOCKET_NAME, QIODevice::ReadWrite);
+    socket_ = new QLocalSocket(this);
+    connect(socket_, SIGNAL(readyRead()), this, SIGNAL(readyRead()));
+    socket_->connectToServer(QString::fromLocal8Bit(serverName()), QIODevice::ReadWrite);
 
     if (!(socket_->serverName().size())) {
         qDebug() << socket_->errorString();
@@ -68,23 +89,47 @@ bool SocketReader::initiateConnection(int sessionId)
         qDebug() << "[SOCKETREADER]: SessionId write failed: " << socket_->errorString();
     }
     socket_->flush();
-    readSocketTag();
 
     return true;
 }
 
-bool SocketReader::dropConnection()
+bool SocketReader::initiateMultiplexedConnection(int sessionId)
 {
-    if (!socket_)
+    if (socket_ != nullptr || multiplexed_) {
+        qDebug() << "attempting to initiate connection on connected socket";
+        return false;
+    }
+
+    if (!SocketMultiplexer::instance().attach(sessionId, this))
         return false;
+    multiplexed_ = true;
+    sessionId_ = sessionId;
+    tagRead_ = true;
+    return true;
+}
 
-    socket_->disconnectFromServer();
-    if (socket_->state() != QLocalSocket::UnconnectedState)
-        socket_->waitForDisconnected();
-    delete socket_;
-    socket_ = nullptr;
+bool SocketReader::dropConnection()
+{
+    if (multiplexed_) {
+        SocketMultiplexer::instance().detach(sessionId_);
+        multiplexed_ = false;
+        sessionId_ = -1;
+    } else if (socket_) {
+        socket_->disconnectFromServer();
+        if (socket_->state() != QLocalSocket::UnconnectedState)
+            socket_->waitForDisconnected();
+        delete socket_;
+        socket_ = nullptr;
+    } else {
+        return false;
+    }
 
     tagRead_ = false;
+    detachSharedRing();
+    received_.clear();
+    receivedOffset_ = 0;
+    frameRemaining_ = 0;
+    partial_ = false;
 
     return true;
 }
@@ -94,39 +139,166 @@ QLocalSocket* SocketReader::socket()
     return socket_;
 }
 
+bool SocketReader::hasPendingData()
+{
+    if (socket_)
+        return socket_->bytesAvailable() > 0;
+    return receivedOffset_ < received_.size();
+}
+
+void SocketReader::feed(const char* samples, unsigned int sampleSize, unsigned int count)
+{
+    // Keep the frame layout of a plain connection, so decoding is shared
+    fillReceiveBuffer();
+    received_.append((const char*)&count, sizeof(count));
+    received_.append(samples, sampleSize * count);
+    emit readyRead();
+}
+
 bool SocketReader::readSocketTag()
 {
-    char foo;
-    socket_->waitForReadyRead();
-    tagRead_ = read(&foo, 1);
+    char tag;
+    if (tagRead_ || socket_->read(&tag, 1) != 1)
+        return tagRead_;
+
+    if (tag != SENSOR_WIRE_TAG) {
+        qWarning() << "[SOCKETREADER]: Unsupported data socket version tag" << (int)tag
+                   << ", expected version" << SENSOR_WIRE_VERSION;
+        socket_->abort();
+        return false;
+    }
+    tagRead_ = true;
     return true;
 }
 
 bool SocketReader::read(void* buffer, int size)
 {
-    int bytesRead = 0;
-    int retry = 100;
-
-    while (bytesRead < size) {
-        int bytes = socket_->read((char *)buffer + bytesRead, size);
-        if (bytes == 0) {
-            if (!retry)
-                return false;
-            struct timespec ts;
-            ts.tv_sec = 0;
-            ts.tv_nsec = 100000000;
-            nanosleep(&ts, NULL);
-            --retry;
-            continue;
-        }
-        if (bytes < 1)
-            return false;
-        bytesRead += bytes;
+    if (!socket_ && !multiplexed_)
+        return false;
+
+    fillReceiveBuffer();
+    bool complete = received_.size() - receivedOffset_ >= size;
+    if (complete) {
+        memcpy(buffer, received_.constData() + receivedOffset_, size);
+        receivedOffset_ += size;
+    }
+    updatePartialState();
+    return complete && size > 0;
+}
+
+void SocketReader::updatePartialState()
+{
+    bool partial = frameRemaining_ > 0 || receivedOffset_ < received_.size();
+    if (partial && !partial_) {
+        ++partialFrames_;
+        partialTimer_.start();
+    } else if (!partial && partial_) {
+        maxPartialWait_us_ = qMax(maxPartialWait_us_, partialTimer_.nsecsElapsed() / 1000);
     }
-    return bytesRead > 0;
+    partial_ = partial;
+}
+
+QVariantMap SocketReader::statistics() const
+{
+    QVariantMap stats;
+    stats.insert("partialFrames", partialFrames_);
+    stats.insert("bufferedBytes", received_.size() - receivedOffset_);
+    stats.insert("maxPartialWait_us", maxPartialWait_us_);
+    stats.insert("latency", latency_.summary());
+    return stats;
+}
+
+void SocketReader::recordLatency(const void* sample, unsigned int size)
+{
+    if (latency_.sample())
+        latency_.recordSinceSampleTime(sensorWireTimestamp((const char*)sample, size));
 }
 
 bool SocketReader::isConnected()
 {
+    if (multiplexed_)
+        return SocketMultiplexer::instance().isConnected();
     return (socket_ && socket_->isValid() && socket_->state() == QLocalSocket::ConnectedState);
 }
+
+bool SocketReader::attachSharedRing(int fd)
+{
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(SessionRingHeader)) {
+        qDebug() << "[SOCKETREADER]: Invalid shared ring descriptor";
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        qDebug() << "[SOCKETREADER]: Failed to map shared ring: " << strerror(errno);
+        return false;
+    }
+
+    SessionRingReader reader;
+    if (!reader.attach(mapping, st.st_size)) {
+        qDebug() << "[SOCKETREADER]: Incompatible shared ring";
+        munmap(mapping, st.st_size);
+        return false;
+    }
+
+    detachSharedRing();
+    ringMapping_ = mapping;
+    ringSize_ = st.st_size;
+    ring_ = reader;
+    return true;
+}
+
+bool SocketReader::hasSharedRing() const
+{
+    return ringMapping_ != nullptr;
+}
+
+void SocketReader::detachSharedRing()
+{
+    if (ringMapping_) {
+        munmap(ringMapping_, ringSize_);
+        ringMapping_ = nullptr;
+        ringSize_ = 0;
+        ring_ = SessionRingReader();
+    }
+}
+
+void SocketReader::clearWakeups()
+{
+    flushReceiveBuffer();
+}
+
+void SocketReader::fillReceiveBuffer()
+{
+    // Drop consumed bytes, keeping the allocation for reuse
+    if (receivedOffset_) {
+        int remaining = received_.size() - receivedOffset_;
+        if (remaining)
+            memmove(received_.data(), received_.constData() + receivedOffset_, remaining);
+        received_.resize(remaining);
+        receivedOffset_ = 0;
+    }
+
+    if (!socket_ || !readSocketTag())
+        return;
+
+    qint64 available = socket_->bytesAvailable();
+    if (available <= 0)
+        return;
+
+    int size = received_.size();
+    received_.resize(size + available);
+    qint64 bytes = socket_->read(received_.data() + size, available);
+    received_.resize(size + (bytes > 0 ? bytes : 0));
+}
+
+void SocketReader::flushReceiveBuffer()
+{
+    // Read through the receive buffer so that the tag gets validated
+    fillReceiveBuffer();
+    received_.resize(0);
+    receivedOffset_ = 0;
+    frameRemaining_ = 0;
+    partial_ = false;
+}
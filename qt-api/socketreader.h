@@ -29,8 +29,15 @@
 
 #include <QObject>
 #include <QLocalSocket>
+#include <QByteArray>
 #include <QVector>
+#include <QVariantMap>
+#include <QElapsedTimer>
+#include <string.h>
 #include <QDebug>
+#include "sessionring.h"
+#include "latencyhistogram.h"
+#include <datatypes/wireformat.h>
 
 /**
  * @brief Helper class for reading socket datachannel from sensord
@@ -38,6 +45,12 @@
  * SocketReader provides common handler for all sensors using socket
  * data channel. It is used by AbstractSensorChannelInterface to maintain
  * the socket connection to the server.
+ *
+ * Reading never blocks. sensord may write a frame in pieces; bytes not
+ * yet forming a complete sample are kept in a receive buffer and decoded
+ * when the rest arrives. A sample is thus returned by the first read
+ * following the readyRead() which carries its last byte, and the reader
+ * adds no latency of its own.
  */
 class SocketReader : public QObject
 {
@@ -66,6 +79,15 @@ public:
      */
     bool initiateConnection(int sessionId);
 
+    /**
+     * Receive data of the session through the data connection shared
+     * by all multiplexed sessions of the process, see SocketMultiplexer.
+     *
+     * @param sessionId ID for the current session.
+     * @return was the session attached successfully.
+     */
+    bool initiateMultiplexedConnection(int sessionId);
+
     /**
      * Drops socket connection.
      * @return was the connection successfully closed.
@@ -76,15 +98,44 @@ public:
      * Provides access to the internal QLocalSocket for direct reading.
      *
      * @return Pointer to the internal QLocalSocket. Pointer can be \c NULL
-     *         if \c initiateConnection() has not been called successfully.
+     *         if \c initiateConnection() has not been called successfully
+     *         or the session is multiplexed.
      */
     QLocalSocket* socket();
 
     /**
-     * Attempt to read given number of bytes from the socket. As
-     * QLocalSocket is used, we are guaranteed that any number of bytes
-     * written in single operation are available for immediate reading
-     * with a single operation.
+     * Is there received data which has not been read yet.
+     *
+     * @return is data pending.
+     */
+    bool hasPendingData();
+
+    /**
+     * Discard all buffered and available data.
+     */
+    void flushReceiveBuffer();
+
+    /**
+     * Append samples received through a multiplexed connection to the
+     * receive buffer and emit readyRead(). Used by SocketMultiplexer.
+     *
+     * @param samples location of the samples.
+     * @param sampleSize size of a single sample.
+     * @param count number of samples, zero for a wakeup.
+     */
+    void feed(const char* samples, unsigned int sampleSize, unsigned int count);
+
+    /**
+     * Name of the sensord data socket.
+     *
+     * @return socket path.
+     */
+    static QByteArray serverName();
+
+    /**
+     * Attempt to read given number of bytes from the socket. If fewer
+     * bytes have been received, nothing is read and the received bytes
+     * stay buffered for a later call.
      *
      * @param size Number of bytes to read.
      * @param buffer Location for storing the data.
@@ -93,8 +144,9 @@ public:
     bool read(void* buffer, int size);
 
     /**
-     * Attempt to read objects from the sockets. The call blocks until
-     * there are minimum amount of expected bytes availabled in the socket.
+     * Attempt to read objects from the sockets. All complete objects
+     * available in the socket are read at once. Incomplete data is kept
+     * in an internal buffer until the rest of it arrives.
      *
      * @param values Vector to which objects will be appended.
      * @tparam T type of expected object in the stream.
@@ -103,6 +155,21 @@ public:
     template<typename T>
     bool read(QVector<T>& values);
 
+    /**
+     * Attempt to read objects from the socket straight into a caller
+     * provided array. Frames larger than the array are split between
+     * calls. Unless fewer than \a capacity objects are returned, further
+     * data may be pending without a new notification from the socket,
+     * so reading should be repeated until that happens.
+     *
+     * @param values location to store objects to.
+     * @param capacity number of objects fitting into \a values.
+     * @tparam T type of expected object in the stream.
+     * @return number of objects read, -1 on error.
+     */
+    template<typename T>
+    int readSamples(T* values, int capacity);
+
     /**
      * Returns whether the socket is currently connected.
      *
@@ -110,6 +177,39 @@ public:
      */
     bool isConnected();
 
+    /**
+     * Map shared memory ring received from sensord. After this samples
+     * are read from the ring and the socket only carries wakeups.
+     *
+     * @param fd memfd of the ring. Descriptor is not taken over.
+     * @return was the ring mapped succesfully.
+     */
+    bool attachSharedRing(int fd);
+
+    /**
+     * Is shared memory ring in use.
+     *
+     * @return is ring attached.
+     */
+    bool hasSharedRing() const;
+
+    /**
+     * Get statistics of split frames.
+     *
+     * @return map with partialFrames (reads which ended with a partially
+     *         received frame), bufferedBytes (bytes waiting for the rest
+     *         of their frame) and maxPartialWait_us (longest time a frame
+     *         waited for its remaining bytes) entries, and latency
+     *         summary of samples from their timestamp until read.
+     */
+    QVariantMap statistics() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when new data is available for reading.
+     */
+    void readyRead();
+
 private:
     /**
      * Prefix text needed to be written to the sensor daemon socket connection
@@ -118,38 +218,133 @@ private:
     static const char* channelIDString;
 
     /**
-     * Reads initial magic byte from the fresh connection.
+     * Validate initial magic byte of the connection once it is received.
+     *
+     * @return is the tag received and valid.
      */
     bool readSocketTag();
 
+    /**
+     * Track how long a partially received frame waits for its rest.
+     */
+    void updatePartialState();
+
+    /**
+     * Measure latency of a read sample, if it is sampled.
+     *
+     * @param sample location of the sample.
+     * @param size size of the sample.
+     */
+    void recordLatency(const void* sample, unsigned int size);
+
+    /**
+     * Discard pending wakeup notifications from the socket.
+     */
+    void clearWakeups();
+
+    /**
+     * Move everything available in the socket into the receive buffer.
+     */
+    void fillReceiveBuffer();
+
+    /**
+     * Decode samples from the receive buffer.
+     *
+     * @param values location to store samples to.
+     * @param capacity number of samples fitting into \a values.
+     * @return number of samples decoded, -1 if the stream was corrupted.
+     */
+    template<typename T>
+    int decodeReceived(T* values, int capacity);
+
+    /**
+     * Unmap shared memory ring.
+     */
+    void detachSharedRing();
+
     QLocalSocket* socket_; /**< socket data connection to sensord */
+    bool multiplexed_; /**< is data received through SocketMultiplexer */
+    int sessionId_; /**< session attached to SocketMultiplexer */
     bool tagRead_; /**< is initial magic byte read from the socket */
+    void* ringMapping_; /**< mapped shared memory ring or NULL */
+    size_t ringSize_; /**< size of the ring mapping */
+    SessionRingReader ring_; /**< shared memory ring reader */
+    QByteArray received_; /**< bytes received but not yet parsed */
+    int receivedOffset_; /**< start of unparsed data in received_ */
+    unsigned int frameRemaining_; /**< samples of a partially parsed frame */
+    bool partial_; /**< is a partially received frame buffered */
+    QElapsedTimer partialTimer_; /**< started when frame became partial */
+    unsigned int partialFrames_; /**< times a frame was left partial */
+    qint64 maxPartialWait_us_; /**< longest wait for rest of a frame */
+    LatencyHistogram latency_; /**< latency of read samples */
 };
 
 template<typename T>
 bool SocketReader::read(QVector<T>& values)
 {
-    if (!socket_) {
+    if (!socket_ && !multiplexed_) {
         return false;
     }
 
-    unsigned int count;
-    if (!read((void*)&count, sizeof(unsigned int))) {
-        socket_->readAll();
-        return false;
+    int oldSize = values.size();
+    if (ringMapping_) {
+        const int chunk = 32;
+        int count;
+        do {
+            int size = values.size();
+            values.resize(size + chunk);
+            count = readSamples<T>(values.data() + size, chunk);
+            values.resize(size + qMax(count, 0));
+        } while (count == chunk);
+    } else {
+        // Received bytes are an upper bound for the number of samples
+        fillReceiveBuffer();
+        int size = values.size();
+        values.resize(size + (received_.size() - receivedOffset_) / sizeof(T));
+        int count = decodeReceived<T>(values.data() + size, values.size() - size);
+        values.resize(size + qMax(count, 0));
     }
-    if (count > 1000) {
-        qWarning() << "Too many samples waiting in socket. Flushing it to empty";
-        socket_->readAll();
-        return false;
+    return values.size() > oldSize;
+}
+
+template<typename T>
+int SocketReader::readSamples(T* values, int capacity)
+{
+    if (!socket_ && !multiplexed_) {
+        return -1;
     }
-    values.resize(values.size() + count);
-    if (!read((void*)values.data(), sizeof(T) * count)) {
-        qWarning() << "Error occured while reading data from socket: " << socket_->errorString();
-        socket_->readAll();
-        return false;
+
+    if (ringMapping_) {
+        clearWakeups();
+        int count = ring_.read(values, sizeof(T), capacity);
+        while (count < capacity && ring_.requestWakeup())
+            count += ring_.read(values + count, sizeof(T), capacity - count);
+        if (count > 0)
+            recordLatency(values + count - 1, sizeof(T));
+        return count;
+    }
+
+    fillReceiveBuffer();
+    return decodeReceived<T>(values, capacity);
+}
+
+template<typename T>
+int SocketReader::decodeReceived(T* values, int capacity)
+{
+    int consumed;
+    int count = sensorWireDecode<T>(received_.constData() + receivedOffset_,
+                                    received_.size() - receivedOffset_,
+                                    values, capacity, frameRemaining_, consumed);
+    if (count < 0) {
+        qWarning() << "Too many samples waiting in socket. Flushing it to empty";
+        flushReceiveBuffer();
+        return -1;
     }
-    return true;
+    receivedOffset_ += consumed;
+    updatePartialState();
+    if (count > 0)
+        recordLatency(values + count - 1, sizeof(T));
+    return count;
 }
 
 #endif // SOCKETREADER_H
@@ -17,6 +17,7 @@ Requires(postun): systemd
 BuildRequires:  pkgconfig(Qt5Core)
 BuildRequires:  pkgconfig(Qt5DBus)
 BuildRequires:  pkgconfig(Qt5Network)
+BuildRequires:  pkgconfig(dbus-1)
 BuildRequires:  pkgconfig(Qt5Test)
 BuildRequires:  pkgconfig(mlite5)
 BuildRequires:  pkgconfig(libsystemd)
@@ -160,6 +161,7 @@ systemctl daemon-reload || :
 %attr(755,root,root)%{_bindir}/sensorapi-test
 %attr(755,root,root)%{_bindir}/sensorbenchmark-test
 %attr(755,root,root)%{_bindir}/sensorchains-test
+%attr(755,root,root)%{_bindir}/sensorcore-test
 %attr(755,root,root)%{_bindir}/sensordataflow-test
 %attr(755,root,root)%{_bindir}/sensord-deadclient
 %attr(755,root,root)%{_bindir}/sensordiverter.sh
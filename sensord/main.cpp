@@ -45,6 +45,8 @@
 #include "config.h"
 #include "sensormanager.h"
 #include "sensormanager_a.h"
+#include "loader.h"
+#include "startuptrace.h"
 #include "logging.h"
 #include "calibrationhandler.h"
 #include "parser.h"
@@ -75,6 +77,8 @@ static const QtMsgType typeForLevel[LevelCount] = {
 
 static LogLevel logLevel = LevelDebug;
 
+static QString startupTracePath;
+
 static LogLevel levelForType(QtMsgType type)
 {
     /* Map QtMsgType enum values to something that hopefully
@@ -134,6 +138,13 @@ static void signalUSR2(int param)
     foreach (const QString& line, output) {
         qCWarning(lcSensorFw) << line.toLocal8Bit().data();
     }
+
+    foreach (const QString& line, StartupTrace::printStatus()) {
+        qCWarning(lcSensorFw) << line.toLocal8Bit().data();
+    }
+    if (!startupTracePath.isEmpty()) {
+        StartupTrace::writeChromeTrace(startupTracePath);
+    }
 }
 
 static void signalINT(int param)
@@ -226,6 +237,7 @@ const int SignalNotifier::s_signals[] =
 
 int main(int argc, char *argv[])
 {
+    StartupTrace::mark("phase", "main");
     QCoreApplication app(argc, argv);
     Parser parser(app.arguments());
 
@@ -250,11 +262,19 @@ int main(int argc, char *argv[])
         defConfigDir = parser.configDirPath();
     }
 
-    if (!SensorFrameworkConfig::loadConfig(defConfigFile, defConfigDir)) {
-        qCCritical(lcSensorFw) << "SensorFrameworkConfig file error! Load using default paths.";
-        if (!SensorFrameworkConfig::loadConfig(CONFIG_FILE_PATH, CONFIG_DIR_PATH)) {
-            qCCritical(lcSensorFw) << "Which also failed. Bailing out";
-            return 1;
+    QString configCache;
+    if (parser.configCacheInput()) {
+        configCache = parser.configCachePath();
+    }
+
+    {
+        StartupTrace::Scope trace("phase", "loadConfig");
+        if (!SensorFrameworkConfig::loadConfig(defConfigFile, defConfigDir, configCache)) {
+            qCCritical(lcSensorFw) << "SensorFrameworkConfig file error! Load using default paths.";
+            if (!SensorFrameworkConfig::loadConfig(CONFIG_FILE_PATH, CONFIG_DIR_PATH)) {
+                qCCritical(lcSensorFw) << "Which also failed. Bailing out";
+                return 1;
+            }
         }
     }
 
@@ -272,29 +292,51 @@ int main(int argc, char *argv[])
         }
     }
 
+    {
+        StartupTrace::Scope trace("phase", "SensorManager");
+        SensorManager::instance();
+    }
     SensorManager& sm = SensorManager::instance();
 
+    if (parser.pluginManifestInput()) {
+        Loader::instance().preloadFromManifest(parser.pluginManifestPath());
+    }
+
+    /* Plugins loaded at startup are not needed for serving clients, so
+     * the service is made available before loading them. */
+    {
+        StartupTrace::Scope trace("phase", "registerService");
+        if (!sm.registerService()) {
+            qCWarning(lcSensorFw) << "Failed to register service on D-Bus. Aborting.";
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (parser.notifySystemd()) {
+        sd_notify(0, "READY=1");
+    }
+    StartupTrace::mark("phase", "ready");
+
 #ifdef PROVIDE_CONTEXT_INFO
     if (parser.contextInfo()) {
+        StartupTrace::Scope trace("phase", "context sensors");
         qCInfo(lcSensorFw) << "Loading ContextSensor " << sm.loadPlugin("contextsensor");
         qCInfo(lcSensorFw) << "Loading ALSSensor " << sm.loadPlugin("alssensor");
     }
 #endif
 
     if (parser.magnetometerCalibration()) {
+        StartupTrace::Scope trace("phase", "calibration");
         CalibrationHandler* calibrationHandler_ = new CalibrationHandler(nullptr);
         calibrationHandler_->initiateSession();
         QObject::connect(&sm, SIGNAL(resumeCalibration()), calibrationHandler_, SLOT(resumeCalibration()));
         QObject::connect(&sm, SIGNAL(stopCalibration()), calibrationHandler_, SLOT(stopCalibration()));
     }
 
-    if (!sm.registerService()) {
-        qCWarning(lcSensorFw) << "Failed to register service on D-Bus. Aborting.";
-        exit(EXIT_FAILURE);
-    }
-
-    if (parser.notifySystemd()) {
-        sd_notify(0, "READY=1");
+    StartupTrace::mark("phase", "started");
+    if (parser.startupTraceInput()) {
+        startupTracePath = parser.startupTracePath();
+        StartupTrace::writeChromeTrace(startupTracePath);
     }
 
     SignalNotifier *signalNotifier = new SignalNotifier();
@@ -337,6 +379,12 @@ void printUsage()
     qDebug() << "                                  'info', 'warning', 'critical'.\n";
     qDebug() << " -c=P, --config-file=<path>       Load configuration from given path. By default";
     qDebug() << "                                  /etc/sensorfw/sensord.conf is used.\n";
+    qDebug() << " --config-cache=<path>            Cache parsed configuration to given path and";
+    qDebug() << "                                  use it while configuration files are unchanged.\n";
+    qDebug() << " --plugin-manifest=<path>         Record loaded plugins to given path and preload";
+    qDebug() << "                                  them in the background on next start.\n";
+    qDebug() << " --startup-trace=<path>           Write trace of startup to given path as Chrome";
+    qDebug() << "                                  trace JSON. Rewritten on SIGUSR2.\n";
     qDebug() << " --no-context-info                Do not provide context information for context";
     qDebug() << "                                  framework.\n";
     qDebug() << " --no-magnetometer-bg-calibration Do not start calibration of magnetometer in";
@@ -33,6 +33,9 @@ Parser::Parser(QStringList arguments) :
     contextInfo_(true),
     configFile_(false),
     configDir_(false),
+    configCache_(false),
+    pluginManifest_(false),
+    startupTrace_(false),
     daemon_(false),
     systemd_(false),
     magnetometerCalibration_(true),
@@ -75,6 +78,18 @@ void Parser::parsingCommandLine(QStringList arguments)
             data = opt.split("=");
             configDir_ = true;
             configDirPath_ = data.at(1);
+        } else if (opt.startsWith("--config-cache")) {
+            data = opt.split("=");
+            configCache_ = true;
+            configCachePath_ = data.at(1);
+        } else if (opt.startsWith("--plugin-manifest")) {
+            data = opt.split("=");
+            pluginManifest_ = true;
+            pluginManifestPath_ = data.at(1);
+        } else if (opt.startsWith("--startup-trace")) {
+            data = opt.split("=");
+            startupTrace_ = true;
+            startupTracePath_ = data.at(1);
         } else if (opt.startsWith("--no-context-info")) {
             contextInfo_ = false;
         } else if (opt.startsWith("--no-magnetometer-bg-calibration")) {
@@ -121,6 +136,36 @@ const QString& Parser::configDirPath() const
     return configDirPath_;
 }
 
+bool Parser::configCacheInput() const
+{
+    return configCache_;
+}
+
+const QString& Parser::configCachePath() const
+{
+    return configCachePath_;
+}
+
+bool Parser::pluginManifestInput() const
+{
+    return pluginManifest_;
+}
+
+const QString& Parser::pluginManifestPath() const
+{
+    return pluginManifestPath_;
+}
+
+bool Parser::startupTraceInput() const
+{
+    return startupTrace_;
+}
+
+const QString& Parser::startupTracePath() const
+{
+    return startupTracePath_;
+}
+
 bool Parser::contextInfo() const
 {
     return contextInfo_;
@@ -44,6 +44,12 @@ public:
     const QString& configFilePath() const;
     bool configDirInput() const;
     const QString& configDirPath() const;
+    bool configCacheInput() const;
+    const QString& configCachePath() const;
+    bool pluginManifestInput() const;
+    const QString& pluginManifestPath() const;
+    bool startupTraceInput() const;
+    const QString& startupTracePath() const;
 
     bool contextInfo() const;
     bool magnetometerCalibration() const;
@@ -57,12 +63,18 @@ private:
     bool contextInfo_;
     bool configFile_;
     bool configDir_;
+    bool configCache_;
+    bool pluginManifest_;
+    bool startupTrace_;
     bool daemon_;
     bool systemd_;
     bool magnetometerCalibration_;
 
     QString configFilePath_;
     QString configDirPath_;
+    QString configCachePath_;
+    QString pluginManifestPath_;
+    QString startupTracePath_;
     QtMsgType logLevel_;
 };
 
@@ -22,6 +22,7 @@ SUBDIRS = datatypes \
           sensors \
           sensord \
           qt-api \
+          c-api \
           chains \
           tests \
           examples
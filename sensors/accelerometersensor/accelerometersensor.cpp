@@ -45,9 +45,9 @@ AccelerometerSensorChannel::AccelerometerSensorChannel(const QString& id) :
     }
     setValid(accelerometerChain_->isValid());
 
-    accelerometerReader_ = new BufferReader<AccelerationData>(1);
+    accelerometerReader_ = new BufferReader<AccelerationData>(64);
 
-    outputBuffer_ = new RingBuffer<AccelerationData>(1);
+    outputBuffer_ = new RingBuffer<AccelerationData>(64);
 
     // Create buffers for filter chain
     filterBin_ = new Bin;
@@ -118,12 +118,6 @@ void AccelerometerSensorChannel::emitData(const AccelerationData& value)
     downsampleAndPropagate(value, downsampleBuffer_);
 }
 
-void AccelerometerSensorChannel::removeSession(int sessionId)
-{
-    downsampleBuffer_.remove(sessionId);
-    AbstractSensorChannel::removeSession(sessionId);
-}
-
 bool AccelerometerSensorChannel::downsamplingSupported() const
 {
     return true;
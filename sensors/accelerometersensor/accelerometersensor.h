@@ -67,8 +67,6 @@ public:
 
     XYZ get() const { return previousSample_; }
 
-    virtual void removeSession(int sessionId);
-
     virtual bool downsamplingSupported() const;
 
 public Q_SLOTS:
@@ -33,45 +33,46 @@ AvgVarFilter::AvgVarFilter(int size) :
 {
 }
 
-void AvgVarFilter::interpret(unsigned, const double* data)
+void AvgVarFilter::interpret(unsigned n, const double* data)
 {
-    double avg,var;
+    QPair<double, double>* avgVar = output_.reserve(n);
+    unsigned count = 0;
     {
         QMutexLocker locker(&mutex);
 
-        // Ramp-up-phase:
-        if (samplesReceived < size) {
-            samples[samplesReceived] = *data;
-            samplesSquared[samplesReceived] = (*data)*(*data);
-            sampleSum += *data;
-            sampleSquareSum += (*data)*(*data);
-            ++samplesReceived;
-            return;
+        for (unsigned i = 0; i < n; ++i) {
+            double value = data[i];
+
+            // Ramp-up-phase:
+            if (samplesReceived < size) {
+                samples[samplesReceived] = value;
+                samplesSquared[samplesReceived] = value * value;
+                sampleSum += value;
+                sampleSquareSum += value * value;
+                ++samplesReceived;
+                continue;
+            }
+
+            // Moving average & variance computations:
+            // Remove the oldest sample, replace with the new sample
+            sampleSum = sampleSum - samples[current] + value;
+            sampleSquareSum = sampleSquareSum - samples[current] * samples[current] + value * value;
+
+            // Take the new value in
+            samples[current] = value;
+            ++current;
+            if (current >= size) {
+                current = 0;
+            }
+
+            double avg = sampleSum / size;
+            double var = (size * sampleSquareSum - (sampleSum * sampleSum)) / (size * (size - 1));
+            avgVar[count++] = QPair<double, double>(avg, var);
         }
-
-        //qDebug() << "Data received on AvgVarFilter:" << *data;
-        //qDebug() << "Cur data:" << samples;
-
-        // Moving average & variance computations:
-        // Remove the oldest sample, replace with the new sample
-        sampleSum = sampleSum - samples[current] + *data;
-        sampleSquareSum = sampleSquareSum - samples[current] * samples[current] + (*data) * (*data);
-
-        // Take the new value in
-        samples[current] = *data;
-        ++current;
-        if (current >= size) {
-            current = 0;
-        }
-
-        avg = sampleSum / size;
-        var = (size * sampleSquareSum - (sampleSum * sampleSum)) / (size * (size - 1));
     }
 
-    //qDebug() << "Avg and var" << avg << var;
-
-    QPair<double, double> pair(avg, var);
-    source_.propagate(1, &pair);
+    if (count)
+        source_.propagate(count, avgVar);
 }
 
 // Start the ramp-up again
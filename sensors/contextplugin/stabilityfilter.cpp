@@ -41,31 +41,35 @@ StabilityFilter::StabilityFilter(Property* stableProperty, Property* unstablePro
     timeout = SensorFrameworkConfig::configuration()->value("context/stability_timeout", QVariant(defaultTimeout)).toInt() * 1000;
 }
 
-void StabilityFilter::interpret(unsigned, const QPair<double, double>* data)
+void StabilityFilter::interpret(unsigned n, const QPair<double, double>* data)
 {
-    // To take into account hysteresis and keep it simple, compute
-    // stability and instability separately
-    if (data->second < lowThreshold * (1 - hysteresis)) {
-        stableProperty->setValue(true);
-        timer.stop();
-    }
-    else {
-        timer.start(timeout);
+    for (unsigned i = 0; i < n; ++i) {
+        double variance = data[i].second;
 
-        if (data->second > lowThreshold * (1 + hysteresis)) {
-            stableProperty->setValue(false);
+        // To take into account hysteresis and keep it simple, compute
+        // stability and instability separately
+        if (variance < lowThreshold * (1 - hysteresis)) {
+            stableProperty->setValue(true);
+            timer.stop();
         }
-    }
+        else {
+            timer.start(timeout);
 
-    if (data->second < highThreshold * (1 - hysteresis)) {
-        unstableProperty->setValue(false);
-    }
-    else if (data->second > highThreshold * (1 + hysteresis)) {
-        unstableProperty->setValue(true);
+            if (variance > lowThreshold * (1 + hysteresis)) {
+                stableProperty->setValue(false);
+            }
+        }
+
+        if (variance < highThreshold * (1 - hysteresis)) {
+            unstableProperty->setValue(false);
+        }
+        else if (variance > highThreshold * (1 + hysteresis)) {
+            unstableProperty->setValue(true);
+        }
     }
 
     // Propagate the data further without changing it
-    source_.propagate(1, data);
+    source_.propagate(n, data);
 }
 
 void StabilityFilter::timeoutTriggered()
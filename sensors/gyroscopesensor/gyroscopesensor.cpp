@@ -43,9 +43,9 @@ GyroscopeSensorChannel::GyroscopeSensorChannel(const QString& id) :
         return;
     }
 
-    gyroscopeReader_ = new BufferReader<TimedXyzData>(1);
+    gyroscopeReader_ = new BufferReader<TimedXyzData>(64);
 
-    outputBuffer_ = new RingBuffer<TimedXyzData>(1);
+    outputBuffer_ = new RingBuffer<TimedXyzData>(64);
 
     // Create buffers for filter chain
     filterBin_ = new Bin;
@@ -33,18 +33,21 @@ MagnetometerScaleFilter::MagnetometerScaleFilter() :
     factor = SensorFrameworkConfig::configuration()->value("magnetometer/scale_coefficient", QVariant(1)).toInt();
 }
 
-void MagnetometerScaleFilter::filter(unsigned, const CalibratedMagneticFieldData* data)
+void MagnetometerScaleFilter::filter(unsigned n, const CalibratedMagneticFieldData* data)
 {
-    CalibratedMagneticFieldData transformed;
-
-    transformed.timestamp_ = data->timestamp_;
-    transformed.level_ = data->level_;
-    transformed.x_ = data->x_ * factor;
-    transformed.y_ = data->y_ * factor;
-    transformed.z_ = data->z_ * factor;
-    transformed.rx_ = data->rx_ * factor;
-    transformed.ry_ = data->ry_ * factor;
-    transformed.rz_ = data->rz_ * factor;
-
-    source_.propagate(1, &transformed);
+    const int scale = factor;
+    CalibratedMagneticFieldData* transformed = output_.reserve(n);
+
+    for (unsigned i = 0; i < n; ++i) {
+        transformed[i].timestamp_ = data[i].timestamp_;
+        transformed[i].level_ = data[i].level_;
+        transformed[i].x_ = data[i].x_ * scale;
+        transformed[i].y_ = data[i].y_ * scale;
+        transformed[i].z_ = data[i].z_ * scale;
+        transformed[i].rx_ = data[i].rx_ * scale;
+        transformed[i].ry_ = data[i].ry_ * scale;
+        transformed[i].rz_ = data[i].rz_ * scale;
+    }
+
+    source_.propagate(n, transformed);
 }
@@ -47,7 +47,7 @@ MagnetometerSensorChannel::MagnetometerSensorChannel(const QString& id) :
     }
     setValid(magChain_->isValid());
 
-    magnetometerReader_ = new BufferReader<CalibratedMagneticFieldData>(1);
+    magnetometerReader_ = new BufferReader<CalibratedMagneticFieldData>(64);
 
     scaleCoefficient_ = SensorFrameworkConfig::configuration()->value("magnetometer/scale_coefficient",
                                                                       QVariant(300)).toInt();
@@ -59,7 +59,7 @@ MagnetometerSensorChannel::MagnetometerSensorChannel(const QString& id) :
         }
     }
 
-    outputBuffer_ = new RingBuffer<CalibratedMagneticFieldData>(1);
+    outputBuffer_ = new RingBuffer<CalibratedMagneticFieldData>(64);
 
     // Create buffers for filter chain
     filterBin_ = new Bin;
@@ -174,12 +174,6 @@ bool MagnetometerSensorChannel::setDataRange(const DataRange& range, int session
     return true;
 }
 
-void MagnetometerSensorChannel::removeSession(int sessionId)
-{
-    downsampleBuffer_.remove(sessionId);
-    AbstractSensorChannel::removeSession(sessionId);
-}
-
 bool MagnetometerSensorChannel::downsamplingSupported() const
 {
     return true;
@@ -69,8 +69,6 @@ public:
         return MagneticField(prevMeasurement_);
     }
 
-    virtual void removeSession(int sessionId);
-
     virtual bool downsamplingSupported() const;
 
 public Q_SLOTS:
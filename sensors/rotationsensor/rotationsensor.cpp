@@ -189,12 +189,6 @@ bool RotationSensorChannel::setInterval(int sessionId, unsigned int interval_us)
     return success;
 }
 
-void RotationSensorChannel::removeSession(int sessionId)
-{
-    downsampleBuffer_.remove(sessionId);
-    AbstractSensorChannel::removeSession(sessionId);
-}
-
 bool RotationSensorChannel::downsamplingSupported() const
 {
     return true;
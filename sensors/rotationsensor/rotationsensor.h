@@ -75,8 +75,6 @@ public:
     virtual unsigned int interval() const;
     virtual bool setInterval(int sessionId, unsigned int interval_us);
 
-    virtual void removeSession(int sessionId);
-
     virtual bool downsamplingSupported() const;
 
 public Q_SLOTS:
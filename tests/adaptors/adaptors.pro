@@ -17,7 +17,8 @@ HEADERS += adaptortest.h \
     ../../adaptors/kbslideradaptor/kbslideradaptor.h \
     ../../adaptors/proximityadaptor/proximityadaptor.h \
     ../../adaptors/gyroscopeadaptor/gyroscopeadaptor.h \
-    ../../adaptors/lidsensoradaptor-evdev/lidsensoradaptor-evdev.h
+    ../../adaptors/lidsensoradaptor-evdev/lidsensoradaptor-evdev.h \
+    ../../adaptors/iioadaptor/iioadaptor.h
 
 SOURCES += adaptortest.cpp \
     ../../datatypes/utils.cpp \
@@ -29,7 +30,8 @@ SOURCES += adaptortest.cpp \
     ../../adaptors/kbslideradaptor/kbslideradaptor.cpp \
     ../../adaptors/proximityadaptor/proximityadaptor.cpp \
     ../../adaptors/gyroscopeadaptor/gyroscopeadaptor.cpp \
-    ../../adaptors/lidsensoradaptor-evdev/lidsensoradaptor-evdev.cpp
+    ../../adaptors/lidsensoradaptor-evdev/lidsensoradaptor-evdev.cpp \
+    ../../adaptors/iioadaptor/iioadaptor.cpp
 
 
 INCLUDEPATH += ../.. \
@@ -46,8 +48,11 @@ INCLUDEPATH += ../.. \
     ../../adaptors/kbslideradaptor \
     ../../adaptors/proximityadaptor \
     ../../adaptors/gyroscopeadaptor \
-    ../../adaptors/lidsensoradaptor-evdev
+    ../../adaptors/lidsensoradaptor-evdev \
+    ../../adaptors/iioadaptor
 
+CONFIG += link_pkgconfig
+PKGCONFIG += libudev
 
 QMAKE_LIBDIR_FLAGS += -L../../builddir/core -L../../core/ -lrt
 
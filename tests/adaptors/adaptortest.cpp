@@ -40,6 +40,7 @@
 #include "proximityadaptor.h"
 #include "gyroscopeadaptor.h"
 #include "lidsensoradaptor-evdev.h"
+#include "iioadaptor.h"
 
 #include "config.h"
 
@@ -170,4 +171,83 @@ void AdaptorTest::testLidSensorAdaptor()
     adaptor->stopAdaptor();
 }
 
+/**
+ * Scan element formats are parsed, elements placed in records and values
+ * decoded as the IIO buffer layout defines them.
+ */
+void AdaptorTest::testIioScanRecord()
+{
+    typedef IioAdaptor::iio_scan_channel Channel;
+
+    Channel x, y, timestamp;
+    QVERIFY(IioAdaptor::parseScanType("le:s12/16>>4", x));
+    QCOMPARE(x.storageBytes, 2);
+    QCOMPARE(x.realBits, 12);
+    QCOMPARE(x.shift, 4);
+    QVERIFY(x.isSigned);
+    QVERIFY(!x.bigEndian);
+
+    QVERIFY(IioAdaptor::parseScanType("be:u24/32>>0", y));
+    QCOMPARE(y.storageBytes, 4);
+    QCOMPARE(y.realBits, 24);
+    QCOMPARE(y.shift, 0);
+    QVERIFY(!y.isSigned);
+    QVERIFY(y.bigEndian);
+
+    QVERIFY(IioAdaptor::parseScanType("le:s64/64>>0", timestamp));
+    QCOMPARE(timestamp.storageBytes, 8);
+
+    Channel invalid;
+    QVERIFY(!IioAdaptor::parseScanType("le:s12/12>>0", invalid));
+    QVERIFY(!IioAdaptor::parseScanType("le:s17/16>>0", invalid));
+    QVERIFY(!IioAdaptor::parseScanType("le:s16/16>>16", invalid));
+    QVERIFY(!IioAdaptor::parseScanType("xe:s16/16>>0", invalid));
+    QVERIFY(!IioAdaptor::parseScanType("le:16/16", invalid));
+
+    // Elements in index order, aligned to their storage size
+    x.index = 0;
+    y.index = 1;
+    timestamp.index = 2;
+    QVector<Channel> channels;
+    channels << timestamp << y << x;
+    QCOMPARE(IioAdaptor::layoutScanRecord(channels), 16);
+    QCOMPARE(channels.at(0).index, 0);
+    QCOMPARE(channels.at(0).offset, 0);
+    QCOMPARE(channels.at(1).offset, 4);
+    QCOMPARE(channels.at(2).offset, 8);
+
+    // Record padded to the size of the largest element
+    Channel u8;
+    QVERIFY(IioAdaptor::parseScanType("le:u8/8>>0", u8));
+    u8.index = 3;
+    channels.clear();
+    channels << x << y << u8;
+    QCOMPARE(IioAdaptor::layoutScanRecord(channels), 12);
+    QCOMPARE(channels.at(2).offset, 8);
+
+    channels.clear();
+    channels << x << timestamp;
+    IioAdaptor::layoutScanRecord(channels);
+    x = channels.at(0);
+    timestamp = channels.at(1);
+
+    const char record[16] = {
+        '\xb0', '\xff', 0, 0, 0, 0, 0, 0,
+        '\x15', '\x81', '\xe9', '\x7d', '\xf4', '\x10', '\x22', '\x11'
+    };
+    QCOMPARE(IioAdaptor::decodeScanValue(record, x), Q_INT64_C(-5));
+    x.isSigned = false;
+    QCOMPARE(IioAdaptor::decodeScanValue(record, x), Q_INT64_C(0xffb));
+    QCOMPARE(IioAdaptor::decodeScanValue(record, timestamp), Q_INT64_C(0x112210f47de98115));
+
+    const char bigEndian[4] = { '\x7f', '\x12', '\x34', '\x56' };
+    QCOMPARE(IioAdaptor::decodeScanValue(bigEndian, y), Q_INT64_C(0x123456));
+    y.isSigned = true;
+    y.realBits = 32;
+    QCOMPARE(IioAdaptor::decodeScanValue(bigEndian, y), Q_INT64_C(0x7f123456));
+    y.shift = 8;
+    y.realBits = 16;
+    QCOMPARE(IioAdaptor::decodeScanValue(bigEndian, y), Q_INT64_C(0x1234));
+}
+
 QTEST_MAIN(AdaptorTest)
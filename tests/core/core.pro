@@ -0,0 +1,21 @@
+QT += dbus network
+
+include(../common-install.pri)
+
+TEMPLATE = app
+TARGET = sensorcore-test
+
+CONFIG += testcase
+
+HEADERS += coretests.h
+SOURCES += coretests.cpp
+
+INCLUDEPATH += ../../include \
+    ../../core \
+    ../../datatypes \
+    ../..
+
+QMAKE_LIBDIR_FLAGS += -L../../builddir/datatypes -L../../datatypes/
+QMAKE_LIBDIR_FLAGS += -L../../builddir/core -L../../core/
+
+include(../../common.pri)
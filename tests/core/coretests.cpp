@@ -0,0 +1,847 @@
+/**
+   @file coretests.cpp
+   @brief Unit tests for sensord core building blocks
+
+   <p>
+   Copyright (c) 2026 Jolla Mobile Ltd
+
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include <QtDebug>
+#include <QTest>
+#include <QByteArray>
+#include <QLocalSocket>
+#include <QSet>
+#include <QSignalSpy>
+#include <QThread>
+#include <QVector>
+
+#include "coretests.h"
+#include "config.h"
+#include "latencyhistogram.h"
+#include "nodebase.h"
+#include "ringbuffer.h"
+#include "sessionring.h"
+#include "sharedsessionring.h"
+#include "slidingwindow.h"
+#include "spscring.h"
+#include "sockethandler.h"
+#include "source.h"
+#include "sensorwire.h"
+#include "datatypes/genericdata.h"
+#include "datatypes/timedunsigned.h"
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * Reader collecting everything written into the buffer it is joined to.
+ */
+template <class TYPE>
+class CollectingReader : public RingBufferReader<TYPE>
+{
+public:
+    CollectingReader() : wakeups(0) {}
+
+    void pushNewData()
+    {
+        TYPE chunk[16];
+        unsigned n;
+        while ((n = RingBufferReader<TYPE>::read(16, chunk))) {
+            for (unsigned i = 0; i < n; ++i)
+                received.append(chunk[i]);
+        }
+        ++wakeups;
+    }
+
+    QVector<TYPE> received; /**< everything read so far */
+    int wakeups;            /**< number of buffer wakeups */
+};
+
+void CoreTest::initTestCase()
+{
+    // Built-in defaults only, the tests must not depend on device config
+    SensorFrameworkConfig::loadConfig(QString(), QString());
+}
+
+void CoreTest::cleanupTestCase()
+{
+    SensorFrameworkConfig::close();
+}
+
+/**
+ * Feed samples into a small ring buffer one at a time and as a batch which
+ * wraps around the end of the buffer storage.
+ */
+void CoreTest::testRingBufferBatch()
+{
+    TimedXyzData inputData[] = {
+        TimedXyzData(0, 1, 2, 3),
+        TimedXyzData(1, 4, 5, 6),
+        TimedXyzData(2, 7, 8, 9),
+        TimedXyzData(3,10,11,12),
+        TimedXyzData(4,13,14,15),
+        TimedXyzData(5,16,17,18)
+    };
+    const int numInputs = sizeof(inputData) / sizeof(TimedXyzData);
+
+    // Capacity is rounded up to a power of two
+    RingBuffer<TimedXyzData> buffer(3);
+    QCOMPARE(buffer.size(), 4u);
+
+    Source<TimedXyzData> source;
+    QVERIFY(source.join(buffer.sink("sink")));
+    CollectingReader<TimedXyzData> reader;
+    QVERIFY(buffer.join(&reader));
+
+    // One wakeup per write, however many samples it carries
+    for (int i = 0; i < 3; ++i)
+        source.propagate(1, &inputData[i]);
+    source.propagate(numInputs - 3, &inputData[3]);
+    QCOMPARE(reader.wakeups, 4);
+
+    QCOMPARE(reader.received.size(), numInputs);
+    for (int i = 0; i < numInputs; ++i) {
+        QCOMPARE(reader.received.at(i).timestamp_, inputData[i].timestamp_);
+        QCOMPARE(reader.received.at(i).x_, inputData[i].x_);
+        QCOMPARE(reader.received.at(i).z_, inputData[i].z_);
+    }
+
+    // Reader falling behind by more than the capacity skips the oldest
+    reader.received.clear();
+    source.propagate(numInputs, inputData);
+    QCOMPARE(reader.received.size(), 4);
+    QCOMPARE(reader.received.first().timestamp_, inputData[2].timestamp_);
+
+    buffer.unjoin(&reader);
+    source.unjoin(buffer.sink("sink"));
+}
+
+void CoreTest::testSlidingWindow()
+{
+    SlidingWindow<2> window(3);
+    QVERIFY(window.isEmpty());
+
+    const double a[2] = { 1, 10 };
+    const double b[2] = { 2, 20 };
+    const double c[2] = { 3, 30 };
+    const double d[2] = { 6, 60 };
+
+    window.push(100, a);
+    window.push(200, b);
+    window.push(300, c);
+    QVERIFY(window.isFull());
+    QCOMPARE(window.mean(0), 2.0);
+    QCOMPARE(window.mean(1), 20.0);
+
+    // Oldest sample is evicted when full
+    window.push(400, d);
+    QCOMPARE(window.count(), 3u);
+    QCOMPARE(window.oldestTimestamp(), (quint64)200);
+    QCOMPARE(window.sum(0), 11.0);
+    QCOMPARE(window.variance(0), 26.0 / 9.0);
+
+    // Expiry honours the minimum number of samples to keep
+    window.expireBefore(350);
+    QCOMPARE(window.count(), 1u);
+    window.expireBefore(1000, 1);
+    QCOMPARE(window.count(), 1u);
+    QCOMPARE(window.mean(1), 60.0);
+
+    // Shrinking keeps the newest samples
+    window.push(500, a);
+    window.push(600, b);
+    window.setCapacity(2);
+    QCOMPARE(window.count(), 2u);
+    QCOMPARE(window.oldestTimestamp(), (quint64)500);
+    QCOMPARE(window.mean(0), 1.5);
+
+    window.clear();
+    QVERIFY(window.isEmpty());
+    QCOMPARE(window.sum(0), 0.0);
+}
+
+class IntervalTestNode : public NodeBase
+{
+public:
+    IntervalTestNode() : NodeBase("intervaltestnode"), m_interval_us(0)
+    {
+        introduceAvailableInterval(DataRange(1000, 1000000, 0));
+    }
+
+    QSet<int> decimated; /**< sessions reported as decimated */
+
+protected:
+    unsigned int interval() const { return m_interval_us; }
+    bool setInterval(int, unsigned int interval_us) { m_interval_us = interval_us; return true; }
+    bool decimatesInterval(int sessionId) const { return decimated.contains(sessionId); }
+    RingBufferBase* findBuffer(const QString&) const { return 0; }
+
+private:
+    unsigned int m_interval_us;
+};
+
+void CoreTest::testIntervalPlanner()
+{
+    IntervalTestNode node;
+    node.decimated << 1 << 2;
+
+    // Multiples of the fastest request keep it as is
+    node.setIntervalRequest(1, 20000);
+    node.setIntervalRequest(2, 40000);
+    QCOMPARE(node.getInterval(), 20000u);
+    QCOMPARE(NodeBase::decimationFactor(40000, node.getInterval()), 2u);
+
+    // 15 ms and 20 ms are both served exactly from 5 ms
+    node.setIntervalRequest(2, 15000);
+    QCOMPARE(node.getInterval(), 5000u);
+    QCOMPARE(NodeBase::decimationFactor(15000, node.getInterval()), 3u);
+    QCOMPARE(NodeBase::decimationFactor(20000, node.getInterval()), 4u);
+
+    // Close enough to a multiple within the default 10% tolerance
+    node.setIntervalRequest(1, 21000);
+    QCOMPARE(node.getInterval(), 7500u);
+    QCOMPARE(NodeBase::decimationFactor(21000, node.getInterval()), 3u);
+    QCOMPARE(NodeBase::decimationFactor(15000, node.getInterval()), 2u);
+
+    // Back to the fastest request when the other session goes away
+    node.removeIntervalRequest(1);
+    QCOMPARE(node.getInterval(), 15000u);
+
+    QCOMPARE(NodeBase::decimationFactor(0, 5000), 1u);
+    QCOMPARE(NodeBase::decimationFactor(5000, 0), 1u);
+    QCOMPARE(NodeBase::decimationFactor(4000, 5000), 1u);
+}
+
+/**
+ * Sessions which get every sample must not make the sensor run faster
+ * than the fastest request.
+ */
+void CoreTest::testIntervalPlannerNoDownsampling()
+{
+    IntervalTestNode node;
+    node.decimated << 1;
+
+    node.setIntervalRequest(1, 20000);
+    node.setIntervalRequest(2, 15000);
+    QCOMPARE(node.getInterval(), 15000u);
+
+    // Planning resumes once the other session is gone
+    node.removeIntervalRequest(2);
+    node.setIntervalRequest(3, 15000);
+    QCOMPARE(node.getInterval(), 15000u);
+    node.decimated << 3;
+    node.setIntervalRequest(3, 15000);
+    QCOMPARE(node.getInterval(), 5000u);
+
+    // Turning decimation off for a session is honoured on next request
+    node.decimated.remove(3);
+    node.setIntervalRequest(3, 15000);
+    QCOMPARE(node.getInterval(), 15000u);
+}
+
+/**
+ * Node doing buffering itself, like adaptors with a hardware FIFO.
+ */
+class BufferTestNode : public NodeBase
+{
+public:
+    BufferTestNode() : NodeBase("buffertestnode"), m_bufferSize(0), m_bufferInterval_us(0) {}
+
+    using NodeBase::setBufferSize;
+    using NodeBase::setBufferInterval;
+
+    IntegerRangeList getAvailableBufferSizes(bool& hwSupported) const
+    {
+        IntegerRangeList list;
+        list.push_back(IntegerRange(1, 100));
+        hwSupported = true;
+        return list;
+    }
+
+    IntegerRangeList getAvailableBufferIntervals(bool& hwSupported) const
+    {
+        IntegerRangeList list;
+        list.push_back(IntegerRange(0, 60000000));
+        hwSupported = true;
+        return list;
+    }
+
+    unsigned int bufferSize() const { return m_bufferSize; }
+    unsigned int bufferInterval() const { return m_bufferInterval_us; }
+
+protected:
+    bool setBufferSize(unsigned int value) { m_bufferSize = value; return true; }
+    bool setBufferInterval(unsigned int interval_us) { m_bufferInterval_us = interval_us; return true; }
+    RingBufferBase* findBuffer(const QString&) const { return 0; }
+
+private:
+    unsigned int m_bufferSize;
+    unsigned int m_bufferInterval_us;
+};
+
+void CoreTest::testBufferingRequests()
+{
+    BufferTestNode node;
+
+    // Smallest requests win, whichever session made them
+    node.setBufferSessionActive(1, true);
+    node.setBufferInterval(1, 60000000);
+    node.setBufferSize(1, 50);
+    node.setBufferSessionActive(2, true);
+    node.setBufferInterval(2, 1000000);
+    QCOMPARE(node.bufferInterval(), 1000000u);
+    QCOMPARE(node.bufferSize(), 50u);
+
+    // Session without buffering needs every sample right away
+    node.setBufferSessionActive(3, true);
+    QCOMPARE(node.bufferInterval(), 0u);
+    QCOMPARE(node.bufferSize(), 0u);
+    node.removeSession(3);
+    QCOMPARE(node.bufferInterval(), 1000000u);
+    QCOMPARE(node.bufferSize(), 50u);
+
+    // Buffer size of one sample is no buffering
+    node.setBufferSize(2, 1);
+    QCOMPARE(node.bufferSize(), 50u);
+    node.clearBufferInterval(2);
+    QCOMPARE(node.bufferInterval(), 0u);
+    QCOMPARE(node.bufferSize(), 0u);
+
+    node.removeSession(2);
+    QCOMPARE(node.bufferInterval(), 60000000u);
+    QCOMPARE(node.bufferSize(), 50u);
+}
+
+void CoreTest::testLatencyHistogram()
+{
+    LatencyHistogram histogram(1);
+    QCOMPARE(histogram.percentile(50), (quint64)0);
+
+    for (quint64 latency = 1; latency <= 1000; ++latency)
+        histogram.record(latency);
+    QCOMPARE(histogram.count(), (quint64)1000);
+    QCOMPARE(histogram.max(), (quint64)1000);
+
+    // Percentiles are bucket upper bounds, within 12.5% of exact value
+    quint64 p50 = histogram.percentile(50);
+    QVERIFY(p50 >= 500 && p50 <= 500 * 9 / 8);
+    quint64 p99 = histogram.percentile(99);
+    QVERIFY(p99 >= 990 && p99 <= 1000);
+    QCOMPARE(histogram.percentile(100), (quint64)1000);
+
+    // Small values are exact and huge ones are reported by maximum
+    LatencyHistogram exact(1);
+    exact.record(7);
+    QCOMPARE(exact.percentile(50), (quint64)7);
+    exact.record(Q_UINT64_C(1) << 40);
+    QCOMPARE(exact.percentile(100), Q_UINT64_C(1) << 40);
+
+    // Timestamps from another clock are not recorded
+    exact.recordSince(2000, 1000);
+    QCOMPARE(exact.count(), (quint64)2);
+
+    LatencyHistogram sampled(4);
+    int measured = 0;
+    for (int i = 0; i < 40; ++i)
+        measured += sampled.sample();
+    QCOMPARE(measured, 10);
+    sampled.setSampleInterval(0);
+    QVERIFY(!sampled.sample());
+
+    // Sample timestamps may come from any of the clocks adaptors use
+    LatencyHistogram clocks(1);
+    clocks.recordSinceSampleTime(LatencyHistogram::clockTime(CLOCK_MONOTONIC) - 1000);
+    clocks.recordSinceSampleTime(LatencyHistogram::clockTime(CLOCK_REALTIME) - 2000);
+    QCOMPARE(clocks.count(), (quint64)2);
+    QVERIFY(clocks.percentile(50) >= 1000 && clocks.percentile(50) < 1000 + 1000000);
+    QVERIFY(clocks.max() >= 2000 && clocks.max() < 2000 + 1000000);
+
+    // Stamps ahead of the monotonic clock are compared against boot time
+    quint64 monotonic = LatencyHistogram::clockTime(CLOCK_MONOTONIC);
+    quint64 boottime = LatencyHistogram::clockTime(CLOCK_BOOTTIME);
+    if (boottime > monotonic + 2000) {
+        LatencyHistogram suspended(1);
+        suspended.recordSinceSampleTime(boottime - 1000);
+        QCOMPARE(suspended.count(), (quint64)1);
+        QVERIFY(suspended.max() < boottime - monotonic);
+    }
+
+    // Stamps from the future are ignored
+    clocks.recordSinceSampleTime(LatencyHistogram::clockTime(CLOCK_REALTIME) + 60000000);
+    QCOMPARE(clocks.count(), (quint64)2);
+}
+
+/**
+ * Session ring producer and consumer sharing one mapping.
+ */
+void CoreTest::testSessionRing()
+{
+    const uint32_t slots = 4;
+    QByteArray mapping(sessionRingMappingSize(slots), 0);
+    SessionRingHeader* header = reinterpret_cast<SessionRingHeader*>(mapping.data());
+
+    SessionRingWriter writer;
+    writer.initialize(mapping.data(), slots);
+    SessionRingReader reader;
+    QVERIFY(reader.attach(mapping.data(), mapping.size()));
+
+    // Fresh ring asks for a wakeup on the first sample only
+    quint64 values[8];
+    quint64 value = 1;
+    QVERIFY(writer.write(&value, sizeof(value)));
+    value = 2;
+    QVERIFY(!writer.write(&value, sizeof(value)));
+    QCOMPARE(reader.read(values, sizeof(quint64), 8), 2u);
+    QCOMPARE(values[0], (quint64)1);
+    QCOMPARE(values[1], (quint64)2);
+    QCOMPARE(reader.lost(), (quint64)0);
+
+    // Requesting a wakeup reports whether data is already waiting
+    QVERIFY(!reader.requestWakeup());
+    value = 3;
+    QVERIFY(writer.write(&value, sizeof(value)));
+    QVERIFY(reader.requestWakeup());
+    QCOMPARE(reader.read(values, sizeof(quint64), 8), 1u);
+
+    // Samples overwritten before they are read are counted as lost
+    for (value = 10; value < 16; ++value)
+        writer.write(&value, sizeof(value));
+    QCOMPARE(reader.read(values, sizeof(quint64), 8), slots);
+    QCOMPARE(values[0], (quint64)12);
+    QCOMPARE(values[slots - 1], (quint64)15);
+    QCOMPARE(reader.lost(), (quint64)2);
+
+    // Samples of unexpected size are skipped
+    quint32 small = 7;
+    writer.write(&small, sizeof(small));
+    QCOMPARE(reader.read(values, sizeof(quint64), 8), 0u);
+    QCOMPARE(reader.lost(), (quint64)3);
+
+    // Clients can write the header, the writer must not trust it
+    header->slotCount = 1u << 30;
+    header->slotPayload = 1u << 20;
+    header->writeIndex = Q_UINT64_C(1) << 40;
+    for (value = 20; value < 22; ++value)
+        writer.write(&value, sizeof(value));
+    QCOMPARE(header->writeIndex, (quint64)12);
+    QCOMPARE(reader.read(values, sizeof(quint64), 8), 2u);
+    QCOMPARE(values[1], (quint64)21);
+
+    // Corrupted or truncated rings are rejected
+    writer.initialize(mapping.data(), slots);
+    SessionRingReader rejecting;
+    QVERIFY(!rejecting.attach(mapping.data(), sizeof(SessionRingHeader) - 1));
+    QVERIFY(!rejecting.attach(mapping.data(), mapping.size() - 1));
+    header->slotCount = 3;
+    QVERIFY(!rejecting.attach(mapping.data(), mapping.size()));
+    header->slotCount = slots * 2;
+    QVERIFY(!rejecting.attach(mapping.data(), mapping.size()));
+    header->slotCount = slots;
+    header->slotPayload = SESSION_RING_SLOT_PAYLOAD * 2;
+    QVERIFY(!rejecting.attach(mapping.data(), mapping.size()));
+    header->slotPayload = SESSION_RING_SLOT_PAYLOAD;
+    header->version = SESSION_RING_VERSION + 1;
+    QVERIFY(!rejecting.attach(mapping.data(), mapping.size()));
+    header->version = SESSION_RING_VERSION;
+    header->magic = 0;
+    QVERIFY(!rejecting.attach(mapping.data(), mapping.size()));
+    header->magic = SESSION_RING_MAGIC;
+    QVERIFY(rejecting.attach(mapping.data(), mapping.size()));
+}
+
+/**
+ * Client mapping of the memfd backed ring sees what sensord publishes.
+ */
+void CoreTest::testSharedSessionRing()
+{
+    SharedSessionRing ring(8);
+    QVERIFY(ring.isValid());
+
+    size_t size = sessionRingMappingSize(8);
+    void* mapping = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, ring.fd(), 0);
+    QVERIFY(mapping != MAP_FAILED);
+    SessionRingReader reader;
+    QVERIFY(reader.attach(mapping, size));
+
+    // Clients can not resize the memory
+    QVERIFY(ftruncate(ring.fd(), size * 2) == -1);
+
+    TimedXyzData sample(1000, 1, 2, 3);
+    bool wakeup = false;
+    QVERIFY(ring.write(&sample, sizeof(sample), wakeup));
+    QVERIFY(wakeup);
+
+    char oversized[SESSION_RING_SLOT_PAYLOAD + 1];
+    QVERIFY(!ring.write(oversized, sizeof(oversized), wakeup));
+
+    TimedXyzData received;
+    QCOMPARE(reader.read(&received, sizeof(received), 1), 1u);
+    QCOMPARE(received.timestamp_, sample.timestamp_);
+    QCOMPARE(received.z_, sample.z_);
+
+    munmap(mapping, size);
+}
+
+/**
+ * Producer pushing consecutive numbers from its own thread.
+ */
+class SpscProducer : public QThread
+{
+public:
+    SpscProducer(SpscRing<unsigned>& ring, unsigned count) : m_ring(ring), m_count(count) {}
+
+protected:
+    void run()
+    {
+        unsigned next = 0;
+        while (next < m_count) {
+            bool wakeup;
+            unsigned value[8];
+            unsigned n = qMin(8u, m_count - next);
+            for (unsigned i = 0; i < n; ++i)
+                value[i] = next + i;
+            next += m_ring.push(value, n, wakeup);
+        }
+    }
+
+private:
+    SpscRing<unsigned>& m_ring;
+    unsigned m_count;
+};
+
+void CoreTest::testSpscRing()
+{
+    SpscRing<unsigned> ring(5);
+    QCOMPARE(ring.size(), 8u);
+
+    // Only the push to an empty ring needs to wake the consumer
+    unsigned values[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    bool wakeup;
+    QCOMPARE(ring.push(values, 3, wakeup), 3u);
+    QVERIFY(wakeup);
+    QCOMPARE(ring.push(values + 3, 3, wakeup), 3u);
+    QVERIFY(!wakeup);
+
+    // Full ring takes what fits
+    QCOMPARE(ring.push(values + 6, 4, wakeup), 2u);
+    QCOMPARE(ring.push(values, 1, wakeup), 0u);
+
+    unsigned available;
+    const unsigned* data = ring.peek(available);
+    QCOMPARE(available, 8u);
+    QCOMPARE(data[0], 0u);
+    QCOMPARE(data[7], 7u);
+    ring.release(6);
+
+    // Spans end at the end of the storage
+    QCOMPARE(ring.push(values, 5, wakeup), 5u);
+    QVERIFY(!wakeup);
+    data = ring.peek(available);
+    QCOMPARE(available, 2u);
+    QCOMPARE(data[1], 7u);
+    ring.release(available);
+    data = ring.peek(available);
+    QCOMPARE(available, 5u);
+    QCOMPARE(data[4], 4u);
+
+    unsigned granted;
+    ring.reserve(8, granted);
+    QCOMPARE(granted, 3u);
+
+    // Drained ring wakes the consumer again
+    ring.release(available);
+    ring.peek(available);
+    QCOMPARE(available, 0u);
+    QCOMPARE(ring.push(values, 1, wakeup), 1u);
+    QVERIFY(wakeup);
+    ring.release(1);
+
+    // Everything arrives in order across threads
+    const unsigned count = 100000;
+    SpscProducer producer(ring, count);
+    producer.start();
+    unsigned expected = 0;
+    bool ordered = true;
+    while (expected < count) {
+        data = ring.peek(available);
+        for (unsigned i = 0; i < available; ++i)
+            ordered &= (data[i] == expected + i);
+        expected += available;
+        ring.release(available);
+        if (!available)
+            QThread::yieldCurrentThread();
+    }
+    QVERIFY(producer.wait(10000));
+    QVERIFY(ordered);
+}
+
+/**
+ * Session writing into a socket whose buffer has been filled up, so that
+ * frames stay in the session queue until the client starts reading.
+ */
+class CloggedSession
+{
+public:
+    CloggedSession() : session(0), client(-1), clogged(0)
+    {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == -1)
+            return;
+        client = fds[1];
+
+        int size = 4096;
+        setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+        char junk[1024];
+        memset(junk, 0, sizeof(junk));
+        for (int chunk = sizeof(junk); chunk; chunk /= 2) {
+            ssize_t sent;
+            while ((sent = ::send(fds[0], junk, chunk, MSG_DONTWAIT)) > 0)
+                clogged += sent;
+        }
+
+        QLocalSocket* socket = new QLocalSocket();
+        socket->setSocketDescriptor(fds[0]);
+        session = new SessionData(socket);
+    }
+
+    ~CloggedSession()
+    {
+        delete session;
+        if (client != -1)
+            ::close(client);
+    }
+
+    bool write(unsigned value)
+    {
+        TimedUnsigned sample(1000 + value, value);
+        bool ret = session->write(&sample, sizeof(sample));
+        session->flush();
+        return ret;
+    }
+
+    /**
+     * Read the junk and then everything the session sends.
+     *
+     * @return values of the received samples.
+     */
+    QVector<unsigned> drain()
+    {
+        QVector<unsigned> values;
+        QByteArray received;
+        char buf[4096];
+        qint64 junk = clogged;
+        while (junk > 0) {
+            ssize_t bytes = ::recv(client, buf, qMin<qint64>(junk, sizeof(buf)), 0);
+            if (bytes <= 0)
+                return values;
+            junk -= bytes;
+        }
+
+        forever {
+            session->flush();
+            ssize_t bytes = ::recv(client, buf, sizeof(buf), MSG_DONTWAIT);
+            if (bytes > 0)
+                received.append(buf, bytes);
+            else if (!session->hasPendingOutput())
+                break;
+        }
+
+        TimedUnsigned samples[64];
+        unsigned int frameRemaining = 0;
+        int offset = 0;
+        forever {
+            int consumed;
+            int count = sensorWireDecodeSamples(received.constData() + offset, received.size() - offset,
+                                                samples, sizeof(TimedUnsigned), 64, frameRemaining, consumed);
+            if (count <= 0)
+                break;
+            for (int i = 0; i < count; ++i)
+                values.append(samples[i].value_);
+            offset += consumed;
+        }
+        return values;
+    }
+
+    SessionData* session; /**< session under test */
+    int client;           /**< client end of the socket */
+    qint64 clogged;       /**< junk bytes filling the socket */
+};
+
+static QVector<unsigned> range(unsigned from, unsigned to)
+{
+    QVector<unsigned> values;
+    for (unsigned value = from; value < to; ++value)
+        values.append(value);
+    return values;
+}
+
+/**
+ * Frames are kept in order while the client is not reading, and sent
+ * intact once it does.
+ */
+void CoreTest::testSessionQueue()
+{
+    CloggedSession clogged;
+    QVERIFY(clogged.session);
+    QVERIFY(clogged.clogged > 0);
+
+    for (unsigned value = 0; value < 100; ++value)
+        QVERIFY(clogged.write(value));
+    QVERIFY(clogged.session->hasPendingOutput());
+    QVariantMap stats = clogged.session->statistics();
+    QCOMPARE(stats.value("queuedFrames").toInt(), 100);
+    QCOMPARE(stats.value("droppedFrames").toUInt(), 0u);
+
+    QCOMPARE(clogged.drain(), range(0, 100));
+    QCOMPARE(clogged.session->statistics().value("queuedFrames").toInt(), 0);
+}
+
+void CoreTest::testSessionDropPolicies()
+{
+    const int frame = sizeof(unsigned int) + sizeof(TimedUnsigned);
+
+    // Oldest frames make room for new ones
+    {
+        CloggedSession clogged;
+        clogged.session->setQueuePolicy(SessionData::DropOldest, 5 * frame, 5000);
+        for (unsigned value = 0; value < 8; ++value)
+            QVERIFY(clogged.write(value));
+        QCOMPARE(clogged.session->statistics().value("droppedFrames").toUInt(), 3u);
+        QCOMPARE(clogged.drain(), range(3, 8));
+    }
+
+    // New frames are refused when the queue is full
+    {
+        CloggedSession clogged;
+        clogged.session->setQueuePolicy(SessionData::DropNewest, 5 * frame, 5000);
+        for (unsigned value = 0; value < 8; ++value)
+            QCOMPARE(clogged.write(value), value < 5);
+        QCOMPARE(clogged.session->statistics().value("droppedFrames").toUInt(), 3u);
+        QCOMPARE(clogged.drain(), range(0, 5));
+    }
+
+    // Every second frame is dropped once the queue is half full, and new
+    // frames are refused when it is full
+    {
+        CloggedSession clogged;
+        clogged.session->setQueuePolicy(SessionData::Decimate, 8 * frame, 5000);
+        for (unsigned value = 0; value < 12; ++value)
+            clogged.write(value);
+        QCOMPARE(clogged.session->statistics().value("droppedFrames").toUInt(), 4u);
+        QVector<unsigned> expected = range(0, 6);
+        expected << 7 << 9;
+        QCOMPARE(clogged.drain(), expected);
+    }
+
+    // Stalled client is reported once
+    {
+        CloggedSession clogged;
+        clogged.session->setQueuePolicy(SessionData::Disconnect, 2 * frame, 0);
+        QSignalSpy stalled(clogged.session, SIGNAL(stalled()));
+        for (unsigned value = 0; value < 4; ++value)
+            QCOMPARE(clogged.write(value), value < 2);
+        QCOMPARE(stalled.count(), 1);
+        QCOMPARE(clogged.drain(), range(0, 2));
+    }
+}
+
+static void appendWireFrame(QByteArray& stream, unsigned from, unsigned count)
+{
+    stream.append(reinterpret_cast<const char*>(&count), sizeof(unsigned int));
+    for (unsigned value = from; value < from + count; ++value) {
+        TimedUnsigned sample(1000 + value, value);
+        stream.append(reinterpret_cast<const char*>(&sample), sizeof(sample));
+    }
+}
+
+/**
+ * The decoder used by both the Qt and the C client library must cope with
+ * frames split at any byte, a small output array and corrupted streams.
+ */
+void CoreTest::testWireDecode()
+{
+    QByteArray stream;
+    appendWireFrame(stream, 0, 3);
+    appendWireFrame(stream, 3, 1);
+    appendWireFrame(stream, 4, 0);
+    appendWireFrame(stream, 4, 5);
+
+    TimedUnsigned samples[16];
+    unsigned int frameRemaining = 0;
+    int consumed = 0;
+
+    // Everything at once
+    QCOMPARE(sensorWireDecodeSamples(stream.constData(), stream.size(), samples, sizeof(TimedUnsigned),
+                                     16, frameRemaining, consumed), 9);
+    QCOMPARE(consumed, stream.size());
+    QCOMPARE(frameRemaining, 0u);
+    for (unsigned i = 0; i < 9; ++i) {
+        QCOMPARE(samples[i].value_, i);
+        QCOMPARE(samples[i].timestamp_, quint64(1000 + i));
+    }
+
+    // Received in chunks of every size, unconsumed bytes are kept by the caller
+    for (int chunk = 1; chunk <= stream.size(); ++chunk) {
+        QByteArray pending;
+        QVector<unsigned> values;
+        frameRemaining = 0;
+        for (int offset = 0; offset < stream.size(); offset += chunk) {
+            pending.append(stream.mid(offset, chunk));
+            int count = sensorWireDecodeSamples(pending.constData(), pending.size(), samples,
+                                                sizeof(TimedUnsigned), 16, frameRemaining, consumed);
+            QVERIFY(count >= 0);
+            for (int i = 0; i < count; ++i)
+                values.append(samples[i].value_);
+            pending.remove(0, consumed);
+        }
+        QCOMPARE(values, range(0, 9));
+        QVERIFY(pending.isEmpty());
+        QCOMPARE(frameRemaining, 0u);
+    }
+
+    // Output array smaller than a frame
+    frameRemaining = 0;
+    QCOMPARE(sensorWireDecodeSamples(stream.constData(), stream.size(), samples, sizeof(TimedUnsigned),
+                                     2, frameRemaining, consumed), 2);
+    QCOMPARE(frameRemaining, 1u);
+    QCOMPARE(consumed, int(sizeof(unsigned int) + 2 * sizeof(TimedUnsigned)));
+    int offset = consumed;
+    QCOMPARE(sensorWireDecodeSamples(stream.constData() + offset, stream.size() - offset, samples,
+                                     sizeof(TimedUnsigned), 16, frameRemaining, consumed), 7);
+    QCOMPARE(samples[0].value_, 2u);
+    QCOMPARE(consumed, stream.size() - offset);
+
+    // Largest allowed frame is accepted, anything beyond means corruption
+    QByteArray corrupted;
+    unsigned int frameSize = SENSOR_WIRE_MAX_FRAME_SAMPLES;
+    corrupted.append(reinterpret_cast<const char*>(&frameSize), sizeof(unsigned int));
+    frameRemaining = 0;
+    QCOMPARE(sensorWireDecodeSamples(corrupted.constData(), corrupted.size(), samples, sizeof(TimedUnsigned),
+                                     16, frameRemaining, consumed), 0);
+    QCOMPARE(frameRemaining, frameSize);
+    QCOMPARE(consumed, corrupted.size());
+
+    ++frameSize;
+    memcpy(corrupted.data(), &frameSize, sizeof(unsigned int));
+    frameRemaining = 0;
+    QCOMPARE(sensorWireDecodeSamples(corrupted.constData(), corrupted.size(), samples, sizeof(TimedUnsigned),
+                                     16, frameRemaining, consumed), -1);
+}
+
+QTEST_MAIN(CoreTest)
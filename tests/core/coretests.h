@@ -0,0 +1,52 @@
+/**
+   @file coretests.h
+   @brief Unit tests for sensord core building blocks
+
+   <p>
+   Copyright (c) 2026 Jolla Mobile Ltd
+
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef CORETESTS_H
+#define CORETESTS_H
+
+#include <QTest>
+
+class CoreTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void testRingBufferBatch();
+    void testSlidingWindow();
+    void testIntervalPlanner();
+    void testIntervalPlannerNoDownsampling();
+    void testBufferingRequests();
+    void testLatencyHistogram();
+    void testSessionRing();
+    void testSharedSessionRing();
+    void testSpscRing();
+    void testSessionQueue();
+    void testSessionDropPolicies();
+    void testWireDecode();
+
+    void cleanupTestCase();
+};
+
+#endif // CORETESTS_H
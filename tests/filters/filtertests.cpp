@@ -129,6 +129,78 @@ void FilterApiTest::testCoordinateAlignFilter()
     delete coordAlignFilter;
 }
 
+/**
+ * Same as testCoordinateAlignFilter, but all samples are pushed through the
+ * filter as a single batch.
+ */
+void FilterApiTest::testCoordinateAlignFilterBatch()
+{
+    double hconv[3][3] = {
+        { 0, 0,-1},
+        {-1, 0, 0},
+        { 0, 1, 0}
+    };
+
+    TimedXyzData inputData[] = {
+        TimedXyzData(0, 0, 0, 0),
+        TimedXyzData(1, 1, 0, 0),
+        TimedXyzData(2, 0, 2, 0),
+        TimedXyzData(3, 0, 0, 3),
+        TimedXyzData(4, 4, 5, 0),
+        TimedXyzData(5, 6, 0, 7),
+        TimedXyzData(6, 0, 8, 9),
+        TimedXyzData(7, 1, 1, 1)
+    };
+
+    TimedXyzData expectedResult[] = {
+        TimedXyzData(0, 0, 0, 0),
+        TimedXyzData(1, 0,-1, 0),
+        TimedXyzData(2, 0, 0, 2),
+        TimedXyzData(3,-3, 0, 0),
+        TimedXyzData(4, 0,-4, 5),
+        TimedXyzData(5,-7,-6, 0),
+        TimedXyzData(6,-9, 0, 8),
+        TimedXyzData(7,-1,-1, 1)
+    };
+
+    int numInputs = (sizeof(inputData) / sizeof(TimedXyzData));
+
+    Bin filterBin;
+    DummyAdaptor<TimedXyzData> dummyAdaptor;
+
+    FilterBase* coordAlignFilter = CoordinateAlignFilter::factoryMethod();
+
+    ((CoordinateAlignFilter*)coordAlignFilter)->setProperty("transMatrix", QVariant::fromValue(TMatrix(hconv)));
+
+    RingBuffer<TimedXyzData> outputBuffer(10);
+    filterBin.add(&dummyAdaptor, "adapter");
+    filterBin.add(coordAlignFilter, "coordfilter");
+    filterBin.add(&outputBuffer, "buffer");
+
+    filterBin.join("adapter", "source", "coordfilter", "sink");
+    filterBin.join("coordfilter", "source", "buffer", "sink");
+
+    DummyDataEmitter<TimedXyzData> dbusEmitter;
+    Bin marshallingBin;
+    marshallingBin.add(&dbusEmitter, "testdataemitter");
+    outputBuffer.join(&dbusEmitter);
+
+    dummyAdaptor.setTestData(numInputs, inputData);
+    dbusEmitter.setExpectedData(numInputs, expectedResult);
+
+    marshallingBin.start();
+    filterBin.start();
+
+    dummyAdaptor.pushAllData();
+
+    filterBin.stop();
+    marshallingBin.stop();
+
+    QCOMPARE (dummyAdaptor.getDataCount(), dbusEmitter.numSamplesReceived());
+
+    delete coordAlignFilter;
+}
+
 // TODO: Add some state changes to verify functionality of threshold setting.
 void FilterApiTest::testTopEdgeInterpretationFilter()
 {
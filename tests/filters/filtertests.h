@@ -46,6 +46,7 @@ private slots:
     void init() {}
 
     void testCoordinateAlignFilter();
+    void testCoordinateAlignFilterBatch();
     void testTopEdgeInterpretationFilter();
     void testFaceInterpretationFilter();
     void testDeclinationFilter();
@@ -90,6 +91,19 @@ public:
         ++counter_;
     }
 
+    void pushAllData() {
+        if (index_ >= datacount_) {
+            QVERIFY2(false, "Test function error: out of input data.");
+            return;
+        }
+
+        int count = datacount_ - index_;
+        source_.propagate(count, &(data_[index_]));
+
+        index_ += count;
+        counter_ += count;
+    }
+
     int getDataCount() { return counter_; }
 
 private:
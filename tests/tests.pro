@@ -2,6 +2,7 @@ CONFIG += ordered
 TEMPLATE = subdirs
 
 SUBDIRS = filters\
+          core \
           adaptors \
           chains \
           client \